@@ -0,0 +1,65 @@
+#!/bin/bash
+
+# Builds the uint256 benchmark contract (src/u256Bench.cpp) and, on a local chain, times every
+# case of include_common/u256_bench.hpp in wasm: generic intx form against the kernel, through
+# the elapsed time of the action. The x86-64 numbers come from antelope-tools u256bench.
+#
+# Timing needs a running nodeos + keosd reachable through cleos and a test account that can
+# take the contract code:
+#   BENCH_ACCOUNT=benchtest ./benchU256.sh
+#
+# BENCH_ITERATIONS sets the loop count of one action (keep it under the transaction CPU limit),
+# BENCH_CASES the cases to run.
+
+OUTPUT_DIR=${OUTPUT_DIR:-"./build/u256bench"}
+BENCH_ITERATIONS=${BENCH_ITERATIONS:-20000}
+BENCH_CASES=${BENCH_CASES:-"gas_margin to_native to_evm rlp_int abi_word"}
+CLEOS=${CLEOS:-cleos}
+
+echo ">>> Building the u256bench contract..."
+mkdir -p "$OUTPUT_DIR"
+
+cdt-cpp -O3 -I="./include_common/" -I="./external/" \
+  -o="$OUTPUT_DIR/u256bench.wasm" \
+  -contract=u256bench \
+  -abigen -abigen_output="$OUTPUT_DIR/u256bench.abi" \
+  ./src/u256Bench.cpp || exit 1
+
+echo ">>> Build complete: $OUTPUT_DIR/u256bench.wasm"
+
+if [ -z "$BENCH_ACCOUNT" ]; then
+  exit 0
+fi
+
+$CLEOS set contract "$BENCH_ACCOUNT" "$OUTPUT_DIR" u256bench.wasm u256bench.abi -p "$BENCH_ACCOUNT@active" > /dev/null || exit 1
+# let the setcode land in a block so the first timed action does not pay for instantiation
+sleep 1
+$CLEOS push action "$BENCH_ACCOUNT" verify '[]' -p "$BENCH_ACCOUNT@active" > /dev/null || exit 1
+
+REPORT="$OUTPUT_DIR/report.txt"
+: > "$REPORT"
+
+# Elapsed us of one bench action, the best of three (the first run of a case warms it up)
+bench_us() {
+  local BEST=""
+  for RUN in 1 2 3; do
+    local US=$($CLEOS push action "$BENCH_ACCOUNT" bench "[\"$1\", $2, $BENCH_ITERATIONS]" -p "$BENCH_ACCOUNT@active" --json -f | jq '.processed.elapsed')
+    if [ -z "$US" ] || [ "$US" == "null" ]; then
+      echo "Error: bench $1 failed" >&2
+      exit 1
+    fi
+    if [ -z "$BEST" ] || [ "$US" -lt "$BEST" ]; then BEST=$US; fi
+  done
+  echo "$BEST"
+}
+
+echo "==================== wasm, $BENCH_ITERATIONS iterations ====================" >> "$REPORT"
+printf "%-12s %12s %12s %12s\n" "case" "intx us" "kernel us" "speedup" >> "$REPORT"
+for CASE in $BENCH_CASES; do
+  GENERIC=$(bench_us "$CASE" false) || exit 1
+  FAST=$(bench_us "$CASE" true) || exit 1
+  printf "%-12s %12s %12s %11sx\n" "$CASE" "$GENERIC" "$FAST" "$(awk "BEGIN { printf \"%.1f\", $GENERIC / ($FAST > 0 ? $FAST : 1) }")" >> "$REPORT"
+done
+
+cat "$REPORT"
+echo ">>> Benchmark report written to $REPORT"
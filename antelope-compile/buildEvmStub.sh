@@ -0,0 +1,43 @@
+#!/bin/bash
+
+# Builds the stub eosio.evm (src/evmStub.cpp) for local chains: load tests (antelope-tools loadgen)
+# and evm.boid development without an EVM. Never deploy it on a public chain.
+
+# Path to JSON file
+CONFIG_FILE="./../config.toml"
+
+# Resolve and display the absolute path
+ABS_CONFIG_PATH=$(realpath "$CONFIG_FILE" 2>/dev/null || echo "Invalid path")
+
+# Check if the TOML file exists
+if [ ! -f "$CONFIG_FILE" ]; then
+  echo "Error: Config file $CONFIG_FILE not found!"
+  echo "Looking for the file at: $ABS_CONFIG_PATH"
+  exit 1
+else
+  echo "Config file found at: $ABS_CONFIG_PATH"
+fi
+
+# Extract from TOML using yq
+EVM_SYSTEM_CONTRACT=$(yq eval '.Native_contracts.EVM_SYSTEM_CONTRACT' "$CONFIG_FILE")
+
+# Check if EVM_SYSTEM_CONTRACT was extracted successfully
+if [ -z "$EVM_SYSTEM_CONTRACT" ] || [ "$EVM_SYSTEM_CONTRACT" == "null" ]; then
+  echo "Error: EVM_SYSTEM_CONTRACT not found or empty in $CONFIG_FILE!"
+  exit 1
+fi
+
+# Own directory, so the stub wasm never sits next to the contracts that get deployed
+OUTPUT_DIR=${OUTPUT_DIR:-"./build/evmstub"}
+
+echo ">>> Building the stub $EVM_SYSTEM_CONTRACT..."
+mkdir -p "$OUTPUT_DIR"
+
+cdt-cpp -I="./include_tokenBridge/" -I="./include_common/" -I="./external/" \
+  -D EVM_SYSTEM_CONTRACT="\"$EVM_SYSTEM_CONTRACT\"" \
+  -o="$OUTPUT_DIR/$EVM_SYSTEM_CONTRACT.wasm" \
+  -contract=$EVM_SYSTEM_CONTRACT \
+  -abigen -abigen_output="$OUTPUT_DIR/$EVM_SYSTEM_CONTRACT.abi" \
+  ./src/evmStub.cpp || exit 1
+
+echo ">>> Build complete: $OUTPUT_DIR/$EVM_SYSTEM_CONTRACT.wasm"
@@ -32,6 +32,7 @@ fi
 
 # Compile the contract with eosio-cpp
 cdt-cpp -I="./external/" \
+  -I="./include_common/" \
   -I="./include_feeForwarder/" \
   -o="./build/$FEES_CONTRACT_NAME.wasm" \
   -contract=$FEES_CONTRACT_NAME \
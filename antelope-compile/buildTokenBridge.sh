@@ -31,20 +31,81 @@ if [ -z "$EVM_SYSTEM_CONTRACT" ] || [ "$EVM_SYSTEM_CONTRACT" == "null" ]; then
   exit 1
 fi
 
-echo ">>> Building contract with BRIDGE_CONTRACT_NAME: $BRIDGE_CONTRACT_NAME and EVM_SYSTEM_CONTRACT: $EVM_SYSTEM_CONTRACT"
+# Optimization profile: BUILD_PROFILE=size (-Os) or speed (-O3), empty keeps the cdt-cpp default
+BUILD_PROFILE=${BUILD_PROFILE:-""}
+case "$BUILD_PROFILE" in
+  "") OPT_FLAGS="" ;;
+  size) OPT_FLAGS="-Os" ;;
+  speed) OPT_FLAGS="-O3" ;;
+  *) echo "Error: unknown BUILD_PROFILE '$BUILD_PROFILE' (use size or speed)"; exit 1 ;;
+esac
+
+# MEMORY_PROFILE=1 prints the memory pages and scratch arena peak of every action to the console
+if [ -n "$MEMORY_PROFILE" ]; then
+  OPT_FLAGS="$OPT_FLAGS -D BRIDGE_MEMORY_PROFILE"
+fi
+
+# Output directory, profileTokenBridge.sh builds every profile into its own directory
+OUTPUT_DIR=${OUTPUT_DIR:-"./build"}
+
+# STATIC_CONFIG=mainnet|testnet bakes the chain id, token symbol, token contract and fees contract
+# from config.toml into the wasm (generated bridge_static_config.hpp), init then only accepts
+# these values. Empty keeps reading them from the bridgeconfig singleton.
+STATIC_CONFIG=${STATIC_CONFIG:-""}
+case "$STATIC_CONFIG" in
+  "") ;;
+  mainnet) STATIC_CHAIN_ID=$(yq eval '.Mainnet.EVM_CHAIN_ID' "$CONFIG_FILE") ;;
+  testnet) STATIC_CHAIN_ID=$(yq eval '.Testnet.TESTNET_EVM_CHAIN_ID' "$CONFIG_FILE") ;;
+  *) echo "Error: unknown STATIC_CONFIG '$STATIC_CONFIG' (use mainnet or testnet)"; exit 1 ;;
+esac
+
+if [ -n "$STATIC_CONFIG" ]; then
+  TOKEN_SYMBOL=$(yq eval '.Native_contracts.TOKEN_SYMBOL' "$CONFIG_FILE")
+  TOKEN_CONTRACT_NAME=$(yq eval '.Native_contracts.TOKEN_CONTRACT_NAME' "$CONFIG_FILE")
+  FEES_CONTRACT_NAME=$(yq eval '.Native_contracts.FEES_CONTRACT_NAME' "$CONFIG_FILE")
+  for VALUE in STATIC_CHAIN_ID TOKEN_SYMBOL TOKEN_CONTRACT_NAME FEES_CONTRACT_NAME; do
+    if [ -z "${!VALUE}" ] || [ "${!VALUE}" == "null" ]; then
+      echo "Error: $VALUE not found or empty in $CONFIG_FILE (needed by STATIC_CONFIG=$STATIC_CONFIG)!"
+      exit 1
+    fi
+  done
+  # "4,BOID" -> precision 4, code BOID
+  TOKEN_PRECISION=${TOKEN_SYMBOL%%,*}
+  TOKEN_CODE=${TOKEN_SYMBOL#*,}
+
+  GENERATED_DIR="$OUTPUT_DIR/generated"
+  mkdir -p "$GENERATED_DIR"
+  cat > "$GENERATED_DIR/bridge_static_config.hpp" <<HEADER
+// Generated by buildTokenBridge.sh from $ABS_CONFIG_PATH (STATIC_CONFIG=$STATIC_CONFIG), do not edit
+#pragma once
+#include <eosio/name.hpp>
+#include <eosio/symbol.hpp>
+
+namespace evm_bridge
+{
+  static constexpr uint8_t STATIC_EVM_CHAIN_ID = $STATIC_CHAIN_ID;
+  static constexpr eosio::symbol STATIC_NATIVE_TOKEN_SYMBOL = eosio::symbol(eosio::symbol_code("$TOKEN_CODE"), $TOKEN_PRECISION);
+  static constexpr eosio::name STATIC_NATIVE_TOKEN_CONTRACT = eosio::name("$TOKEN_CONTRACT_NAME");
+  static constexpr eosio::name STATIC_FEES_CONTRACT = eosio::name("$FEES_CONTRACT_NAME");
+}
+HEADER
+  OPT_FLAGS="$OPT_FLAGS -D BRIDGE_STATIC_CONFIG -I=$GENERATED_DIR/"
+fi
+
+echo ">>> Building contract with BRIDGE_CONTRACT_NAME: $BRIDGE_CONTRACT_NAME and EVM_SYSTEM_CONTRACT: $EVM_SYSTEM_CONTRACT ${BUILD_PROFILE:+(profile: $BUILD_PROFILE)} ${MEMORY_PROFILE:+(memory profile)} ${STATIC_CONFIG:+(static config: $STATIC_CONFIG)}"
 
 # Create build directory if it doesn't exist
-if [ ! -d "$PWD/build" ]; then
-  mkdir -p build
+if [ ! -d "$OUTPUT_DIR" ]; then
+  mkdir -p "$OUTPUT_DIR"
 fi
 
 # Compile the contract with eosio-cpp
-cdt-cpp -I="./include_tokenBridge/" -I="./external/" \
+cdt-cpp $OPT_FLAGS -I="./include_tokenBridge/" -I="./include_common/" -I="./external/" \
   -D BRIDGE_CONTRACT_NAME="\"$BRIDGE_CONTRACT_NAME\"" \
   -D EVM_SYSTEM_CONTRACT="\"$EVM_SYSTEM_CONTRACT\"" \
-  -o="./build/$BRIDGE_CONTRACT_NAME.wasm" \
+  -o="$OUTPUT_DIR/$BRIDGE_CONTRACT_NAME.wasm" \
   -contract=$BRIDGE_CONTRACT_NAME \
-  -abigen -abigen_output="./build/$BRIDGE_CONTRACT_NAME.abi" \
-  ./src/tokenBridge.cpp
+  -abigen -abigen_output="$OUTPUT_DIR/$BRIDGE_CONTRACT_NAME.abi" \
+  ./src/tokenBridge.cpp || exit 1
 
 echo ">>> Build complete. BRIDGE_CONTRACT_NAME set to: $BRIDGE_CONTRACT_NAME and EVM_SYSTEM_CONTRACT set to: $EVM_SYSTEM_CONTRACT"
\ No newline at end of file
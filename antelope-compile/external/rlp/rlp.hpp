@@ -447,6 +447,100 @@ namespace rlp {
         }
     };
 
+    // Flat list encoder writing straight into a caller provided byte buffer (any vector-like
+    // container of uint8_t, e.g. an arena backed one). Produces the same bytes as encode() for
+    // a list of integers / byte strings, without building an RLPValue tree.
+    namespace flat {
+        // Big-endian bytes of n without leading zeroes, returns the length (0 for n == 0)
+        inline size_t be_bytes(uint64_t n, uint8_t* out)
+        {
+            if (n == 0) return 0;
+            const size_t len = 8 - intx::clz(n) / 8;
+            for (size_t i = 0; i < len; ++i) out[i] = static_cast<uint8_t>(n >> (8 * (len - 1 - i)));
+            return len;
+        }
+
+        inline size_t be_bytes(const uint256_t& n, uint8_t* out)
+        {
+            // Gas prices and values are 64 bit in practice, skip the 256 bit store and byte count
+            if ((n.lo.hi | n.hi.lo | n.hi.hi) == 0) return be_bytes(n.lo.lo, out);
+            uint8_t arr[32];
+            intx::be::store(arr, n);
+            const size_t len = intx::count_significant_words<uint8_t>(n);
+            std::memcpy(out, arr + 32 - len, len);
+            return len;
+        }
+
+        inline size_t length_of_length(size_t n)
+        {
+            size_t len = 0;
+            while (n) { len++; n >>= 8; }
+            return len;
+        }
+
+        inline size_t string_size(const uint8_t* data, size_t len)
+        {
+            if (len == 1 && data[0] < 0x80) return 1;
+            return len < 56 ? 1 + len : 1 + length_of_length(len) + len;
+        }
+
+        inline uint8_t* write_length(uint8_t* out, size_t len, uint8_t offset)
+        {
+            if (len < 56) {
+                *out++ = static_cast<uint8_t>(offset + len);
+                return out;
+            }
+            const size_t lol = length_of_length(len);
+            *out++ = static_cast<uint8_t>(offset + 55 + lol);
+            for (size_t i = lol; i > 0; --i) *out++ = static_cast<uint8_t>(len >> ((i - 1) * 8));
+            return out;
+        }
+
+        inline uint8_t* write_string(uint8_t* out, const uint8_t* data, size_t len)
+        {
+            if (len == 1 && data[0] < 0x80) {
+                *out++ = data[0];
+                return out;
+            }
+            out = write_length(out, len, RLP_bufferLenStart);
+            if (len) std::memcpy(out, data, len);
+            return out + len;
+        }
+
+        // Item adapters: integers are encoded without leading zeroes, byte containers as is
+        struct item {
+            const uint8_t* data;
+            size_t size;
+            uint8_t scratch[32];
+
+            template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+            item(T n) : data(scratch), size(be_bytes(static_cast<uint64_t>(n), scratch)) {}
+            item(const uint256_t& n) : data(scratch), size(be_bytes(n, scratch)) {}
+            template <typename A>
+            item(const std::vector<uint8_t, A>& v) : data(v.data()), size(v.size()) {}
+            template <size_t N>
+            item(const std::array<uint8_t, N>& a) : data(a.data()), size(N) {}
+            item(const std::string& s) : data(reinterpret_cast<const uint8_t*>(s.data())), size(s.size()) {}
+
+            item(const item&) = delete;
+        };
+    }
+
+    template <typename Buffer, typename ... Args>
+    static void encode_to(Buffer& out, const Args& ... args)
+    {
+        const flat::item items[] = { flat::item(args)... };
+
+        size_t payload = 0;
+        for (const auto& it : items) payload += flat::string_size(it.data, it.size);
+        const size_t header = payload < 56 ? 1 : 1 + flat::length_of_length(payload);
+
+        const size_t start = out.size();
+        out.resize(start + header + payload);
+        uint8_t* pos = flat::write_length(out.data() + start, payload, RLP_listStart);
+        for (const auto& it : items) pos = flat::write_string(pos, it.data, it.size);
+    }
+
     template <typename ... Args>
     static std::string encode(Args&& ... args){
         RLPValue rlp;
@@ -0,0 +1,173 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <keccak256/k.h>
+
+// Storage layout of TokenBridge.sol as seen through eosio.evm's accountstate table.
+// Only depends on the standard library and keccak so it can be shared between the
+// contracts and the host tools in antelope-tools/.
+namespace evm_bridge
+{
+  using storage_word = std::array<uint8_t, 32>;
+
+  // Slot of the `requests` mapping in TokenBridge.sol
+  static constexpr uint64_t REQUESTS_MAPPING_SLOT = 9;
+  // uint[] activeRequestIds (length in the slot, elements from keccak(slot)) and its reverse mapping id -> index
+  static constexpr uint64_t ACTIVE_REQUEST_IDS_SLOT = 10;
+  static constexpr uint64_t ACTIVE_REQUEST_INDEX_SLOT = 11;
+  // uint request_id, the id the next request will get (ids start at 1)
+  static constexpr uint64_t NEXT_REQUEST_ID_SLOT = 12;
+
+  // Offsets of the Request struct members relative to the mapping key of a request
+  enum request_slot : uint8_t {
+    REQUEST_SLOT_ID             = 0,
+    REQUEST_SLOT_SENDER         = 1,
+    REQUEST_SLOT_AMOUNT         = 2,
+    REQUEST_SLOT_REQUESTED_AT   = 3,
+    REQUEST_SLOT_TOKEN_CONTRACT = 4,
+    REQUEST_SLOT_TOKEN_SYMBOL   = 5,
+    REQUEST_SLOT_RECEIVER       = 6,
+    REQUEST_SLOT_PACKED         = 7,
+    REQUEST_SLOT_MEMO           = 8,
+    REQUEST_SLOT_COUNT          = 9
+  };
+
+  // Offsets of the v2 Request struct (4 slots), see the Request struct in TokenBridge.sol:
+  //  head:   requested_at (uint32) | id (uint64) | sender (address), sender in the lowest bytes
+  //  amount: status (uint8) | amount in native units (uint64)
+  //  receiver and memo are left-aligned bytes32 as in v1
+  // The token contract and symbol are only kept in the contract config (slots 6 and 8).
+  enum request_v2_slot : uint8_t {
+    REQUEST_V2_SLOT_HEAD     = 0,
+    REQUEST_V2_SLOT_AMOUNT   = 1,
+    REQUEST_V2_SLOT_RECEIVER = 2,
+    REQUEST_V2_SLOT_MEMO     = 3,
+    REQUEST_V2_SLOT_COUNT    = 4
+  };
+
+  // Which Request struct the deployed TokenBridge.sol stores
+  enum request_layout : uint8_t {
+    REQUEST_LAYOUT_V1 = 1,
+    REQUEST_LAYOUT_V2 = 2
+  };
+
+  // RequestStatus enum of TokenBridge.sol
+  enum request_status : uint8_t {
+    REQUEST_STATUS_PENDING   = 0,
+    REQUEST_STATUS_COMPLETED = 1,
+    REQUEST_STATUS_FAILED    = 2,
+    REQUEST_STATUS_REFUNDED  = 3
+  };
+
+  // Big-endian 32 byte word holding a 64 bit value (storage key of a plain slot)
+  inline storage_word slotKey(uint64_t slot) {
+    storage_word word = {};
+    for (uint8_t i = 0; i < 8; i++) {
+        word[31 - i] = static_cast<uint8_t>((slot >> (i * 8)) & 0xFF);
+    }
+    return word;
+  }
+
+  inline storage_word keccakWord(const uint8_t* data, size_t size) {
+    storage_word hash;
+    SHA3_CTX context;
+    keccak_init(&context);
+    keccak_update(&context, data, size);
+    keccak_final(&context, hash.data());
+    return hash;
+  }
+
+  // keccak256(pad32(key) . pad32(base_slot)), the storage key of mapping[key]
+  inline storage_word mappingKey(uint64_t key, uint64_t base_slot) {
+    std::array<uint8_t, 64> buf = {};
+    storage_word key_word = slotKey(key);
+    storage_word slot_word = slotKey(base_slot);
+    std::memcpy(buf.data(), key_word.data(), 32);
+    std::memcpy(buf.data() + 32, slot_word.data(), 32);
+    return keccakWord(buf.data(), buf.size());
+  }
+
+  // Adds an offset to a big-endian storage key (struct member of a mapping entry, array element)
+  inline storage_word addToKey(storage_word key, uint64_t offset) {
+    uint64_t carry = offset;
+    for (int i = 31; i >= 0 && carry != 0; --i) {
+        uint16_t sum = static_cast<uint16_t>(key[i]) + (carry & 0xFF);
+        key[i] = static_cast<uint8_t>(sum & 0xFF);
+        carry = (carry >> 8) + (sum >> 8);
+    }
+    return key;
+  }
+
+  // keccak256(pad32(slot)), storage key of the first element of a dynamic array
+  inline storage_word arrayBaseKey(uint64_t slot) {
+    storage_word slot_word = slotKey(slot);
+    return keccakWord(slot_word.data(), slot_word.size());
+  }
+
+  inline storage_word arrayElementKey(uint64_t slot, uint64_t index) {
+    return addToKey(arrayBaseKey(slot), index);
+  }
+
+  inline storage_word requestSlotKey(uint64_t req_id, request_slot slot) {
+    return addToKey(mappingKey(req_id, REQUESTS_MAPPING_SLOT), slot);
+  }
+
+  // Lowest 8 bytes of a big-endian word
+  inline uint64_t wordToUint64(const storage_word& word) {
+    uint64_t value = 0;
+    for (uint8_t i = 24; i < 32; i++) {
+        value = (value << 8) | word[i];
+    }
+    return value;
+  }
+
+  // Left-aligned ASCII stored in a bytes32 slot (stops at the first zero byte)
+  inline std::string wordToString(const storage_word& word) {
+    std::string result;
+    for (uint8_t b : word) {
+        if (b == 0) break;
+        result.push_back(static_cast<char>(b));
+    }
+    return result;
+  }
+
+  // Packed slot: uint8 evm_decimals in the lowest byte, RequestStatus in the next one
+  inline uint8_t packedDecimals(const storage_word& packed) { return packed[31]; }
+  inline uint8_t packedStatus(const storage_word& packed) { return packed[30]; }
+
+  // Big-endian integer of `len` bytes ending `low` bytes above the lowest byte of the word.
+  // Solidity packs struct members from the lowest byte up, in declaration order.
+  inline uint64_t wordField(const storage_word& word, uint8_t low, uint8_t len) {
+    uint64_t value = 0;
+    for (uint8_t i = 32 - low - len; i < 32 - low; i++) {
+        value = (value << 8) | word[i];
+    }
+    return value;
+  }
+
+  // v2 head slot
+  inline std::array<uint8_t, 20> headSender(const storage_word& head) {
+    std::array<uint8_t, 20> sender;
+    std::memcpy(sender.data(), head.data() + 12, 20);
+    return sender;
+  }
+  inline uint64_t headId(const storage_word& head) { return wordField(head, 20, 8); }
+  inline uint32_t headRequestedAt(const storage_word& head) { return static_cast<uint32_t>(wordField(head, 28, 4)); }
+
+  // v2 amount slot
+  inline uint64_t amountSlotAmount(const storage_word& word) { return wordField(word, 0, 8); }
+  inline uint8_t amountSlotStatus(const storage_word& word) { return static_cast<uint8_t>(wordField(word, 8, 1)); }
+
+  // Storage key and status byte holding the RequestStatus of a request in the given layout
+  inline storage_word requestStatusKey(uint64_t req_id, request_layout layout) {
+    return addToKey(mappingKey(req_id, REQUESTS_MAPPING_SLOT),
+                    layout == REQUEST_LAYOUT_V2 ? uint8_t(REQUEST_V2_SLOT_AMOUNT) : uint8_t(REQUEST_SLOT_PACKED));
+  }
+  inline uint8_t requestStatus(const storage_word& word, request_layout layout) {
+    return layout == REQUEST_LAYOUT_V2 ? amountSlotStatus(word) : packedStatus(word);
+  }
+}
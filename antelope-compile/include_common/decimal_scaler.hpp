@@ -0,0 +1,88 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <u256_kernels.hpp>
+
+using namespace evm_bridge;
+
+namespace evm_bridge
+{
+  // 10^0 .. 10^19, every power of ten that fits in an uint64_t
+  static constexpr uint8_t MAX_SCALE_EXPONENT = 19;
+
+  struct pow10_table {
+    uint64_t values[MAX_SCALE_EXPONENT + 1] = {};
+    constexpr pow10_table() {
+      uint64_t v = 1;
+      for (uint8_t i = 0; i <= MAX_SCALE_EXPONENT; i++) {
+        values[i] = v;
+        v *= 10;
+      }
+    }
+  };
+  static constexpr pow10_table POW10 = pow10_table();
+
+  // Largest amount an eosio::asset can hold (2^62 - 1)
+  static constexpr uint64_t MAX_NATIVE_AMOUNT = (1ULL << 62) - 1;
+
+  // evm_amount / factor when it divides exactly and fits in an asset. The product of a native
+  // amount and a factor is at most 128 bits, both steps run on 64 bit words (u256_kernels.hpp).
+  inline bool to_native_units(const uint256_t& evm_amount, const u64_divisor& factor, uint64_t& native_amount) {
+    uint64_t rem;
+    const uint256_t quot = divremSmall(evm_amount, factor, rem);
+    if (rem != 0 || !fitsUint64(quot) || quot.lo.lo > MAX_NATIVE_AMOUNT) return false;
+    native_amount = quot.lo.lo;
+    return true;
+  }
+
+  // Exact native <-> EVM amount conversion, no floating point involved:
+  //  native -> EVM multiplies by 10^(EvmDecimals - NativePrecision)
+  //  EVM -> native only succeeds if no EVM digit is lost and the result fits in an asset
+  template<uint8_t NativePrecision, uint8_t EvmDecimals>
+  struct decimal_scaler {
+    static_assert(EvmDecimals >= NativePrecision, "EVM token needs at least the native precision");
+    static_assert(EvmDecimals - NativePrecision <= MAX_SCALE_EXPONENT, "Scale factor does not fit in 64 bits");
+
+    static constexpr uint64_t factor = POW10.values[EvmDecimals - NativePrecision];
+
+    static uint256_t to_evm(uint64_t native_amount) {
+      return uint256_t(intx::umul(native_amount, factor));
+    }
+
+    static bool to_native(const uint256_t& evm_amount, uint64_t& native_amount) {
+      static const u64_divisor divisor(factor);
+      return to_native_units(evm_amount, divisor, native_amount);
+    }
+  };
+
+  // Same conversions when the precision is only known at runtime
+  // (native_token_symbol.precision() and the evm_decimals byte of a request)
+  class runtime_decimal_scaler {
+    public:
+      runtime_decimal_scaler(uint8_t native_precision, uint8_t evm_decimals) {
+        eosio::check(evm_decimals >= native_precision,
+          "EVM decimals (" + std::to_string(evm_decimals) + ") lower than the native precision (" +
+          std::to_string(native_precision) + ")");
+        eosio::check(evm_decimals - native_precision <= MAX_SCALE_EXPONENT,
+          "Decimal difference between EVM and native token is too large");
+        _factor = POW10.values[evm_decimals - native_precision];
+        _divisor = u64_divisor(_factor);
+      }
+
+      uint64_t factor() const { return _factor; }
+
+      uint256_t to_evm(uint64_t native_amount) const {
+        return uint256_t(intx::umul(native_amount, _factor));
+      }
+
+      bool to_native(const uint256_t& evm_amount, uint64_t& native_amount) const {
+        return to_native_units(evm_amount, _divisor, native_amount);
+      }
+
+    private:
+      uint64_t _factor;
+      u64_divisor _divisor = u64_divisor(1);
+  };
+}
@@ -0,0 +1,59 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <keccak256/k.h>
+#include <hex_codec.hpp>
+
+// EIP-55 mixed case checksum addresses.
+// The checksum is keccak256 over the 40 lowercase hex characters: a letter is upper case when
+// the matching nibble of the hash is >= 8. All lower / all upper case addresses carry no checksum.
+namespace evm_bridge
+{
+  inline std::array<uint8_t, 32> eip55Hash(const char* lower_hex40) {
+    std::array<uint8_t, 32> hash;
+    SHA3_CTX context;
+    keccak_init(&context);
+    keccak_update(&context, reinterpret_cast<const unsigned char*>(lower_hex40), 40);
+    keccak_final(&context, hash.data());
+    return hash;
+  }
+
+  // Writes the 40 checksummed hex characters of address to out (no "0x")
+  inline void encodeChecksumAddress(const evm_address_bytes& address, char* out) {
+    encodeHex(address.data(), address.size(), out);
+    const auto hash = eip55Hash(out);
+    for (size_t i = 0; i < 40; i++) {
+      uint8_t nibble = (i & 1) ? (hash[i / 2] & 0x0f) : (hash[i / 2] >> 4);
+      if (out[i] >= 'a' && nibble >= 8) out[i] = static_cast<char>(out[i] - 'a' + 'A');
+    }
+  }
+
+  inline std::string toChecksumAddress(const evm_address_bytes& address) {
+    std::string res(EVM_ADDRESS_HEX_LENGTH, '\0');
+    res[0] = '0';
+    res[1] = 'x';
+    encodeChecksumAddress(address, &res[2]);
+    return res;
+  }
+
+  // parseEvmAddress + checksum verification of mixed case input
+  inline address_status parseChecksummedAddress(const char* in, size_t len, evm_address_bytes& out) {
+    bool mixed_case = false;
+    address_status status = parseEvmAddress(in, len, out, mixed_case);
+    if (status != ADDRESS_OK || !mixed_case) return status;
+
+    char expected[40];
+    encodeChecksumAddress(out, expected);
+    for (size_t i = 0; i < 40; i++) {
+      if (expected[i] != in[2 + i]) return ADDRESS_BAD_CHECKSUM;
+    }
+    return ADDRESS_OK;
+  }
+
+  inline address_status parseChecksummedAddress(const std::string& in, evm_address_bytes& out) {
+    return parseChecksummedAddress(in.data(), in.size(), out);
+  }
+}
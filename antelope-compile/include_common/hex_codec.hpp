@@ -0,0 +1,120 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Hex encoding / decoding and EVM address parsing shared by both contracts and the host tools.
+// Decoding is a single pass over the input with a 256 entry lookup table and writes straight
+// into the caller's buffer, nothing is allocated.
+namespace evm_bridge
+{
+  using evm_address_bytes = std::array<uint8_t, 20>;
+
+  // Length of a "0x" prefixed EVM address
+  static constexpr size_t EVM_ADDRESS_HEX_LENGTH = 42;
+
+  // Any value with a high nibble set is not a hex digit
+  static constexpr uint8_t HEX_INVALID = 0xFF;
+
+  struct hex_decode_table {
+    uint8_t values[256] = {};
+    constexpr hex_decode_table() {
+      for (int c = 0; c < 256; c++) values[c] = HEX_INVALID;
+      for (int c = '0'; c <= '9'; c++) values[c] = static_cast<uint8_t>(c - '0');
+      for (int c = 'a'; c <= 'f'; c++) values[c] = static_cast<uint8_t>(c - 'a' + 10);
+      for (int c = 'A'; c <= 'F'; c++) values[c] = static_cast<uint8_t>(c - 'A' + 10);
+    }
+  };
+  static constexpr hex_decode_table HEX_DECODE = hex_decode_table();
+
+  // Two output characters per byte value, one table read per input byte
+  struct hex_encode_table {
+    char pairs[256][2] = {};
+    constexpr hex_encode_table() {
+      const char digits[] = "0123456789abcdef";
+      for (int b = 0; b < 256; b++) {
+        pairs[b][0] = digits[b >> 4];
+        pairs[b][1] = digits[b & 0xf];
+      }
+    }
+  };
+  static constexpr hex_encode_table HEX_ENCODE = hex_encode_table();
+
+  // Decodes 2 * len hex characters into len bytes, false on the first invalid character
+  inline bool decodeHex(const char* in, size_t len, uint8_t* out) {
+    for (size_t i = 0; i < len; i++) {
+      uint8_t hi = HEX_DECODE.values[static_cast<uint8_t>(in[2 * i])];
+      uint8_t lo = HEX_DECODE.values[static_cast<uint8_t>(in[2 * i + 1])];
+      if ((hi | lo) & 0xF0) return false;
+      out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+  }
+
+  // Writes 2 * len lowercase hex characters to out
+  inline void encodeHex(const uint8_t* in, size_t len, char* out) {
+    for (size_t i = 0; i < len; i++) {
+      out[2 * i] = HEX_ENCODE.pairs[in[i]][0];
+      out[2 * i + 1] = HEX_ENCODE.pairs[in[i]][1];
+    }
+  }
+
+  inline std::string toHex(const uint8_t* in, size_t len) {
+    std::string res(2 * len, '\0');
+    encodeHex(in, len, &res[0]);
+    return res;
+  }
+
+  template<typename T, size_t N>
+  inline std::string toHex(const std::array<T, N>& bin) {
+    static_assert(sizeof(T) == 1, "toHex expects a byte array");
+    return toHex(reinterpret_cast<const uint8_t*>(bin.data()), N);
+  }
+
+  enum address_status : uint8_t {
+    ADDRESS_OK             = 0,
+    ADDRESS_BAD_LENGTH     = 1,
+    ADDRESS_BAD_PREFIX     = 2,
+    ADDRESS_BAD_HEX        = 3,
+    ADDRESS_BAD_CHECKSUM   = 4
+  };
+
+  inline const char* addressStatusMessage(address_status status) {
+    switch (status) {
+      case ADDRESS_OK:           return "valid EVM address";
+      case ADDRESS_BAD_LENGTH:   return "EVM address must be 42 characters including '0x'";
+      case ADDRESS_BAD_PREFIX:   return "EVM address must start with '0x'";
+      case ADDRESS_BAD_HEX:      return "EVM address contains a non hexadecimal character";
+      case ADDRESS_BAD_CHECKSUM: return "EVM address does not match its EIP-55 checksum";
+    }
+    return "invalid EVM address";
+  }
+
+  // Validates and decodes a "0x" prefixed address in one pass.
+  // mixed_case is set when the address has both upper and lower case letters, which per
+  // EIP-55 means it carries a checksum the caller should verify (see eip55.hpp).
+  inline address_status parseEvmAddress(const char* in, size_t len, evm_address_bytes& out, bool& mixed_case) {
+    if (len != EVM_ADDRESS_HEX_LENGTH) return ADDRESS_BAD_LENGTH;
+    if (in[0] != '0' || in[1] != 'x') return ADDRESS_BAD_PREFIX;
+
+    bool has_lower = false, has_upper = false;
+    for (size_t i = 0; i < out.size(); i++) {
+      char c_hi = in[2 + 2 * i], c_lo = in[3 + 2 * i];
+      uint8_t hi = HEX_DECODE.values[static_cast<uint8_t>(c_hi)];
+      uint8_t lo = HEX_DECODE.values[static_cast<uint8_t>(c_lo)];
+      if ((hi | lo) & 0xF0) return ADDRESS_BAD_HEX;
+      has_lower |= (c_hi >= 'a') | (c_lo >= 'a');
+      has_upper |= (c_hi >= 'A' && c_hi <= 'F') | (c_lo >= 'A' && c_lo <= 'F');
+      out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    mixed_case = has_lower && has_upper;
+    return ADDRESS_OK;
+  }
+
+  inline address_status parseEvmAddress(const std::string& in, evm_address_bytes& out, bool& mixed_case) {
+    return parseEvmAddress(in.data(), in.size(), out, mixed_case);
+  }
+}
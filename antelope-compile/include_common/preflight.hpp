@@ -0,0 +1,135 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <eip55.hpp>
+
+// Pre-flight checks of the bridge actions: the validation evm.boid (reqnotify, verifytrx) and
+// xsend.boid (its transfer handlers) run before they change anything, as plain functions over
+// the values they read. The contracts fail with preflightMessage() of the first failing check,
+// relayers and clients run the same functions against their state mirror (antelope-tools) and
+// only submit actions that go through. The evm.boid request checks are in request_preflight.hpp.
+namespace evm_bridge
+{
+  enum preflight_status : uint8_t {
+    PREFLIGHT_OK = 0,
+
+    // reqnotify
+    PREFLIGHT_ALREADY_NOTIFIED,     // evm.boid already has a row for the request
+    PREFLIGHT_ALREADY_SETTLED,      // the request id is set in settledids
+    PREFLIGHT_REQUEST_MISSING,      // a slot of the Request is not set in the TokenBridge.sol storage
+    PREFLIGHT_NOT_PENDING,          // RequestStatus is not Pending
+    PREFLIGHT_ID_MISMATCH,          // the stored id is not the requested one
+    PREFLIGHT_TOKEN_MISMATCH,       // v1 Request for another antelope token contract
+    PREFLIGHT_BAD_DECIMALS,         // EVM decimals below the native precision or more than 10^19 above
+    PREFLIGHT_PRECISION_LOSS,       // EVM amount is not a whole number of native units that fits an asset
+    PREFLIGHT_INVALID_AMOUNT,       // v2 amount of 0 or above the asset maximum
+    PREFLIGHT_RECEIVER_TOO_LONG,    // receiver longer than 12 characters
+    PREFLIGHT_RECEIVER_INVALID,     // receiver is empty or not made of account name characters
+
+    // verifytrx / finalize
+    PREFLIGHT_NOT_NOTIFIED,         // no evm.boid row, reqnotify did not run
+    PREFLIGHT_ALREADY_PROCESSED,    // row of an older build marked processed
+    PREFLIGHT_STILL_ON_EVM,         // the success callback has not removed the Request yet
+
+    // xsend.boid transfers
+    PREFLIGHT_NO_GLOBAL_CONFIG,
+    PREFLIGHT_BELOW_MINIMUM,
+    PREFLIGHT_BAD_MEMO,
+    PREFLIGHT_WRONG_TOKEN_CONTRACT,
+    PREFLIGHT_WRONG_TOKEN_SYMBOL,
+    PREFLIGHT_NO_FEE,
+    PREFLIGHT_FEE_MISMATCH,
+    PREFLIGHT_FEE_RECORDED,
+    PREFLIGHT_WRONG_FEE_CONTRACT,
+    PREFLIGHT_WRONG_FEE_SYMBOL,
+    PREFLIGHT_WRONG_FEE_AMOUNT
+  };
+
+  inline const char* preflightMessage(preflight_status status) {
+    switch (status) {
+      case PREFLIGHT_OK:                   return "ok";
+      case PREFLIGHT_ALREADY_NOTIFIED:     return "Request already exists";
+      case PREFLIGHT_ALREADY_SETTLED:      return "Request was already settled";
+      case PREFLIGHT_REQUEST_MISSING:      return "Missing storage key";
+      case PREFLIGHT_NOT_PENDING:          return "Request status must be Pending (0) to process";
+      case PREFLIGHT_ID_MISMATCH:          return "Request ID does not match the requested id";
+      case PREFLIGHT_TOKEN_MISMATCH:       return "Mismatch in antelope token contract";
+      case PREFLIGHT_BAD_DECIMALS:         return "EVM decimals do not scale to the native precision";
+      case PREFLIGHT_PRECISION_LOSS:       return "Precision loss detected";
+      case PREFLIGHT_INVALID_AMOUNT:       return "Invalid request amount";
+      case PREFLIGHT_RECEIVER_TOO_LONG:    return "Receiver name too long";
+      case PREFLIGHT_RECEIVER_INVALID:     return "Receiver is not a valid account name";
+      case PREFLIGHT_NOT_NOTIFIED:         return "Request not found";
+      case PREFLIGHT_ALREADY_PROCESSED:    return "Request already processed";
+      case PREFLIGHT_STILL_ON_EVM:         return "Request still exists in EVM storage";
+      case PREFLIGHT_NO_GLOBAL_CONFIG:     return "Global config is not set. Admin must call setglobal first.";
+      case PREFLIGHT_BELOW_MINIMUM:        return "Amount is below the minimum required for bridging";
+      case PREFLIGHT_BAD_MEMO:             return "Memo must be a valid EVM address";
+      case PREFLIGHT_WRONG_TOKEN_CONTRACT: return "Invalid token contract for this bridging token";
+      case PREFLIGHT_WRONG_TOKEN_SYMBOL:   return "Mismatched token symbol for bridging token";
+      case PREFLIGHT_NO_FEE:               return "No valid fee record found. Ensure you send the required fee before bridging.";
+      case PREFLIGHT_FEE_MISMATCH:         return "Fee record doesn't match the required bridging fee.";
+      case PREFLIGHT_FEE_RECORDED:         return "A fee is already recorded for this user. Use or claim the existing fee first.";
+      case PREFLIGHT_WRONG_FEE_CONTRACT:   return "Invalid fee token contract.";
+      case PREFLIGHT_WRONG_FEE_SYMBOL:     return "Incorrect fee token symbol.";
+      case PREFLIGHT_WRONG_FEE_AMOUNT:     return "Fee amount is incorrect or overpayment not allowed.";
+    }
+    return "unknown pre-flight status";
+  }
+
+  //======================== xsend.boid transfers ========================
+  // Names and symbols as their raw uint64 values, amounts in the token's units
+  struct transfer_view {
+    uint64_t token_contract;        // first receiver of the transfer notification
+    int64_t amount;
+    uint64_t symbol;
+  };
+
+  // global row
+  struct fee_global_view {
+    int64_t fee_amount;
+    uint64_t fee_symbol;
+    uint64_t fee_token_contract;
+  };
+
+  // tokens row of a bridging token
+  struct bridge_token_view {
+    uint64_t token_contract;
+    uint64_t token_symbol;
+    int64_t min_amount;
+  };
+
+  // fees row of the sender
+  struct fee_paid_view {
+    int64_t amount;
+    uint64_t symbol;
+  };
+
+  // A bridging token sent to xsend.boid, forwarded to evm.boid if the sender paid the fee.
+  // global / fee are null when the row does not exist.
+  inline preflight_status preflightBridgeTransfer(const transfer_view& transfer, const std::string& memo,
+                                                  const bridge_token_view& token, const fee_global_view* global,
+                                                  const fee_paid_view* fee) {
+    if (!global) return PREFLIGHT_NO_GLOBAL_CONFIG;
+    if (transfer.amount < token.min_amount) return PREFLIGHT_BELOW_MINIMUM;
+    evm_address_bytes address;
+    if (parseChecksummedAddress(memo, address) != ADDRESS_OK) return PREFLIGHT_BAD_MEMO;
+    if (transfer.token_contract != token.token_contract) return PREFLIGHT_WRONG_TOKEN_CONTRACT;
+    if (transfer.symbol != token.token_symbol) return PREFLIGHT_WRONG_TOKEN_SYMBOL;
+    if (!fee) return PREFLIGHT_NO_FEE;
+    if (fee->amount != global->fee_amount || fee->symbol != global->fee_symbol) return PREFLIGHT_FEE_MISMATCH;
+    return PREFLIGHT_OK;
+  }
+
+  // Any other token sent to xsend.boid, recorded as the sender's fee if it is exactly the fee
+  inline preflight_status preflightFeeTransfer(const transfer_view& transfer, const fee_global_view* global, bool fee_recorded) {
+    if (fee_recorded) return PREFLIGHT_FEE_RECORDED;
+    if (!global) return PREFLIGHT_NO_GLOBAL_CONFIG;
+    if (transfer.token_contract != global->fee_token_contract) return PREFLIGHT_WRONG_FEE_CONTRACT;
+    if (transfer.symbol != global->fee_symbol) return PREFLIGHT_WRONG_FEE_SYMBOL;
+    if (transfer.amount != global->fee_amount) return PREFLIGHT_WRONG_FEE_AMOUNT;
+    return PREFLIGHT_OK;
+  }
+}
@@ -0,0 +1,160 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <bridge_storage.hpp>
+#include <decimal_scaler.hpp>
+#include <preflight.hpp>
+
+// Pre-flight checks of evm.boid's reqnotify and verifytrx / finalize (see preflight.hpp).
+//
+// The TokenBridge.sol storage is read through a Storage type with two members, implemented by
+// evm.boid over eosio.evm's accountstate and by the host tools over their mirror:
+//   bool load(const storage_word& key, storage_word& value) const  // false if the slot is not set
+//   bool contains(const storage_word& key) const
+// The evm.boid side (is there a requests row, is the id in settledids) is passed in, it costs
+// no storage read and is checked first.
+namespace evm_bridge
+{
+  struct request_preflight_config {
+    request_layout layout = REQUEST_LAYOUT_V1;
+    std::string token_contract;     // native token contract, v1 Requests carry it
+    uint8_t native_precision = 0;
+  };
+
+  // A pending Request as reqnotify records it, plus what the failed check saw
+  struct preflight_request {
+    uint64_t id = 0;
+    std::array<uint8_t, 20> sender = {};
+    uint64_t amount = 0;            // native units
+    uint64_t requested_at = 0;      // unix seconds
+    std::string receiver;           // lower case, the native account name once the checks pass
+    std::string memo;
+
+    uint8_t missing_slot = 0;       // PREFLIGHT_REQUEST_MISSING
+    uint8_t status = 0;             // RequestStatus
+    uint8_t evm_decimals = 0;       // v1
+    storage_word stored_id = {};    // v1 id slot, v2 head slot
+    storage_word raw_amount = {};   // amount slot as stored
+  };
+
+  // Name of a Request slot for error messages
+  inline const char* requestSlotName(request_layout layout, uint8_t slot) {
+    static const char* const v1[REQUEST_SLOT_COUNT] = {
+      "request_id", "sender", "amount", "requested_at", "token_contract", "token_symbol", "receiver", "packed", "memo"};
+    static const char* const v2[REQUEST_V2_SLOT_COUNT] = {"head", "amount", "receiver", "memo"};
+    if (layout == REQUEST_LAYOUT_V2) return slot < REQUEST_V2_SLOT_COUNT ? v2[slot] : "?";
+    return slot < REQUEST_SLOT_COUNT ? v1[slot] : "?";
+  }
+
+  inline std::string lowerAscii(std::string s) {
+    for (char& c : s) {
+      if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return s;
+  }
+
+  // Left-aligned bytes32 receiver -> lower case account name (characters a-z, 1-5 and '.')
+  inline preflight_status decodeReceiverName(const storage_word& word, std::string& receiver) {
+    receiver = lowerAscii(wordToString(word));
+    if (receiver.size() > 12) return PREFLIGHT_RECEIVER_TOO_LONG;
+    if (receiver.empty()) return PREFLIGHT_RECEIVER_INVALID;
+    for (char c : receiver) {
+      if (!((c >= 'a' && c <= 'z') || (c >= '1' && c <= '5') || c == '.')) return PREFLIGHT_RECEIVER_INVALID;
+    }
+    return PREFLIGHT_OK;
+  }
+
+  // v1 layout: REQUEST_SLOT_COUNT (9) slots, every one of them must be set
+  template<typename Storage>
+  preflight_status readPendingRequestV1(const Storage& storage, uint64_t req_id, const request_preflight_config& config,
+                                        preflight_request& req) {
+    const storage_word base = mappingKey(req_id, REQUESTS_MAPPING_SLOT);
+    storage_word words[REQUEST_SLOT_COUNT];
+    for (uint8_t slot = 0; slot < REQUEST_SLOT_COUNT; ++slot) {
+      if (!storage.load(addToKey(base, slot), words[slot])) {
+        req.missing_slot = slot;
+        return PREFLIGHT_REQUEST_MISSING;
+      }
+    }
+
+    req.status = packedStatus(words[REQUEST_SLOT_PACKED]);
+    req.evm_decimals = packedDecimals(words[REQUEST_SLOT_PACKED]);
+    req.stored_id = words[REQUEST_SLOT_ID];
+    req.raw_amount = words[REQUEST_SLOT_AMOUNT];
+    if (req.status != REQUEST_STATUS_PENDING) return PREFLIGHT_NOT_PENDING;
+    if (lowerAscii(wordToString(words[REQUEST_SLOT_TOKEN_CONTRACT])) != lowerAscii(config.token_contract)) return PREFLIGHT_TOKEN_MISMATCH;
+    if (words[REQUEST_SLOT_ID] != slotKey(req_id)) return PREFLIGHT_ID_MISMATCH;
+
+    // Scale the EVM amount down to the native precision, the conversion has to be exact
+    if (req.evm_decimals < config.native_precision || req.evm_decimals - config.native_precision > MAX_SCALE_EXPONENT) {
+      return PREFLIGHT_BAD_DECIMALS;
+    }
+    const u64_divisor factor(POW10.values[req.evm_decimals - config.native_precision]);
+    if (!to_native_units(intx::be::unsafe::load<uint256_t>(req.raw_amount.data()), factor, req.amount)) return PREFLIGHT_PRECISION_LOSS;
+
+    req.id = req_id;
+    std::memcpy(req.sender.data(), words[REQUEST_SLOT_SENDER].data() + 12, 20);
+    req.requested_at = wordToUint64(words[REQUEST_SLOT_REQUESTED_AT]);
+    req.memo = wordToString(words[REQUEST_SLOT_MEMO]);
+    return decodeReceiverName(words[REQUEST_SLOT_RECEIVER], req.receiver);
+  }
+
+  // v2 layout: REQUEST_V2_SLOT_COUNT (4) slots, amount already in native units. An empty memo is
+  // a zero word, which eosio.evm does not store.
+  // There is no decimals byte to check: TokenBridge.sol divides by its hard-coded
+  // antelope_amount_factor (10**14), so the amount is only right for a 4 decimal native token.
+  // evm.boid's setreqlayout refuses v2 for any other precision.
+  template<typename Storage>
+  preflight_status readPendingRequestV2(const Storage& storage, uint64_t req_id, preflight_request& req) {
+    const storage_word base = mappingKey(req_id, REQUESTS_MAPPING_SLOT);
+    storage_word words[REQUEST_V2_SLOT_COUNT] = {};
+    for (uint8_t slot = 0; slot < REQUEST_V2_SLOT_MEMO; ++slot) {
+      if (!storage.load(addToKey(base, slot), words[slot])) {
+        req.missing_slot = slot;
+        return PREFLIGHT_REQUEST_MISSING;
+      }
+    }
+    storage.load(addToKey(base, REQUEST_V2_SLOT_MEMO), words[REQUEST_V2_SLOT_MEMO]);
+
+    const storage_word& head = words[REQUEST_V2_SLOT_HEAD];
+    req.status = amountSlotStatus(words[REQUEST_V2_SLOT_AMOUNT]);
+    req.stored_id = head;
+    req.raw_amount = words[REQUEST_V2_SLOT_AMOUNT];
+    if (req.status != REQUEST_STATUS_PENDING) return PREFLIGHT_NOT_PENDING;
+    if (headId(head) != req_id) return PREFLIGHT_ID_MISMATCH;
+
+    req.amount = amountSlotAmount(req.raw_amount);
+    if (req.amount == 0 || req.amount > MAX_NATIVE_AMOUNT) return PREFLIGHT_INVALID_AMOUNT;
+
+    req.id = req_id;
+    req.sender = headSender(head);
+    req.requested_at = headRequestedAt(head);
+    req.memo = wordToString(words[REQUEST_V2_SLOT_MEMO]);
+    return decodeReceiverName(words[REQUEST_V2_SLOT_RECEIVER], req.receiver);
+  }
+
+  // reqnotify: not known to evm.boid yet and a valid pending Request on the EVM
+  template<typename Storage>
+  preflight_status preflightNotify(const Storage& storage, uint64_t req_id, bool notified, bool settled,
+                                   const request_preflight_config& config, preflight_request& req) {
+    if (notified) return PREFLIGHT_ALREADY_NOTIFIED;
+    if (settled) return PREFLIGHT_ALREADY_SETTLED;
+    return config.layout == REQUEST_LAYOUT_V2
+      ? readPendingRequestV2(storage, req_id, req)
+      : readPendingRequestV1(storage, req_id, config, req);
+  }
+
+  // verifytrx / finalize: an unpaid evm.boid row whose Request the success callback removed
+  // (its first slot is gone, the same in both layouts)
+  template<typename Storage>
+  preflight_status preflightSettle(const Storage& storage, uint64_t req_id, bool notified, bool processed) {
+    if (!notified) return PREFLIGHT_NOT_NOTIFIED;
+    if (processed) return PREFLIGHT_ALREADY_PROCESSED;
+    if (storage.contains(mappingKey(req_id, REQUESTS_MAPPING_SLOT))) return PREFLIGHT_STILL_ON_EVM;
+    return PREFLIGHT_OK;
+  }
+}
@@ -0,0 +1,16 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <cstdint>
+
+// Bitmap of the settled request ids kept by evm.boid in its `settledids` table: the row with
+// primary key w holds the ids w * 64 .. w * 64 + 63, bit (id % 64) is set once the id is paid out.
+// TokenBridge.sol hands out sequential ids, so the words fill up densely and the ledger costs
+// one row per 64 requests. Shared by the contract and the host tools in antelope-tools/.
+namespace evm_bridge
+{
+  static constexpr uint64_t SETTLED_IDS_PER_WORD = 64;
+
+  constexpr uint64_t settledWordIndex(uint64_t request_id) { return request_id / SETTLED_IDS_PER_WORD; }
+  constexpr uint64_t settledBit(uint64_t request_id) { return uint64_t(1) << (request_id % SETTLED_IDS_PER_WORD); }
+}
@@ -0,0 +1,125 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <eosio/eosio.hpp>
+#include <eosio/multi_index.hpp>
+#include <type_traits>
+#include <vector>
+
+// Forward-only cursor over a multi_index table for full scans (cleanup loops, debug dumps).
+// Contract only, unlike the other headers of include_common it needs the eosio intrinsics.
+//
+// multi_index keeps every row it loads in its object cache and searches that cache on each
+// lookup, so a scan gets slower and bigger row after row. The cursor talks to the database
+// directly: one row at a time, deserialized into the same object and buffer, nothing is cached.
+// It walks the primary index or one of the uint64_t secondary indexes and can erase the current
+// row (with all of its secondary index entries) while iterating.
+namespace evm_bridge
+{
+  namespace cursor_db = eosio::internal_use_do_not_use;
+
+  // Walk the primary key instead of a secondary index
+  static constexpr uint8_t CURSOR_PRIMARY = 0xFF;
+
+  template<typename Table>
+  class table_cursor;
+
+  template<eosio::name::raw TableName, typename T, typename... Indices>
+  class table_cursor<eosio::multi_index<TableName, T, Indices...>> {
+    public:
+      // Cursor on the first row with a key >= lower, in the order of index_position
+      // (CURSOR_PRIMARY or the position of the index in the multi_index definition)
+      table_cursor(eosio::name code, uint64_t scope, uint8_t index_position = CURSOR_PRIMARY, uint64_t lower = 0)
+        : _code(code.value), _scope(scope), _index(index_position) {
+        eosio::check(_index == CURSOR_PRIMARY || _index < sizeof...(Indices), "table_cursor: no such index");
+        if (_index == CURSOR_PRIMARY) {
+          _itr = cursor_db::db_lowerbound_i64(_code, _scope, TABLE, lower);
+          if (_itr >= 0) _primary = row().primary_key();
+        } else {
+          uint64_t secondary = lower;
+          _idx_itr = cursor_db::db_idx64_lowerbound(_code, _scope, indexTable(_index), &secondary, &_primary);
+          _itr = _idx_itr >= 0 ? cursor_db::db_find_i64(_code, _scope, TABLE, _primary) : -1;
+        }
+      }
+
+      bool valid() const { return _itr >= 0; }
+      explicit operator bool() const { return valid(); }
+
+      uint64_t primary() const { return _primary; }
+
+      // Current row, deserialized on first access into the object reused by the whole scan. It is
+      // reset first: binary_extension fields are only read when the row has bytes for them, a row
+      // written before the field was added would otherwise keep the previous row's value
+      const T& row() {
+        if (!_loaded) {
+          int32_t size = cursor_db::db_get_i64(_itr, nullptr, 0);
+          if (static_cast<size_t>(size) > _buffer.size()) _buffer.resize(size);
+          cursor_db::db_get_i64(_itr, _buffer.data(), size);
+          eosio::datastream<const char*> ds(_buffer.data(), size);
+          _row = T{};
+          ds >> _row;
+          _loaded = true;
+        }
+        return _row;
+      }
+      const T* operator->() { return &row(); }
+
+      void next() {
+        if (_index == CURSOR_PRIMARY) {
+          _itr = cursor_db::db_next_i64(_itr, &_primary);
+        } else {
+          _idx_itr = cursor_db::db_idx64_next(_idx_itr, &_primary);
+          _itr = _idx_itr >= 0 ? cursor_db::db_find_i64(_code, _scope, TABLE, _primary) : -1;
+        }
+        _loaded = false;
+      }
+
+      // Removes the current row and its secondary index entries, then moves to the next row
+      void erase() {
+        const T& current = row();
+        eosio::check(_code == eosio::current_receiver().value, "table_cursor: cannot erase rows of another contract");
+
+        // The next position has to be taken before the current one is removed
+        const int32_t removed_itr = _itr;
+        const int32_t removed_idx_itr = _idx_itr;
+        const uint64_t removed_primary = _primary;
+        next();
+
+        uint8_t position = 0;
+        (removeSecondary<Indices>(current, position++, removed_primary, removed_idx_itr), ...);
+        cursor_db::db_remove_i64(removed_itr);
+      }
+
+    private:
+      static constexpr uint64_t TABLE = static_cast<uint64_t>(TableName);
+
+      // Same ids multi_index uses for its secondary index tables
+      static constexpr uint64_t indexTable(uint8_t position) {
+        return (TABLE & 0xFFFFFFFFFFFFFFF0ULL) | (position & 0x0FULL);
+      }
+
+      template<typename Index>
+      void removeSecondary(const T& current, uint8_t position, uint64_t primary, int32_t current_idx_itr) {
+        using extractor = typename Index::secondary_extractor_type;
+        static_assert(std::is_same_v<std::decay_t<decltype(extractor()(current))>, uint64_t>,
+                      "table_cursor only supports uint64_t secondary indexes");
+        if (position == _index) {
+          cursor_db::db_idx64_remove(current_idx_itr);
+          return;
+        }
+        uint64_t secondary = 0;
+        int32_t idx_itr = cursor_db::db_idx64_find_primary(_code, _scope, indexTable(position), &secondary, primary);
+        if (idx_itr >= 0) cursor_db::db_idx64_remove(idx_itr);
+      }
+
+      uint64_t _code;
+      uint64_t _scope;
+      uint8_t _index;
+      int32_t _itr = -1;
+      int32_t _idx_itr = -1;
+      uint64_t _primary = 0;
+      bool _loaded = false;
+      T _row;
+      std::vector<char> _buffer;
+  };
+}
@@ -0,0 +1,77 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// Token buckets of the throughput governor (`setgovernor` on evm.boid and xsend.boid). Every
+// governed action takes one token: a bucket holds up to `burst` tokens and gains `per_hour` of
+// them an hour, so a sender gets `burst` actions at once and `per_hour` sustained. The level is
+// kept in 1/BUCKET_UNITS_PER_TOKEN tokens, a bucket gains `per_hour` units a second and the
+// refill needs no division. Taking a token is O(1) and the state has a fixed size.
+namespace evm_bridge
+{
+  static constexpr uint64_t BUCKET_UNITS_PER_TOKEN = 3600;
+
+  // Per sender buckets: a sender key picks one of GOVERNOR_SLOTS buckets, senders that land in the
+  // same slot share its bucket (a sender can only be limited earlier, never later)
+  static constexpr uint32_t GOVERNOR_SLOTS = 64;
+
+  struct bucket_limits {
+    uint32_t burst = 0;             // tokens, 0 = no limit
+    uint32_t per_hour = 0;          // refill rate
+  };
+
+  enum governor_status : uint8_t {
+    GOVERNOR_OK = 0,
+    GOVERNOR_GLOBAL_LIMIT,          // the direction's global bucket is empty
+    GOVERNOR_SENDER_LIMIT           // the bucket of the sender's slot is empty
+  };
+
+  inline const char* governorMessage(governor_status status) {
+    switch (status) {
+      case GOVERNOR_OK:           return "ok";
+      case GOVERNOR_GLOBAL_LIMIT: return "Bridge rate limit reached, try again later";
+      case GOVERNOR_SENDER_LIMIT: return "Bridge rate limit reached for this sender, try again later";
+    }
+    return "unknown governor status";
+  }
+
+  // Bucket is any type with `uint64_t level` (units) and `uint32_t updated_at` (unix seconds), the
+  // contracts keep it in their own serializable struct. A bucket that was never used starts full,
+  // a level above a lowered burst is cut down on the next take. On false the bucket is only
+  // refilled (the contracts fail the action then, so nothing is written).
+  template<typename Bucket>
+  inline bool takeToken(Bucket& bucket, const bucket_limits& limits, uint32_t now) {
+    if (limits.burst == 0) return true;
+    const uint64_t full = static_cast<uint64_t>(limits.burst) * BUCKET_UNITS_PER_TOKEN;
+    if (bucket.updated_at == 0 || bucket.level > full) {
+      bucket.level = full;
+    } else if (now > bucket.updated_at) {
+      // both factors are 32 bit, the product cannot overflow
+      const uint64_t gain = static_cast<uint64_t>(now - bucket.updated_at) * limits.per_hour;
+      bucket.level = gain >= full - bucket.level ? full : bucket.level + gain;
+    }
+    if (now > bucket.updated_at) bucket.updated_at = now;
+
+    if (bucket.level < BUCKET_UNITS_PER_TOKEN) return false;
+    bucket.level -= BUCKET_UNITS_PER_TOKEN;
+    return true;
+  }
+
+  // Slot of a sender key (Fibonacci hashing, the top bits of the product are the best mixed)
+  inline uint32_t governorSlot(uint64_t key) {
+    static_assert((GOVERNOR_SLOTS & (GOVERNOR_SLOTS - 1)) == 0, "GOVERNOR_SLOTS must be a power of two");
+    return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ULL) >> 32) & (GOVERNOR_SLOTS - 1);
+  }
+
+  // Sender key of an EVM address: its 20 bytes folded into 64 bits
+  inline uint64_t addressKey(const uint8_t* address) {
+    uint64_t a = 0, b = 0;
+    uint32_t c = 0;
+    std::memcpy(&a, address, 8);
+    std::memcpy(&b, address + 8, 8);
+    std::memcpy(&c, address + 16, 4);
+    return a ^ (b * 0x9E3779B97F4A7C15ULL) ^ c;
+  }
+}
@@ -0,0 +1,204 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <u256_kernels.hpp>
+
+// Benchmark cases for u256_kernels.hpp, the same code runs on x86-64 (antelope-tools u256bench)
+// and in wasm (src/u256Bench.cpp, timed by benchU256.sh through the action elapsed time).
+// Every case has the generic intx form the bridge used before and the kernel, both fold their
+// results into a checksum so nothing is optimized away and the two can be compared.
+namespace evm_bridge
+{
+  static constexpr uint32_t U256_BENCH_INPUTS = 64;
+
+  // Inputs shaped like the bridge's: gas prices around 500 gwei, native amounts, 10^14 factors
+  struct u256_bench_inputs {
+    uint64_t small[U256_BENCH_INPUTS];
+    uint256_t gas[U256_BENCH_INPUTS];
+    uint256_t evm_amount[U256_BENCH_INPUTS];
+
+    u256_bench_inputs() {
+      uint64_t x = 0x9e3779b97f4a7c15ULL;
+      for (uint32_t i = 0; i < U256_BENCH_INPUTS; ++i) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        small[i] = x % 1000000000000ULL + 1;
+        gas[i] = uint256_t(500000000000ULL + x % 100000000000ULL);
+        evm_amount[i] = uint256_t(intx::umul(small[i], 100000000000000ULL));
+      }
+    }
+  };
+
+  // loop(iterations, inputs) -> checksum
+  using u256_bench_loop = uint64_t (*)(uint32_t, const u256_bench_inputs&);
+
+  struct u256_bench_case {
+    const char* name;
+    u256_bench_loop generic;
+    u256_bench_loop fast;
+  };
+
+  inline uint64_t u256Fold(const uint256_t& x) { return x.lo.lo ^ x.lo.hi ^ x.hi.lo ^ x.hi.hi; }
+
+  //======================== Cases ========================
+  // gas price + 10%
+  inline uint64_t benchGasGeneric(uint32_t n, const u256_bench_inputs& in) {
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < n; ++i) sum += u256Fold((in.gas[i % U256_BENCH_INPUTS] * 11) / 10);
+    return sum;
+  }
+  inline uint64_t benchGasFast(uint32_t n, const u256_bench_inputs& in) {
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < n; ++i) sum += u256Fold(mulDivSmall(in.gas[i % U256_BENCH_INPUTS], 11, 10));
+    return sum;
+  }
+
+  // EVM amount -> native units with the exactness check
+  inline uint64_t benchToNativeGeneric(uint32_t n, const u256_bench_inputs& in) {
+    uint64_t sum = 0;
+    const uint256_t factor = uint256_t(100000000000000ULL);
+    for (uint32_t i = 0; i < n; ++i) {
+      const auto res = intx::udivrem(in.evm_amount[i % U256_BENCH_INPUTS], factor);
+      if (res.rem == 0 && res.quot <= uint256_t((1ULL << 62) - 1)) sum += static_cast<uint64_t>(res.quot);
+    }
+    return sum;
+  }
+  inline uint64_t benchToNativeFast(uint32_t n, const u256_bench_inputs& in) {
+    uint64_t sum = 0;
+    const u64_divisor factor(100000000000000ULL); // prepared once, like runtime_decimal_scaler
+    for (uint32_t i = 0; i < n; ++i) {
+      uint64_t rem;
+      const uint256_t quot = divremSmall(in.evm_amount[i % U256_BENCH_INPUTS], factor, rem);
+      if (rem == 0 && fitsUint64(quot) && quot.lo.lo <= (1ULL << 62) - 1) sum += quot.lo.lo;
+    }
+    return sum;
+  }
+
+  // native units -> EVM amount
+  inline uint64_t benchToEvmGeneric(uint32_t n, const u256_bench_inputs& in) {
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < n; ++i) sum += u256Fold(uint256_t(in.small[i % U256_BENCH_INPUTS]) * uint256_t(100000000000000ULL));
+    return sum;
+  }
+  inline uint64_t benchToEvmFast(uint32_t n, const u256_bench_inputs& in) {
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < n; ++i) sum += u256Fold(uint256_t(intx::umul(in.small[i % U256_BENCH_INPUTS], 100000000000000ULL)));
+    return sum;
+  }
+
+  // RLP integer: big-endian without leading zeros
+  inline uint64_t benchRlpIntGeneric(uint32_t n, const u256_bench_inputs& in) {
+    uint64_t sum = 0;
+    uint8_t out[32];
+    for (uint32_t i = 0; i < n; ++i) {
+      const uint256_t& x = in.gas[i % U256_BENCH_INPUTS];
+      uint8_t arr[32];
+      intx::be::store(arr, x);
+      const size_t len = intx::count_significant_words<uint8_t>(x);
+      std::memcpy(out, arr + 32 - len, len);
+      sum += len + out[len - 1];
+    }
+    return sum;
+  }
+  inline uint64_t benchRlpIntFast(uint32_t n, const u256_bench_inputs& in) {
+    uint64_t sum = 0;
+    uint8_t out[32];
+    for (uint32_t i = 0; i < n; ++i) {
+      const size_t len = storeTrimmedBe(in.gas[i % U256_BENCH_INPUTS], out);
+      sum += len + out[len - 1];
+    }
+    return sum;
+  }
+
+  // ABI word of a 64 bit value (request id, count, name)
+  inline uint64_t benchWordGeneric(uint32_t n, const u256_bench_inputs& in) {
+    uint64_t sum = 0;
+    uint8_t out[32];
+    for (uint32_t i = 0; i < n; ++i) {
+      intx::be::unsafe::store(out, uint256_t(in.small[i % U256_BENCH_INPUTS]));
+      sum += out[31] + out[i % 32];
+    }
+    return sum;
+  }
+  inline uint64_t benchWordFast(uint32_t n, const u256_bench_inputs& in) {
+    uint64_t sum = 0;
+    uint8_t out[32];
+    for (uint32_t i = 0; i < n; ++i) {
+      storeWordBe64(out, in.small[i % U256_BENCH_INPUTS]);
+      sum += out[31] + out[i % 32];
+    }
+    return sum;
+  }
+
+  static constexpr u256_bench_case U256_BENCH_CASES[] = {
+    {"gas_margin", benchGasGeneric, benchGasFast},
+    {"to_native", benchToNativeGeneric, benchToNativeFast},
+    {"to_evm", benchToEvmGeneric, benchToEvmFast},
+    {"rlp_int", benchRlpIntGeneric, benchRlpIntFast},
+    {"abi_word", benchWordGeneric, benchWordFast}
+  };
+
+  inline const u256_bench_case* findU256BenchCase(const std::string& name) {
+    for (const auto& c : U256_BENCH_CASES) {
+      if (name == c.name) return &c;
+    }
+    return nullptr;
+  }
+
+  //======================== Verification ========================
+  // Kernels against the intx operators on edge values (64 / 128 / 256 bit boundaries, all
+  // divisor shapes). Returns the number of mismatches, `report` gets a line for each.
+  template<typename Report>
+  uint32_t verifyU256Kernels(Report&& report) {
+    const uint256_t max = ~uint256_t(0);
+    const uint256_t values[] = {
+      0, 1, 10, 0xff, 0x100, UINT64_MAX, uint256_t(UINT64_MAX) + 1, uint256_t(intx::uint128(UINT64_MAX, UINT64_MAX)),
+      uint256_t(intx::uint128(1, 0)) << 64, max, max >> 1, max - 1, uint256_t(500000000000ULL),
+      uint256_t(intx::umul(4611686018427387903ULL, 100000000000000ULL)), uint256_t(0x0123456789abcdefULL) << 190
+    };
+    const uint64_t smalls[] = {1, 2, 3, 10, 11, 100000000000000ULL, 0x8000000000000000ULL, UINT64_MAX, 0x00000000ffffffffULL};
+    uint32_t failures = 0;
+    for (const auto& x : values) {
+      uint8_t generic[32], fast[32];
+      intx::be::store(generic, x);
+      const size_t len = x == 0 ? 0 : intx::count_significant_words<uint8_t>(x);
+      if (storeTrimmedBe(x, fast) != len || std::memcmp(fast, generic + 32 - len, len) != 0) {
+        ++failures;
+        report("storeTrimmedBe", x, 0);
+      }
+      if (fitsUint64(x) != (x <= uint256_t(UINT64_MAX))) {
+        ++failures;
+        report("fitsUint64", x, 0);
+      }
+      for (uint64_t d : smalls) {
+        if (mulSmall(x, d) != x * uint256_t(d)) {
+          ++failures;
+          report("mulSmall", x, d);
+        }
+        uint64_t rem;
+        const uint256_t quot = divremSmall(x, d, rem);
+        const auto res = intx::udivrem(x, uint256_t(d));
+        if (quot != res.quot || uint256_t(rem) != res.rem) {
+          ++failures;
+          report("divremSmall", x, d);
+        }
+        if (mulDivSmall(x, d, 10) != (x * uint256_t(d)) / 10) {
+          ++failures;
+          report("mulDivSmall", x, d);
+        }
+      }
+    }
+    for (uint64_t v : smalls) {
+      uint8_t generic[32], fast[32];
+      intx::be::unsafe::store(generic, uint256_t(v));
+      storeWordBe64(fast, v);
+      if (std::memcmp(generic, fast, 32) != 0) {
+        ++failures;
+        report("storeWordBe64", uint256_t(v), 0);
+      }
+    }
+    return failures;
+  }
+}
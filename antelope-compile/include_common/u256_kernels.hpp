@@ -0,0 +1,136 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits> // intx specializes std::numeric_limits without including it
+#include <intx/base.hpp>
+
+// Fast paths for the 256 bit arithmetic the bridge does on values that are really 64 bit
+// (gas price, amounts, request ids, decimal factors). intx's generic routines normalize and
+// loop over every word whatever the value, these kernels check "fits in 64 bits" first and
+// otherwise work word by word with a 64 bit operand:
+//  - 256 x 64 multiplication with a carry chain
+//  - 256 / 64 division with intx's reciprocal 2-by-1 step (no normalization of a 256 bit divisor)
+//  - big-endian stores straight into the caller's buffer
+// Results are bit for bit the ones of the intx operators, products wrap at 2^256 the same way.
+// Words are read through the {lo, hi} halves of the vendored intx (uint256 = 2 x uint128).
+// Shared by the contracts and the host tools (antelope-tools u256bench).
+namespace evm_bridge
+{
+  // Little-endian words of x
+  inline void u256Words(const uint256_t& x, uint64_t w[4]) {
+    w[0] = x.lo.lo;
+    w[1] = x.lo.hi;
+    w[2] = x.hi.lo;
+    w[3] = x.hi.hi;
+  }
+
+  inline uint256_t u256FromWords(const uint64_t w[4]) {
+    return uint256_t(intx::uint128(w[3], w[2]), intx::uint128(w[1], w[0]));
+  }
+
+  inline bool fitsUint64(const uint256_t& x) {
+    return (x.lo.hi | x.hi.lo | x.hi.hi) == 0;
+  }
+
+  // x * m mod 2^256
+  inline uint256_t mulSmall(const uint256_t& x, uint64_t m) {
+    if (fitsUint64(x)) return uint256_t(intx::umul(x.lo.lo, m));
+    uint64_t w[4];
+    u256Words(x, w);
+    uint64_t carry = 0;
+    for (int i = 0; i < 4; ++i) {
+      intx::uint128 p = intx::umul(w[i], m);
+      p.lo += carry;
+      carry = p.hi + (p.lo < carry ? 1 : 0);
+      w[i] = p.lo;
+    }
+    return u256FromWords(w);
+  }
+
+  // A 64 bit divisor prepared once (normalized form and its reciprocal), for code that divides
+  // by the same value again and again like the decimal scaler
+  struct u64_divisor {
+    uint64_t value;
+    unsigned shift;
+    uint64_t normalized;
+    uint64_t reciprocal;
+
+    // d must not be 0
+    explicit u64_divisor(uint64_t d) : value(d), shift(intx::clz(d)) {
+      normalized = d << shift;
+      reciprocal = intx::reciprocal_2by1(normalized);
+    }
+  };
+
+  // x / d and x % d
+  inline uint256_t divremSmall(const uint256_t& x, const u64_divisor& d, uint64_t& rem) {
+    if (fitsUint64(x)) {
+      rem = x.lo.lo % d.value;
+      return uint256_t(x.lo.lo / d.value);
+    }
+    uint64_t w[4];
+    u256Words(x, w);
+
+    // Shift the numerator along with the normalized divisor, starting at its top non-zero
+    // word (a native amount times a decimal factor only uses 2 of the 4)
+    int top = 3;
+    while (w[top] == 0) --top;
+    const unsigned shift = d.shift;
+    uint64_t r = shift ? w[top] >> (64 - shift) : 0;
+    uint64_t q[4] = {};
+    for (int j = top; j >= 0; --j) {
+      const uint64_t u = (w[j] << shift) | (shift && j > 0 ? w[j - 1] >> (64 - shift) : 0);
+      const auto res = intx::udivrem_2by1(intx::uint128(r, u), d.normalized, d.reciprocal);
+      q[j] = res.quot;
+      r = res.rem;
+    }
+    rem = r >> shift;
+    return u256FromWords(q);
+  }
+
+  // x / d and x % d, d must not be 0
+  inline uint256_t divremSmall(const uint256_t& x, uint64_t d, uint64_t& rem) {
+    if (fitsUint64(x)) {
+      rem = x.lo.lo % d;
+      return uint256_t(x.lo.lo / d);
+    }
+    return divremSmall(x, u64_divisor(d), rem);
+  }
+
+  // (x * num) / den with the intx wrap-around of the product, den must not be 0
+  inline uint256_t mulDivSmall(const uint256_t& x, uint64_t num, uint64_t den) {
+    if (fitsUint64(x) && (num == 0 || x.lo.lo <= UINT64_MAX / num)) return uint256_t(x.lo.lo * num / den);
+    uint64_t rem;
+    return divremSmall(mulSmall(x, num), den, rem);
+  }
+
+  // Bytes of x without the leading zero bytes (0 for x == 0)
+  inline size_t significantBytes(const uint256_t& x) {
+    uint64_t w[4];
+    u256Words(x, w);
+    for (int i = 3; i >= 0; --i) {
+      if (w[i]) return size_t(i) * 8 + 8 - intx::clz(w[i]) / 8;
+    }
+    return 0;
+  }
+
+  // Big-endian x without leading zeros into out (32 bytes of room), returns the length
+  inline size_t storeTrimmedBe(const uint256_t& x, uint8_t* out) {
+    const size_t len = significantBytes(x);
+    for (size_t i = 0; i < len; ++i) {
+      const size_t byte = len - 1 - i; // from the lowest byte
+      const uint64_t word = byte < 8 ? x.lo.lo : byte < 16 ? x.lo.hi : byte < 24 ? x.hi.lo : x.hi.hi;
+      out[i] = static_cast<uint8_t>(word >> (8 * (byte % 8)));
+    }
+    return len;
+  }
+
+  // A 32 byte big-endian word holding a 64 bit value
+  inline void storeWordBe64(uint8_t* out, uint64_t value) {
+    std::memset(out, 0, 24);
+    for (int i = 0; i < 8; ++i) out[24 + i] = static_cast<uint8_t>(value >> (56 - 8 * i));
+  }
+}
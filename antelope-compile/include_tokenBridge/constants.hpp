@@ -1,5 +1,6 @@
 #pragma once
 #include <eosio/eosio.hpp>
+#include <bridge_storage.hpp>
 
 // contract name
 #define BRIDGE_CONTRACT_NAME_MACRO BRIDGE_CONTRACT_NAME
@@ -10,12 +11,34 @@ namespace evm_bridge
   static constexpr auto WORD_SIZE = 32u;
   static constexpr uint64_t SUCCESS_CB_GAS = 250000; // Todo: find exact needed gas
   static constexpr uint64_t BRIDGE_GAS = 250000; // Todo: find exact needed gas
+  // Gas price of the raw calls: eosio.evm's price + 10%, in case it moves up before the call runs
+  static constexpr uint64_t GAS_PRICE_MARGIN_NUM = 11;
+  static constexpr uint64_t GAS_PRICE_MARGIN_DEN = 10;
   static constexpr auto EVM_SUCCESS_CALLBACK_SIGNATURE = "0fbc79cd"; // "requestSuccessful(uint256)"
-  static constexpr auto EVM_BRIDGE_SIGNATURE = "2e5dcb4b"; // bridgeTo(address,address,uint256,bytes32)
-  static constexpr auto EVM_REF_STUCK_REQ_SIGNATURE = "35a89085"; // refundStuckReq()
-  static constexpr auto EVM_CLEAR_FAILED_REQUESTS_SIGNATURE = "fc9e33a5"; // clearFailedRequests()
+  static constexpr auto EVM_BRIDGE_SIGNATURE = "2e5dcb4b"; // bridgeTo(address,address,uint256,bytes32), v1 still appends the sender as an ABI string
+  static constexpr auto EVM_BRIDGE_V2_SIGNATURE = "f06e8ee4"; // bridgeToV2(address,address,uint64,uint64)
+  static constexpr auto EVM_BRIDGE_BATCH_SIGNATURE = "af139de5"; // bridgeToBatch(address[],uint256[],bytes32[])
+  static constexpr auto EVM_REF_STUCK_REQ_SIGNATURE = "cc5bdf4a"; // refundStuckReq(uint256,uint256)
+  static constexpr auto EVM_CLEAR_FAILED_REQUESTS_SIGNATURE = "94bb59ca"; // clearFailedRequests(uint256,uint256)
   static constexpr auto EVM_REMOVE_REQUEST_SIGNATURE = "44786fc3"; // removeRequest(uint256)
-  static constexpr uint8_t STORAGE_BRIDGE_REQUESTS_INDEX = 9;
+  static constexpr uint8_t STORAGE_BRIDGE_REQUESTS_INDEX = REQUESTS_MAPPING_SLOT;
   static constexpr uint8_t STORAGE_BRIDGE_TOKEN_CONTRACT_INDEX = 6;
   static constexpr uint8_t STORAGE_BRIDGE_TOKEN_SYMBOL_INDEX = 8;
+  // bridgeTo calldata sent by `bridge` (bridgeconfig bridge_protocol)
+  static constexpr uint8_t BRIDGE_PROTOCOL_V1 = 1; // bridgeTo: amount in EVM units, sender as a dynamic string (196 bytes)
+  static constexpr uint8_t BRIDGE_PROTOCOL_V2 = 2; // bridgeToV2: amount in native units, sender as its uint64 name (132 bytes)
+  static constexpr uint8_t EVM_TOKEN_DECIMALS = 18; // TokenBridge.sol evm_decimals, OFT tokens always use 18 decimals
+  // Native precision of the v2 amounts: TokenBridge.sol scales them with the hard-coded antelope_amount_factor (10**14 = 18 - 4)
+  static constexpr uint8_t TOKEN_BRIDGE_V2_PRECISION = 4;
+  static constexpr uint32_t MAX_QUERY_LIMIT = 100; // Max rows returned by the read-only query actions
+  // Paged recovery (refstuckreq / clrfailedreq), the gas limit grows with the page size
+  static constexpr uint64_t RECOVERY_CURSOR = 0xFFFFFFFFFFFFFFFFULL; // start value continuing from the cursor TokenBridge.sol keeps
+  static constexpr uint32_t MAX_RECOVERY_PAGE = 50; // entries of activeRequestIds looked at per call
+  static constexpr uint64_t RECOVERY_BASE_GAS = 80000; // call, cursor write and page event
+  static constexpr uint64_t REFUND_GAS_PER_REQUEST = 150000; // mint + swap-and-pop removal + events
+  static constexpr uint64_t CLEAR_GAS_PER_REQUEST = 70000; // swap-and-pop removal + events
+  // Queued native -> EVM transfers (bridgequeue), sent together by one bridgeToBatch call
+  static constexpr uint32_t MAX_BATCH_SIZE = 50; // transfers per bridgeToBatch
+  static constexpr uint64_t BATCH_BASE_GAS = 60000; // call and array decoding
+  static constexpr uint64_t BATCH_GAS_PER_TRANSFER = 90000; // mint + BridgeTransaction event
 }
\ No newline at end of file
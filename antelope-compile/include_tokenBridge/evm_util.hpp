@@ -4,6 +4,7 @@
 #include <array>
 #include <cstdint>
 #include <cstring>
+#include <u256_kernels.hpp>
 
 using namespace evm_bridge;
 
@@ -15,27 +16,13 @@ namespace evm_bridge
    */
   static inline std::string bin2hex(const std::vector<uint8_t>& bin)
   {
-    std::string res;
-    const char hex[] = "0123456789abcdef";
-    for(auto byte : bin) {
-      res += hex[byte >> 4];
-      res += hex[byte & 0xf];
-    }
-
-    return res;
+    return toHex(bin.data(), bin.size());
   }
 
   template<unsigned N, typename T>
   static inline std::string bin2hex(const std::array<T, N>& bin)
   {
-    std::string res;
-    const char hex[] = "0123456789abcdef";
-    for(auto byte : bin) {
-      res += hex[byte >> 4];
-      res += hex[byte & 0xf];
-    }
-
-    return res;
+    return toHex(bin);
   }
 
   inline constexpr bool is_precompile(uint256_t address) {
@@ -179,41 +166,83 @@ namespace evm_bridge
 
   // Parses an EVM address from an EVM Storage string
   inline std::vector<uint8_t> parseAddressFromStorage(const uint256_t checksum){
-    std::vector<uint8_t> bs = intx::to_byte_string(checksum);
-    reverse(bs.begin(),bs.end());
-    bs.resize(20); // remove trailing 0
-    reverse(bs.begin(),bs.end());
-    return bs;
+    // the low 20 bytes of the word, big-endian
+    uint8_t word[32];
+    intx::be::unsafe::store(word, checksum);
+    return std::vector<uint8_t>(word + 12, word + 32);
   }
 
-  template <typename T, typename U>
-  static inline void insertElementPosition(std::vector<T> *data, U position){
-        std::vector<T> string_position_bs = pad(intx::to_byte_string(position), 32, true);
-        data->insert(data->end(), string_position_bs.begin(), string_position_bs.end());
+  /**
+   * ABI calldata, appended in place to any byte buffer (std::vector<uint8_t> or scratch_bytes)
+   */
+  // 4 byte function selector from its 8 character hex form
+  template <typename Buffer>
+  static inline void appendSelector(Buffer& data, const char* selector_hex){
+    const size_t start = data.size();
+    data.resize(start + 4);
+    eosio::check(decodeHex(selector_hex, 4, data.data() + start), "Invalid function selector");
   }
 
-  template <typename T, typename... Args>
-  static inline void insertElementPositions(std::vector<T> *data, Args... args){
-    (insertElementPosition(data, args), ...);
+  // Big-endian 32 byte word
+  template <typename Buffer>
+  static inline void appendWord(Buffer& data, const uint256_t& value){
+    const size_t start = data.size();
+    data.resize(start + 32);
+    intx::be::unsafe::store(data.data() + start, value);
   }
 
+  // Same word for a 64 bit value (ids, counts, native amounts, names), no uint256_t in between
+  template <typename Buffer>
+  static inline void appendWord(Buffer& data, uint64_t value){
+    const size_t start = data.size();
+    data.resize(start + 32);
+    storeWordBe64(data.data() + start, value);
+  }
 
-  template <typename T>
-  static inline void insertString(std::vector<T> *data, std::string value, uint64_t length){
-    std::vector<T> string_size = pad(intx::to_byte_string(length), 32, true);
-    std::vector<T> str(value.begin(), value.end());
-    str = pad(str, 32, false);
-    data->insert(data->end(), string_size.begin(), string_size.end());
-    data->insert(data->end(), str.begin(), str.end());
+  // Address left padded to 32 bytes
+  template <typename Buffer>
+  static inline void appendAddressWord(Buffer& data, const eosio::checksum160& address){
+    const auto bytes = address.extract_as_byte_array();
+    const size_t start = data.size();
+    data.resize(start + 32, 0);
+    std::memcpy(data.data() + start + 12, bytes.data(), 20);
   }
 
-  template <typename T>
-  static inline void insertName(std::vector<T> *data, uint64_t value, uint64_t length){
+  // Antelope name as its string, left aligned in a bytes32 word (TokenBridge.sol bytes32ToString)
+  template <typename Buffer>
+  static inline void appendNameWord(Buffer& data, eosio::name value){
+    const std::string text = value.to_string();
+    const size_t start = data.size();
+    data.resize(start + 32, 0);
+    std::memcpy(data.data() + start, text.data(), text.size());
+  }
+
+  template <typename Buffer, typename U>
+  static inline void insertElementPosition(Buffer *data, U position){
+    appendWord(*data, static_cast<uint64_t>(position));
+  }
+
+  template <typename Buffer, typename... Args>
+  static inline void insertElementPositions(Buffer *data, Args... args){
+    (insertElementPosition(data, args), ...);
+  }
+
+  // Length word followed by the string bytes, right padded to 32 bytes
+  template <typename Buffer>
+  static inline void insertString(Buffer *data, const std::string& value, uint64_t length){
+    appendWord(*data, length);
+    const size_t start = data->size();
+    data->resize(start + std::max<size_t>(value.size(), 32), 0);
+    std::memcpy(data->data() + start, value.data(), value.size());
+  }
+
+  template <typename Buffer>
+  static inline void insertName(Buffer *data, uint64_t value, uint64_t length){
     insertString(data, eosio::name(value).to_string(), length);
   }
 
-  template <typename T>
-  static inline void insertName(std::vector<T> *data, eosio::name value, uint64_t length){
+  template <typename Buffer>
+  static inline void insertName(Buffer *data, eosio::name value, uint64_t length){
     insertString(data, value.to_string(), length);
   }
 
@@ -258,48 +287,18 @@ namespace evm_bridge
   }
 
   inline eosio::checksum256 addToChecksum256(const eosio::checksum256& base, uint8_t offset) {
-      // Extract the underlying 32-byte array.
-      auto arr = base.extract_as_byte_array();
-      uint64_t carry = offset;
-      // Add the offset to the big‑endian number (starting at the least-significant byte).
-      for (int i = 31; i >= 0 && carry != 0; --i) {
-          uint16_t sum = static_cast<uint16_t>(arr[i]) + (carry & 0xFF);
-          arr[i] = static_cast<uint8_t>(sum & 0xFF);
-          carry = (carry >> 8) + (sum >> 8);
-      }
-      return eosio::checksum256(arr);
+      // Add the offset to the big-endian number (starting at the least-significant byte).
+      return eosio::checksum256(addToKey(base.extract_as_byte_array(), offset));
   }
 
   inline eosio::checksum256 computeMappingKey(uint64_t req_id, uint64_t mapping_base_slot) {
-      // Create a 32-byte array for req_id (all zeros)
-      std::array<uint8_t, 32> reqIdBytes = {0};
-      // Encode req_id into the lower 8 bytes (big-endian)
-      for (uint8_t i = 0; i < 8; i++) {
-          reqIdBytes[31 - i] = static_cast<uint8_t>((req_id >> (i * 8)) & 0xFF);
-      }
-      
-      // Create a 32-byte array for mapping_base_slot (all zeros)
-      std::array<uint8_t, 32> baseSlotBytes = {0};
-      // Encode mapping_base_slot into the lower 8 bytes (big-endian)
-      for (uint8_t i = 0; i < 8; i++) {
-          baseSlotBytes[31 - i] = static_cast<uint8_t>((mapping_base_slot >> (i * 8)) & 0xFF);
-      }
-      
-      // Concatenate the two 32-byte arrays into a 64-byte vector.
-      std::vector<uint8_t> buf(64, 0);
-      std::copy(reqIdBytes.begin(), reqIdBytes.end(), buf.begin());
-      std::copy(baseSlotBytes.begin(), baseSlotBytes.end(), buf.begin() + 32);
-      
-      // Compute Keccak-256 on the 64-byte buffer.
-      // (This assumes you have a keccak_256 function that accepts a std::vector<uint8_t>
-      // and returns a std::array<uint8_t,32>.)
-      std::array<uint8_t, 32> hash = keccak_256(buf);
-      
-    // Construct the raw base key.
-    eosio::checksum256 base = eosio::checksum256(hash);
-    
-    // Add a fixed offset so that the computed key points to the actual stored data.
-    return base;
+      // keccak256(pad32(req_id) . pad32(mapping_base_slot)), see include_common/bridge_storage.hpp
+      return eosio::checksum256(mappingKey(req_id, mapping_base_slot));
+  }
+
+  // Gas price of a raw call from the eosio.evm config price (GAS_PRICE_MARGIN_NUM / GAS_PRICE_MARGIN_DEN)
+  inline uint256_t gasPriceWithMargin(const uint256_t& evm_gas_price) {
+      return mulDivSmall(evm_gas_price, GAS_PRICE_MARGIN_NUM, GAS_PRICE_MARGIN_DEN);
   }
 
   // Converts a uint256_t to a 32-byte array
@@ -0,0 +1,142 @@
+#pragma once
+#include <optional>
+#include <evm_tables.hpp>
+
+using namespace std;
+using namespace eosio;
+using namespace evm_bridge;
+
+namespace evm_bridge {
+    //======================== eosio.evm row views =======================
+    // Reads eosio.evm rows straight from the database and decodes only the fields the bridge uses,
+    // at their offsets in the serialized row (see the EOSLIB_SERIALIZE order in evm_tables.hpp).
+    // account_table / account_state_table stay for the cases that need full rows.
+    namespace evm_db = eosio::internal_use_do_not_use;
+
+    // Account: index (8) | address (20) | account (8) | nonce (8) | code (varuint + bytes) | balance (32)
+    static constexpr uint32_t ACCOUNT_ROW_PREFIX_SIZE = 8 + 20 + 8 + 8;
+    // AccountState: index (8) | key (32) | value (32, big endian)
+    static constexpr uint32_t ACCOUNT_STATE_ROW_SIZE = 8 + 32 + 32;
+    static constexpr uint32_t ACCOUNT_STATE_VALUE_OFFSET = 8 + 32;
+
+    // Table id of a multi_index secondary index: table name with the index position in the low nibble
+    inline constexpr uint64_t secondaryIndexTable(eosio::name table, uint8_t position) {
+        return (table.value & 0xFFFFFFFFFFFFFFF0ULL) | (position & 0x0FULL);
+    }
+
+    static constexpr eosio::name EVM_ACCOUNT_TABLE = "account"_n;
+    static constexpr eosio::name EVM_ACCOUNT_STATE_TABLE = "accountstate"_n;
+    static constexpr uint64_t EVM_ACCOUNT_BYADDRESS = secondaryIndexTable(EVM_ACCOUNT_TABLE, 0);
+    static constexpr uint64_t EVM_ACCOUNT_BYACCOUNT = secondaryIndexTable(EVM_ACCOUNT_TABLE, 1);
+    static constexpr uint64_t EVM_ACCOUNT_STATE_BYKEY = secondaryIndexTable(EVM_ACCOUNT_STATE_TABLE, 0);
+
+    // Fields of an Account row before the code, the code and balance are never read
+    struct evm_account_view {
+        uint64_t index = 0;
+        eosio::checksum160 address;
+        eosio::name account;
+        uint64_t nonce = 0;
+    };
+
+    // Reads the Account row with primary key `index`
+    inline evm_account_view readEvmAccount(uint64_t index) {
+        const uint64_t code = eosio::name(EVM_SYSTEM_CONTRACT).value;
+        int32_t itr = evm_db::db_find_i64(code, code, EVM_ACCOUNT_TABLE.value, index);
+        eosio::check(itr >= 0, "eosio.evm account row not found for index " + std::to_string(index));
+
+        uint8_t row[ACCOUNT_ROW_PREFIX_SIZE];
+        int32_t size = evm_db::db_get_i64(itr, row, sizeof(row));
+        eosio::check(size >= static_cast<int32_t>(sizeof(row)), "Unexpected eosio.evm account row size");
+
+        evm_account_view view;
+        std::array<uint8_t, 20> address;
+        std::memcpy(&view.index, row, 8);
+        std::memcpy(address.data(), row + 8, 20);
+        std::memcpy(&view.account.value, row + 28, 8);
+        std::memcpy(&view.nonce, row + 36, 8);
+        view.address = eosio::checksum160(address);
+        return view;
+    }
+
+    // EVM account owned by a native account (byaccount index)
+    inline std::optional<evm_account_view> findEvmAccountByName(eosio::name account) {
+        const uint64_t code = eosio::name(EVM_SYSTEM_CONTRACT).value;
+        uint64_t secondary = account.value;
+        uint64_t index = 0;
+        if (evm_db::db_idx64_find_secondary(code, code, EVM_ACCOUNT_BYACCOUNT, &secondary, &index) < 0) return std::nullopt;
+        return readEvmAccount(index);
+    }
+
+    inline evm_account_view requireEvmAccountByName(eosio::name account) {
+        auto view = findEvmAccountByName(account);
+        eosio::check(view.has_value(), "EVM account not found for " + account.to_string());
+        return *view;
+    }
+
+    // EVM account by address (byaddress index, key is the address padded to 32 bytes)
+    inline std::optional<evm_account_view> findEvmAccountByAddress(const eosio::checksum160& address) {
+        const uint64_t code = eosio::name(EVM_SYSTEM_CONTRACT).value;
+        const eosio::checksum256 key = pad160(address);
+        uint64_t index = 0;
+        if (evm_db::db_idx256_find_secondary(code, code, EVM_ACCOUNT_BYADDRESS, key.get_array().data(), 2, &index) < 0) return std::nullopt;
+        return readEvmAccount(index);
+    }
+
+    // Storage slots of one EVM contract (accountstate scope = account index), looked up by key
+    class evm_storage_view {
+        public:
+            explicit evm_storage_view(uint64_t scope) : _scope(scope) {}
+
+            // Only the index lookup, the row is not read
+            bool contains(const eosio::checksum256& key) const {
+                uint64_t primary = 0;
+                return findKey(key, primary);
+            }
+
+            // Loads the value stored at key, false if the slot is not set
+            bool get(const eosio::checksum256& key, uint256_t& value) const {
+                const uint64_t code = eosio::name(EVM_SYSTEM_CONTRACT).value;
+                uint64_t primary = 0;
+                if (!findKey(key, primary)) return false;
+
+                int32_t itr = evm_db::db_find_i64(code, _scope, EVM_ACCOUNT_STATE_TABLE.value, primary);
+                eosio::check(itr >= 0, "eosio.evm accountstate row missing for an indexed key");
+
+                uint8_t row[ACCOUNT_STATE_ROW_SIZE];
+                int32_t size = evm_db::db_get_i64(itr, row, sizeof(row));
+                eosio::check(size == static_cast<int32_t>(sizeof(row)), "Unexpected eosio.evm accountstate row size");
+                value = intx::be::unsafe::load<uint256_t>(row + ACCOUNT_STATE_VALUE_OFFSET);
+                return true;
+            }
+
+            // Storage interface of the pre-flight checks (request_preflight.hpp), the value is copied as
+            // stored (big endian) without going through uint256_t
+            bool contains(const storage_word& key) const { return contains(eosio::checksum256(key)); }
+
+            bool load(const storage_word& key, storage_word& value) const {
+                const uint64_t code = eosio::name(EVM_SYSTEM_CONTRACT).value;
+                uint64_t primary = 0;
+                if (!findKey(eosio::checksum256(key), primary)) return false;
+
+                int32_t itr = evm_db::db_find_i64(code, _scope, EVM_ACCOUNT_STATE_TABLE.value, primary);
+                eosio::check(itr >= 0, "eosio.evm accountstate row missing for an indexed key");
+
+                uint8_t row[ACCOUNT_STATE_ROW_SIZE];
+                int32_t size = evm_db::db_get_i64(itr, row, sizeof(row));
+                eosio::check(size == static_cast<int32_t>(sizeof(row)), "Unexpected eosio.evm accountstate row size");
+                std::memcpy(value.data(), row + ACCOUNT_STATE_VALUE_OFFSET, 32);
+                return true;
+            }
+
+            uint64_t scope() const { return _scope; }
+
+        private:
+            bool findKey(const eosio::checksum256& key, uint64_t& primary) const {
+                const uint64_t code = eosio::name(EVM_SYSTEM_CONTRACT).value;
+                return evm_db::db_idx256_find_secondary(code, _scope, EVM_ACCOUNT_STATE_BYKEY,
+                                                        key.get_array().data(), 2, &primary) >= 0;
+            }
+
+            uint64_t _scope;
+    };
+}
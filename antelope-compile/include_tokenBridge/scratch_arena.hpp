@@ -0,0 +1,112 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace evm_bridge;
+
+// Capacity of the per-action scratch arena. One action needs a few hundred bytes of calldata
+// plus the RLP transaction and key buffers, anything above the capacity falls back to the heap.
+#ifndef SCRATCH_ARENA_BYTES
+#define SCRATCH_ARENA_BYTES 8192
+#endif
+
+namespace evm_bridge
+{
+  // Bump allocator for the short-lived buffers of one action (calldata, RLP, hex strings).
+  // Memory is handed back by releasing to a mark (scratch_scope), a single free only returns
+  // bytes when it is the last allocation, which covers vector growth.
+  class scratch_arena {
+    public:
+      void* allocate(size_t bytes, size_t align) {
+        size_t start = (_used + align - 1) & ~(align - 1);
+        if (start + bytes > SCRATCH_ARENA_BYTES) {
+          _overflows++;
+          return ::operator new(bytes);
+        }
+        _used = start + bytes;
+        if (_used > _peak) _peak = _used;
+        return _buffer + start;
+      }
+
+      void deallocate(void* p, size_t bytes) {
+        if (!owns(p)) {
+          ::operator delete(p);
+          return;
+        }
+        if (static_cast<uint8_t*>(p) + bytes == _buffer + _used) _used -= bytes;
+      }
+
+      bool owns(const void* p) const {
+        return p >= _buffer && p < _buffer + SCRATCH_ARENA_BYTES;
+      }
+
+      size_t mark() const { return _used; }
+      void release(size_t mark) { _used = mark; }
+
+      size_t peak() const { return _peak; }
+      uint32_t overflows() const { return _overflows; }
+
+    private:
+      alignas(16) uint8_t _buffer[SCRATCH_ARENA_BYTES] = {};
+      size_t _used = 0;
+      size_t _peak = 0;
+      uint32_t _overflows = 0;
+  };
+
+  // Zero initialized, lives in .bss so it does not add data segment bytes to the wasm
+  inline scratch_arena SCRATCH;
+
+  template<typename T>
+  struct scratch_allocator {
+    using value_type = T;
+
+    scratch_allocator() = default;
+    template<typename U> scratch_allocator(const scratch_allocator<U>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(SCRATCH.allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T* p, size_t n) { SCRATCH.deallocate(p, n * sizeof(T)); }
+
+    template<typename U> bool operator==(const scratch_allocator<U>&) const { return true; }
+    template<typename U> bool operator!=(const scratch_allocator<U>&) const { return false; }
+  };
+
+  using scratch_bytes = std::vector<uint8_t, scratch_allocator<uint8_t>>;
+  using scratch_string = std::basic_string<char, std::char_traits<char>, scratch_allocator<char>>;
+
+  // Packs like std::vector<uint8_t> / bytes, so a scratch buffer can go straight into action data
+  template<typename DataStream>
+  DataStream& operator<<(DataStream& ds, const scratch_bytes& v) {
+    ds << eosio::unsigned_int(static_cast<uint32_t>(v.size()));
+    ds.write(reinterpret_cast<const char*>(v.data()), v.size());
+    return ds;
+  }
+
+  // Releases everything allocated in the arena since it was opened, one per action.
+  // With -D BRIDGE_MEMORY_PROFILE it also prints the memory pages and arena peak of the action
+  // to the console (see profileTokenBridge.sh).
+  class scratch_scope {
+    public:
+      explicit scratch_scope(const char* label) : _label(label), _mark(SCRATCH.mark()) {}
+
+      ~scratch_scope() {
+#ifdef BRIDGE_MEMORY_PROFILE
+        eosio::print("[mem] ", _label, " pages=", static_cast<uint32_t>(__builtin_wasm_memory_size(0)),
+                     " arena_peak=", static_cast<uint32_t>(SCRATCH.peak()),
+                     " arena_overflows=", SCRATCH.overflows(), "\n");
+#endif
+        SCRATCH.release(_mark);
+      }
+
+      scratch_scope(const scratch_scope&) = delete;
+      scratch_scope& operator=(const scratch_scope&) = delete;
+
+    private:
+      const char* _label;
+      size_t _mark;
+  };
+}
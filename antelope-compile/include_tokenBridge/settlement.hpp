@@ -0,0 +1,28 @@
+#pragma once
+#include <constants.hpp>
+
+using namespace std;
+using namespace eosio;
+using namespace evm_bridge;
+
+namespace evm_bridge {
+    //======================== Settlement events ========================
+    // What happened to a bridge transfer, returned by reqnotify / verifytrx and logged by logsettle
+    enum settle_outcome : uint8_t {
+        SETTLE_BRIDGED  = 1,    // native -> EVM transfer sent to TokenBridge.sol
+        SETTLE_NOTIFIED = 2,    // EVM -> native request registered, success callback sent to the EVM
+        SETTLE_RELEASED = 3,    // EVM -> native request paid out on the native side
+        SETTLE_QUEUED   = 4     // native -> EVM transfer queued, SETTLE_BRIDGED follows when it is flushed
+    };
+
+    struct settlement {
+        uint64_t request_id;            // EVM request id, 0 for native -> EVM (assigned by TokenBridge.sol)
+        uint64_t amount;                // Native units
+        eosio::name receiver;           // Native receiver, or the native sender for SETTLE_BRIDGED
+        eosio::checksum160 evm_address; // EVM receiver for SETTLE_BRIDGED, empty otherwise
+        uint64_t evm_nonce;             // Nonce of the eosio.evm raw transaction sent, 0 if none was sent
+        uint8_t outcome;                // settle_outcome
+
+        EOSLIB_SERIALIZE(settlement, (request_id)(amount)(receiver)(evm_address)(evm_nonce)(outcome));
+    };
+}
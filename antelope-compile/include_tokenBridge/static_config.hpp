@@ -0,0 +1,44 @@
+#pragma once
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+#include <decimal_scaler.hpp>
+#include <tables.hpp>
+
+// Deployment profile of the bridge config.
+// With -D BRIDGE_STATIC_CONFIG (STATIC_CONFIG=mainnet|testnet ./buildTokenBridge.sh) the fields that
+// never change once the contract is locked are baked into the wasm from config.toml through the
+// generated bridge_static_config.hpp, and the checks against them constant-fold. Without it they
+// are read from the bridgeconfig singleton as before.
+#ifdef BRIDGE_STATIC_CONFIG
+#include <bridge_static_config.hpp>
+#endif
+
+namespace evm_bridge
+{
+#ifdef BRIDGE_STATIC_CONFIG
+    static_assert(STATIC_EVM_CHAIN_ID == 40 || STATIC_EVM_CHAIN_ID == 41, "Static profile chain id must be Telos EVM mainnet (40) or testnet (41)");
+    static_assert(STATIC_NATIVE_TOKEN_SYMBOL.is_valid(), "Static profile token symbol is not valid");
+    static_assert(STATIC_NATIVE_TOKEN_SYMBOL.precision() <= EVM_TOKEN_DECIMALS, "Static profile token precision is above the EVM decimals");
+    static_assert(STATIC_NATIVE_TOKEN_CONTRACT.value != 0, "Static profile token contract is empty");
+    static_assert(STATIC_FEES_CONTRACT.value != 0, "Static profile fees contract is empty");
+
+    static constexpr bool HAS_STATIC_CONFIG = true;
+    inline constexpr uint8_t evmChainId(const bridgeconfig&) { return STATIC_EVM_CHAIN_ID; }
+    inline constexpr eosio::symbol nativeTokenSymbol(const bridgeconfig&) { return STATIC_NATIVE_TOKEN_SYMBOL; }
+    inline constexpr eosio::name nativeTokenContract(const bridgeconfig&) { return STATIC_NATIVE_TOKEN_CONTRACT; }
+    inline constexpr eosio::name feesContract(const bridgeconfig&) { return STATIC_FEES_CONTRACT; }
+
+    // native -> EVM scale factor is a constant
+    inline decimal_scaler<STATIC_NATIVE_TOKEN_SYMBOL.precision(), EVM_TOKEN_DECIMALS> bridgeScaler(const bridgeconfig&) { return {}; }
+#else
+    static constexpr bool HAS_STATIC_CONFIG = false;
+    inline uint8_t evmChainId(const bridgeconfig& conf) { return conf.evm_chain_id; }
+    inline eosio::symbol nativeTokenSymbol(const bridgeconfig& conf) { return conf.native_token_symbol; }
+    inline eosio::name nativeTokenContract(const bridgeconfig& conf) { return conf.native_token_contract; }
+    inline eosio::name feesContract(const bridgeconfig& conf) { return conf.fees_contract; }
+
+    inline runtime_decimal_scaler bridgeScaler(const bridgeconfig& conf) {
+        return runtime_decimal_scaler(conf.native_token_symbol.precision(), EVM_TOKEN_DECIMALS);
+    }
+#endif
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <constants.hpp>
+#include <settled_ledger.hpp>
 
 using namespace std;
 using namespace eosio;
@@ -16,13 +17,14 @@ namespace evm_bridge {
         name receiver;
         std::string sender;
         std::string memo;
+        eosio::binary_extension<time_point> notified_at; // When reqnotify registered the request (rows created before this field have none)
 
         uint64_t primary_key() const { return request_id; }
         uint64_t by_processed() const { return processed; }
         uint64_t by_timestamp() const { return static_cast<uint64_t>(timestamp.elapsed.to_seconds()); }
 
         EOSLIB_SERIALIZE(requests, (request_id)(timestamp)(processed)
-                                   (amount)(receiver)(sender)(memo));
+                                   (amount)(receiver)(sender)(memo)(notified_at));
     };
     
     // multi_index with primary key and secondary index on processed
@@ -31,6 +33,23 @@ namespace evm_bridge {
        eosio::indexed_by<"timestamp"_n, eosio::const_mem_fun<requests, uint64_t, &requests::by_timestamp>>
     > requests_table;
 
+    // Positions of the requests_table indexes, for table_cursor
+    static constexpr uint8_t REQUESTS_INDEX_PROCESSED = 0;
+    static constexpr uint8_t REQUESTS_INDEX_TIMESTAMP = 1;
+
+    // Settled request ids, 64 per row (settled_ledger.hpp). settle erases the request row and sets
+    // its bit here, so replayed ids are refused for good without keeping the rows around
+    struct [[eosio::table, eosio::contract(BRIDGE_CONTRACT_NAME)]] settledids {
+        uint64_t word_index;            // request_id / 64
+        uint64_t bits;                  // bit request_id % 64 set once settled
+
+        uint64_t primary_key() const { return word_index; }
+
+        EOSLIB_SERIALIZE(settledids, (word_index)(bits));
+    };
+
+    typedef eosio::multi_index<"settledids"_n, settledids> settled_ids_table;
+
     // Config
     struct [[eosio::table, eosio::contract(BRIDGE_CONTRACT_NAME)]] bridgeconfig {
         eosio::checksum160 evm_bridge_address;
@@ -41,10 +60,111 @@ namespace evm_bridge {
         eosio::name native_token_contract;
         eosio::name fees_contract;
         bool is_locked = false;
+        eosio::binary_extension<uint8_t> request_layout; // request_layout of TokenBridge.sol (bridge_storage.hpp), v1 when not set
+        eosio::binary_extension<uint8_t> bridge_protocol; // bridgeTo calldata format (BRIDGE_PROTOCOL_V1 / V2), v1 when not set
 
-        EOSLIB_SERIALIZE(bridgeconfig, (evm_bridge_address)(evm_bridge_scope)(evm_token_address)(evm_chain_id)(native_token_symbol)(native_token_contract)(fees_contract)(is_locked));
+        uint8_t get_request_layout() const { return request_layout.value_or(REQUEST_LAYOUT_V1); }
+        uint8_t get_bridge_protocol() const { return bridge_protocol.value_or(BRIDGE_PROTOCOL_V1); }
+
+        EOSLIB_SERIALIZE(bridgeconfig, (evm_bridge_address)(evm_bridge_scope)(evm_token_address)(evm_chain_id)(native_token_symbol)(native_token_contract)(fees_contract)(is_locked)(request_layout)(bridge_protocol));
     } config_row;
 
     // singleton with primary key bridgeconfig
     typedef singleton<"bridgeconfig"_n, bridgeconfig> config_singleton_bridge;
+
+    // Native -> EVM transfers waiting for the next bridgeToBatch (queued mode), oldest first
+    struct [[eosio::table, eosio::contract(BRIDGE_CONTRACT_NAME)]] bridgequeue {
+        uint64_t id;
+        eosio::checksum160 receiver;    // EVM receiver
+        uint64_t amount;                // native units
+        eosio::name sender;
+        time_point_sec queued_at;
+
+        uint64_t primary_key() const { return id; }
+
+        EOSLIB_SERIALIZE(bridgequeue, (id)(receiver)(amount)(sender)(queued_at));
+    };
+
+    typedef eosio::multi_index<"bridgequeue"_n, bridgequeue> bridge_queue_table;
+
+    // Queued mode settings and the queue bookkeeping, so `bridge` checks the triggers without a scan
+    struct [[eosio::table, eosio::contract(BRIDGE_CONTRACT_NAME)]] batchconfig {
+        bool enabled = false;           // `bridge` queues transfers instead of sending one EVM transaction each
+        uint32_t max_batch = 0;         // `bridge` flushes once this many transfers are queued, 0 = only flush
+        uint32_t max_age_sec = 0;       // `bridge` flushes once the oldest transfer waited this long, 0 = no age trigger
+        uint64_t next_id = 0;
+        uint32_t queued = 0;
+
+        EOSLIB_SERIALIZE(batchconfig, (enabled)(max_batch)(max_age_sec)(next_id)(queued));
+    };
+
+    typedef singleton<"batchconfig"_n, batchconfig> batch_singleton;
+
+    // Token bucket of the throughput governor (include_common/token_bucket.hpp)
+    struct bucket_state {
+        uint64_t level = 0;             // 1/BUCKET_UNITS_PER_TOKEN tokens
+        uint32_t updated_at = 0;        // unix seconds, 0 = never used (full)
+
+        EOSLIB_SERIALIZE(bucket_state, (level)(updated_at));
+    };
+
+    // Throughput governor (setgovernor), taken before the state reads of `bridge` and reqnotify so a
+    // burst of small transfers is refused for one singleton read. `bridge` only comes from the fees
+    // contract and takes from the to-EVM bucket (xsend.boid governs each native account), reqnotify
+    // from the to-native bucket and from the bucket of the EVM sender's slot
+    struct [[eosio::table, eosio::contract(BRIDGE_CONTRACT_NAME)]] governor {
+        uint32_t to_evm_burst = 0;              // 0 = no limit
+        uint32_t to_evm_per_hour = 0;
+        uint32_t to_native_burst = 0;
+        uint32_t to_native_per_hour = 0;
+        uint32_t sender_burst = 0;              // per EVM sender of a request
+        uint32_t sender_per_hour = 0;
+        bucket_state to_evm;
+        bucket_state to_native;
+        std::vector<bucket_state> senders;      // GOVERNOR_SLOTS buckets, by governorSlot(addressKey(sender))
+
+        bucket_limits to_evm_limits() const { return {to_evm_burst, to_evm_per_hour}; }
+        bucket_limits to_native_limits() const { return {to_native_burst, to_native_per_hour}; }
+        bucket_limits sender_limits() const { return {sender_burst, sender_per_hour}; }
+
+        bucket_state& sender_bucket(const uint8_t* address) {
+            senders.resize(GOVERNOR_SLOTS);
+            return senders[governorSlot(addressKey(address))];
+        }
+
+        EOSLIB_SERIALIZE(governor, (to_evm_burst)(to_evm_per_hour)(to_native_burst)(to_native_per_hour)(sender_burst)
+                                   (sender_per_hour)(to_evm)(to_native)(senders));
+    };
+
+    typedef singleton<"governor"_n, governor> governor_singleton;
+
+    // Latency histogram buckets, upper bound of each bucket in seconds (the last one catches everything above)
+    static constexpr uint32_t LATENCY_BUCKET_BOUNDS[] = {10, 30, 60, 120, 300, 600, 1800, 3600, 7200, 21600, 86400};
+    static constexpr uint8_t LATENCY_BUCKETS = sizeof(LATENCY_BUCKET_BOUNDS) / sizeof(LATENCY_BUCKET_BOUNDS[0]) + 1;
+
+    inline uint8_t latencyBucket(int64_t seconds) {
+        uint8_t bucket = 0;
+        while (bucket < LATENCY_BUCKETS - 1 && seconds > LATENCY_BUCKET_BOUNDS[bucket]) bucket++;
+        return bucket;
+    }
+
+    // Telemetry, updated on every bridge / reqnotify / verifytrx so monitoring reads a single row
+    struct [[eosio::table, eosio::contract(BRIDGE_CONTRACT_NAME)]] bridgestats {
+        uint64_t to_evm_count = 0;          // bridge transfers sent to the EVM
+        uint64_t to_evm_volume = 0;         // native units
+        uint64_t to_native_notified = 0;    // EVM requests registered by reqnotify
+        uint64_t to_native_released = 0;    // requests paid out by verifytrx
+        uint64_t to_native_volume = 0;      // native units released
+        uint64_t gas_limit_spent = 0;       // sum of the gas limits of the EVM transactions sent
+        uint32_t pending_count = 0;         // registered but not released
+        time_point oldest_pending;          // EVM requested_at of the oldest pending request
+        std::vector<uint32_t> notify_latency; // requested_at -> reqnotify, LATENCY_BUCKETS buckets
+        std::vector<uint32_t> settle_latency; // reqnotify -> verifytrx, LATENCY_BUCKETS buckets
+
+        EOSLIB_SERIALIZE(bridgestats, (to_evm_count)(to_evm_volume)(to_native_notified)(to_native_released)
+                                      (to_native_volume)(gas_limit_spent)(pending_count)(oldest_pending)
+                                      (notify_latency)(settle_latency));
+    };
+
+    typedef singleton<"stats"_n, bridgestats> stats_singleton;
 }
\ No newline at end of file
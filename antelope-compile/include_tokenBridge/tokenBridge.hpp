@@ -11,19 +11,37 @@
 #include <eosio/asset.hpp>
 #include <eosio/system.hpp>
 
+// STD
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
 // EXTERNAL
+// Only what the contract calls is compiled in: intx for 256 bit math, rlp for the EVM
+// transactions and keccak for the storage keys (no uECC / boost, they only added wasm bytes)
 #include <intx/base.hpp>
 #include <rlp/rlp.hpp>
-#include <ecc/uECC.c>
 #include <keccak256/k.c>
-#include <boost/multiprecision/cpp_int.hpp>
 
 // TELOS EVM
 #include <constants.hpp>
+#include <hex_codec.hpp>
+#include <eip55.hpp>
+#include <u256_kernels.hpp>
+#include <scratch_arena.hpp>
 #include <evm_util.hpp>
+#include <decimal_scaler.hpp>
 #include <datastream.hpp>
 #include <evm_tables.hpp>
+#include <evm_views.hpp>
+#include <token_bucket.hpp>
 #include <tables.hpp>
+#include <table_cursor.hpp>
+#include <static_config.hpp>
+#include <settlement.hpp>
+#include <request_preflight.hpp>
+#include <views.hpp>
 
 using namespace std;
 using namespace eosio;
@@ -56,12 +74,21 @@ namespace evm_bridge
                       bool is_locked = false
               );
 
+            // set the Request storage layout of the deployed TokenBridge.sol (REQUEST_LAYOUT_V1 / REQUEST_LAYOUT_V2)
+            [[eosio::action]] void setreqlayout(uint8_t layout);
+
+            // set the bridgeTo calldata `bridge` sends (BRIDGE_PROTOCOL_V1 / BRIDGE_PROTOCOL_V2, needs bridgeToV2 on TokenBridge.sol)
+            [[eosio::action]] void setprotocol(uint8_t version);
+
             //======================== Token bridge actions ========================
             // Notifies Antelope of a bridge request in EVM and gets it ready for processing
-            [[eosio::action]] void reqnotify(uint64_t req_id);
+            [[eosio::action]] settlement reqnotify(uint64_t req_id);
 
             // Verify that a request is still present on the EVM if not release the funds
-            [[eosio::action]] void verifytrx(uint64_t req_id);
+            [[eosio::action]] settlement verifytrx(uint64_t req_id);
+
+            // Same as verifytrx, sent inline by reqnotify so a transfer settles in one transaction
+            [[eosio::action]] settlement finalize(uint64_t req_id);
 
             // Bridge to EVM
             [[eosio::on_notify("*::transfer")]] void bridge(eosio::name from, eosio::name to, eosio::asset quantity, std::string memo);
@@ -69,13 +96,74 @@ namespace evm_bridge
             // Remove a request from the table
             [[eosio::action]] void rmreq(uint64_t req_id);
 
-            // calls an action on the EVM to refund stuck requests
-            [[eosio::action]] void refstuckreq();
+            // moves up to max processed rows left by builds before the settledids ledger into the ledger
+            [[eosio::action]] void drainproc(uint32_t max);
+
+            // calls an action on the EVM to refund stuck requests among count active requests from start
+            // (RECOVERY_CURSOR continues from where the previous call stopped)
+            [[eosio::action]] void refstuckreq(uint64_t start, uint32_t count);
 
-            // calls an action on the EVM to clear failed requests
-            [[eosio::action]] void clrfailedreq();
+            // calls an action on the EVM to clear failed requests among count active requests from start
+            [[eosio::action]] void clrfailedreq(uint64_t start, uint32_t count);
 
             // calls an action on the EVM to remove a request
             [[eosio::action]] void rmreqonevm(uint64_t req_id);
+
+            // queued mode of `bridge`: transfers are kept in bridgequeue and sent together by flush,
+            // which `bridge` also runs once max_batch transfers are queued or the oldest is max_age_sec old
+            [[eosio::action]] void setbatch(bool enabled, uint32_t max_batch, uint32_t max_age_sec);
+
+            // sends up to max queued transfers in one bridgeToBatch call, anyone can flush a queue that is due
+            [[eosio::action]] void flush(uint32_t max);
+
+            // throughput governor: token buckets of burst actions refilled per_hour, for `bridge` (to EVM),
+            // reqnotify (to native) and each EVM sender of a request, a burst of 0 turns a bucket off
+            [[eosio::action]] void setgovernor(uint32_t to_evm_burst, uint32_t to_evm_per_hour, uint32_t to_native_burst,
+                                               uint32_t to_native_per_hour, uint32_t sender_burst, uint32_t sender_per_hour);
+
+            //======================== Read-only queries ========================
+            // Pending (not yet released) requests with id >= cursor, at most limit rows
+            [[eosio::action, eosio::read_only]] pending_page getpending(uint64_t cursor, uint32_t limit);
+
+            // Requests by id, ids that are not in the table are left out
+            [[eosio::action, eosio::read_only]] std::vector<request_view> getreq(const std::vector<uint64_t>& ids);
+
+            //======================== Events ========================
+            // No-op, only there so settlements show up in the action traces
+            [[eosio::action]] void logsettle(const settlement& s);
+
+        private:
+            // Checks the request is gone from the EVM storage, pays it out, erases its row and records the id in settledids
+            settlement settle(uint64_t req_id);
+
+            // settledids lookups, one row read per call
+            bool is_settled(uint64_t req_id);
+            void mark_settled(uint64_t req_id);
+
+            // Sends logsettle inline and returns the settlement for the action return value
+            settlement emit_settlement(const settlement& s);
+
+            // Sends a paged recovery call (selector(start, count)) to TokenBridge.sol with a gas limit scaled to count
+            void send_recovery(const char* selector, uint64_t start, uint32_t count, uint64_t gas_per_request);
+
+            // Read-modify-write of the stats singleton
+            template<typename F>
+            void update_stats(F&& update) {
+                stats_singleton stats(get_self(), get_self().value);
+                bridgestats s = stats.get_or_default();
+                s.notify_latency.resize(LATENCY_BUCKETS);
+                s.settle_latency.resize(LATENCY_BUCKETS);
+                update(s);
+                stats.set(s, get_self());
+            }
+
+            // EVM requested_at of the first pending request in the processed index, 0 if none
+            time_point oldest_pending(requests_table& requests);
+
+            // True once the queue reached max_batch transfers or its oldest transfer max_age_sec
+            bool batch_due(const batchconfig& batch);
+
+            // Sends the oldest max queued transfers with bridgeToBatch, returns how many were sent
+            uint32_t flush_queue(uint32_t max);
     };
 }
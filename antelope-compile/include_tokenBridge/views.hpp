@@ -0,0 +1,33 @@
+#pragma once
+#include <tables.hpp>
+
+using namespace std;
+using namespace eosio;
+using namespace evm_bridge;
+
+namespace evm_bridge {
+    //======================== Read-only query results ========================
+    // Compact request row, without the sender / memo strings
+    struct request_view {
+        uint64_t request_id;
+        uint32_t timestamp;     // Seconds since epoch
+        bool processed;
+        uint64_t amount;
+        eosio::name receiver;
+
+        EOSLIB_SERIALIZE(request_view, (request_id)(timestamp)(processed)(amount)(receiver));
+    };
+
+    // One page of getpending, pass next_cursor back to get the following page
+    struct pending_page {
+        std::vector<request_view> rows;
+        uint64_t next_cursor;   // Request id to resume from, only valid if more is set
+        bool more;
+
+        EOSLIB_SERIALIZE(pending_page, (rows)(next_cursor)(more));
+    };
+
+    inline request_view make_request_view(const requests& r) {
+        return request_view{r.request_id, r.timestamp.sec_since_epoch(), r.processed, r.amount, r.receiver};
+    }
+}
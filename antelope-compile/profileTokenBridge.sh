@@ -0,0 +1,78 @@
+#!/bin/bash
+
+# Builds the token bridge contract with every optimization profile and compares them:
+#  - wasm bytes by section / function (antelope-tools wasmsize)
+#  - optionally the first (instantiation) and second (warm) action latency on a local chain
+#
+# Latency needs a running nodeos + keosd reachable through cleos and a test account that can
+# take the contract code:
+#   PROFILE_ACCOUNT=bridgetest PROFILE_ACTION=init PROFILE_DATA='[...]' ./profileTokenBridge.sh
+#
+# MEMORY_PROFILE=1 builds with -D BRIDGE_MEMORY_PROFILE and adds the "[mem]" console lines of the
+# latency run (memory pages and scratch arena peak per action) to the report.
+
+CONFIG_FILE="./../config.toml"
+WASMSIZE="../antelope-tools/build/wasmsize"
+PROFILE_DIR="./build/profiles"
+PROFILES=${PROFILES:-"size speed"}
+CLEOS=${CLEOS:-cleos}
+
+BRIDGE_CONTRACT_NAME=$(yq eval '.Native_contracts.BRIDGE_CONTRACT_NAME' "$CONFIG_FILE")
+if [ -z "$BRIDGE_CONTRACT_NAME" ] || [ "$BRIDGE_CONTRACT_NAME" == "null" ]; then
+  echo "Error: BRIDGE_CONTRACT_NAME not found or empty in $CONFIG_FILE!"
+  exit 1
+fi
+
+if [ ! -x "$WASMSIZE" ]; then
+  echo ">>> Building wasmsize..."
+  (cd ../antelope-tools && ./buildTools.sh wasmsize) || exit 1
+fi
+
+mkdir -p "$PROFILE_DIR"
+REPORT="$PROFILE_DIR/report.txt"
+: > "$REPORT"
+
+# Keep the currently deployed build as the reference point
+BASELINE="./build/$BRIDGE_CONTRACT_NAME.wasm"
+
+for PROFILE in $PROFILES; do
+  BUILD_PROFILE=$PROFILE OUTPUT_DIR="$PROFILE_DIR/$PROFILE" MEMORY_PROFILE=$MEMORY_PROFILE ./buildTokenBridge.sh || exit 1
+  WASM="$PROFILE_DIR/$PROFILE/$BRIDGE_CONTRACT_NAME.wasm"
+
+  echo "==================== $PROFILE ====================" >> "$REPORT"
+  if [ -f "$BASELINE" ]; then
+    echo "--- $BASELINE -> $WASM" >> "$REPORT"
+    $WASMSIZE --compare "$BASELINE" "$WASM" >> "$REPORT"
+    echo >> "$REPORT"
+  fi
+  $WASMSIZE --top 25 "$WASM" >> "$REPORT"
+  echo >> "$REPORT"
+done
+
+# First action after setcode pays for instantiation, the second one runs on the cached module
+if [ -n "$PROFILE_ACCOUNT" ]; then
+  PROFILE_ACTION=${PROFILE_ACTION:-init}
+  if [ -z "$PROFILE_DATA" ]; then
+    echo "Error: PROFILE_DATA must hold the JSON arguments of $PROFILE_ACTION"
+    exit 1
+  fi
+
+  echo "==================== latency ($PROFILE_ACTION) ====================" >> "$REPORT"
+  printf "%-10s %12s %12s %12s %12s\n" "profile" "first us" "first cpu" "warm us" "warm cpu" >> "$REPORT"
+  for PROFILE in $PROFILES; do
+    $CLEOS set contract "$PROFILE_ACCOUNT" "$PROFILE_DIR/$PROFILE" "$BRIDGE_CONTRACT_NAME.wasm" "$BRIDGE_CONTRACT_NAME.abi" -p "$PROFILE_ACCOUNT@active" > /dev/null || exit 1
+    # let the setcode land in a block so the next action instantiates the new code
+    sleep 1
+    FIRST=$($CLEOS push action "$PROFILE_ACCOUNT" "$PROFILE_ACTION" "$PROFILE_DATA" -p "$PROFILE_ACCOUNT@active" --json -f)
+    WARM=$($CLEOS push action "$PROFILE_ACCOUNT" "$PROFILE_ACTION" "$PROFILE_DATA" -p "$PROFILE_ACCOUNT@active" --json -f)
+    printf "%-10s %12s %12s %12s %12s\n" "$PROFILE" \
+      "$(echo "$FIRST" | jq '.processed.elapsed')" "$(echo "$FIRST" | jq '.processed.receipt.cpu_usage_us')" \
+      "$(echo "$WARM" | jq '.processed.elapsed')" "$(echo "$WARM" | jq '.processed.receipt.cpu_usage_us')" >> "$REPORT"
+    if [ -n "$MEMORY_PROFILE" ]; then
+      echo "$WARM" | jq -r '.processed.action_traces[] | .. | .console? // empty' | grep '^\[mem\]' | sed "s/^/  $PROFILE /" >> "$REPORT"
+    fi
+  done
+fi
+
+cat "$REPORT"
+echo ">>> Profile report written to $REPORT"
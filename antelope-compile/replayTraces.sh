@@ -0,0 +1,97 @@
+#!/bin/bash
+
+# Replays captured production traffic (antelope-tools tracereplay) against contract builds on a local
+# chain and compares every build with production:
+#   ./replayTraces.sh plan.tsv ./build/profiles/size ./build/profiles/speed
+#
+# plan.tsv comes from `tracereplay plan capture.bin`. Every build directory holds the
+# BRIDGE_CONTRACT_NAME and/or FEES_CONTRACT_NAME wasm + abi, whichever is there is deployed.
+#
+# The local chain must start from the state the capture started at (a snapshot of the start
+# block) with keys in keosd for the accounts that signed the captured transactions.
+# RESET_CMD is run before every build to put the chain back to that state, e.g.
+#   RESET_CMD='./restartLocalChain.sh snapshot-123456.bin' ./replayTraces.sh ...
+#
+# MAX_REGRESSION=<percent> makes the script fail when an action got more expensive than that.
+
+CONFIG_FILE="./../config.toml"
+TRACEREPLAY="../antelope-tools/build/tracereplay"
+REPLAY_DIR="./build/replay"
+CLEOS=${CLEOS:-cleos}
+
+PLAN=$1
+shift
+if [ -z "$PLAN" ] || [ ! -f "$PLAN" ] || [ $# -eq 0 ]; then
+  echo "usage: $0 <plan.tsv> <build dir>..."
+  exit 1
+fi
+
+BRIDGE_CONTRACT_NAME=$(yq eval '.Native_contracts.BRIDGE_CONTRACT_NAME' "$CONFIG_FILE")
+FEES_CONTRACT_NAME=$(yq eval '.Native_contracts.FEES_CONTRACT_NAME' "$CONFIG_FILE")
+if [ -z "$BRIDGE_CONTRACT_NAME" ] || [ "$BRIDGE_CONTRACT_NAME" == "null" ]; then
+  echo "Error: BRIDGE_CONTRACT_NAME not found or empty in $CONFIG_FILE!"
+  exit 1
+fi
+# Same accounts tracereplay fingerprints by default
+WATCHED="[\"$BRIDGE_CONTRACT_NAME\",\"$FEES_CONTRACT_NAME\"]"
+
+if [ ! -x "$TRACEREPLAY" ]; then
+  echo ">>> Building tracereplay..."
+  (cd ../antelope-tools && ./buildTools.sh tracereplay) || exit 1
+fi
+
+mkdir -p "$REPLAY_DIR"
+REPORT="$REPLAY_DIR/report.txt"
+: > "$REPORT"
+STATUS=0
+
+for BUILD in "$@"; do
+  NAME=$(basename "$BUILD")
+  RESULTS="$REPLAY_DIR/$NAME.tsv"
+  : > "$RESULTS"
+
+  if [ -n "$RESET_CMD" ]; then
+    eval "$RESET_CMD" || exit 1
+  fi
+  for CONTRACT in $BRIDGE_CONTRACT_NAME $FEES_CONTRACT_NAME; do
+    if [ -f "$BUILD/$CONTRACT.wasm" ]; then
+      $CLEOS set contract "$CONTRACT" "$BUILD" "$CONTRACT.wasm" "$CONTRACT.abi" -p "$CONTRACT@active" > /dev/null || exit 1
+    fi
+  done
+  # let the setcode land in a block so the replay runs on the new code
+  sleep 1
+
+  echo ">>> Replaying $(wc -l < "$PLAN") transactions on $NAME..."
+  # seq  block  trx_id  group  actions  status  cpu_us  elapsed_us  fingerprint
+  while IFS=$'\t' read -r SEQ BLOCK TRX GROUP ACTIONS REST; do
+    if OUT=$($CLEOS push transaction "{\"actions\":$ACTIONS}" --json -f 2>/dev/null); then
+      echo "$OUT" | jq -r --arg seq "$SEQ" --argjson watched "$WATCHED" '
+        [.processed.action_traces | sort_by(.action_ordinal)[] | select(.receiver as $r | $watched | index($r))
+          | "\(.receiver)/\(.act.account)/\(.act.name)/\(.return_value_hex_data // "")\(if .except then "!" else "" end)"]
+        | (if length == 0 then "-" else join(";") end) as $fp
+        | [$seq, "executed", .processed.receipt.cpu_usage_us, .processed.elapsed, $fp] | @tsv' >> "$RESULTS"
+    else
+      printf "%s\tfailed\t0\t0\t-\n" "$SEQ" >> "$RESULTS"
+    fi
+  done < "$PLAN"
+
+  echo "==================== $NAME vs production ====================" >> "$REPORT"
+  $TRACEREPLAY compare ${MAX_REGRESSION:+--max-regression $MAX_REGRESSION} "$PLAN" "$RESULTS" >> "$REPORT"
+  RESULT=$?
+  if [ $RESULT -ne 0 ] && [ $STATUS -eq 0 ]; then STATUS=$RESULT; fi
+  echo >> "$REPORT"
+done
+
+# With two builds also compare them directly (release candidate against the current one)
+if [ $# -eq 2 ]; then
+  BASE="$REPLAY_DIR/$(basename "$1").tsv"
+  CAND="$REPLAY_DIR/$(basename "$2").tsv"
+  echo "==================== $(basename "$1") -> $(basename "$2") ====================" >> "$REPORT"
+  $TRACEREPLAY compare ${MAX_REGRESSION:+--max-regression $MAX_REGRESSION} "$PLAN" "$BASE" "$CAND" >> "$REPORT"
+  RESULT=$?
+  if [ $RESULT -ne 0 ] && [ $STATUS -eq 0 ]; then STATUS=$RESULT; fi
+fi
+
+cat "$REPORT"
+echo ">>> Replay report written to $REPORT"
+exit $STATUS
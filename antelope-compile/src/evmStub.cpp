@@ -0,0 +1,241 @@
+// Stand-in for eosio.evm on a local chain (load tests, evm.boid development), no EVM runs.
+//
+// It keeps the `account`, `accountstate` and `config` tables of eosio.evm with the same layout,
+// so evm.boid reads it exactly like the real one:
+//  - `request` plays the part of a bridge() call on TokenBridge.sol: it stores a v2 Request
+//    (evm.boid needs `setreqlayout 2`) and adds it to activeRequestIds like TokenBridge.sol does
+//  - `raw` takes the transactions evm.boid sends: it checks and bumps the sender nonce, the
+//    requestSuccessful callback removes the Request, bridgeTo / bridgeToBatch / recovery calls
+//    are only accepted (nothing is minted on the EVM side)
+// Deploy it on the EVM_SYSTEM_CONTRACT account of the local chain, never on a public one.
+
+#include <eosio/eosio.hpp>
+#include <eosio/crypto.hpp>
+#include <eosio/system.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <intx/base.hpp>
+#include <rlp/rlp.hpp>
+#include <keccak256/k.c>
+
+#include <constants.hpp>
+#include <hex_codec.hpp>
+#include <evm_util.hpp>
+#include <datastream.hpp>
+#include <evm_tables.hpp>
+
+using namespace eosio;
+using namespace evm_bridge;
+
+class [[eosio::contract(EVM_SYSTEM_CONTRACT)]] evmstub : public contract {
+public:
+    using contract::contract;
+
+    // EVM account indexes of the two accounts the bridge uses, 0 is left free so a scope of 0 means "not found"
+    static constexpr uint64_t BRIDGE_ACCOUNT_INDEX = 1;
+    static constexpr uint64_t BRIDGE_CALLER_INDEX = 2;
+
+    //--------------------------------------------------------------------------
+    // ACTION: init
+    //
+    // Creates the config row (gas price), the TokenBridge.sol account with the token contract
+    // and symbol slots `bridge` checks, and the EVM account of bridge_account (evm.boid).
+    // token_symbol is the "4,BOID" form TokenBridge.sol stores.
+    //--------------------------------------------------------------------------
+    [[eosio::action]]
+    void init(checksum160 bridge_address, name bridge_account, checksum160 bridge_account_address,
+              name token_contract, std::string token_symbol, uint64_t gas_price) {
+        require_auth(get_self());
+        check(token_symbol.size() <= 32, "token_symbol must fit in a bytes32 slot");
+
+        evm_config_table config(get_self(), get_self().value);
+        check(config.begin() == config.end(), "Already initialized");
+        config.emplace(get_self(), [&](auto& c) {
+            c.trx_index = 0;
+            c.last_block = 0;
+            c.gas_used_block = 0;
+            c.gas_price = gas_price;
+            c.revision = 0;
+        });
+
+        account_table accounts(get_self(), get_self().value);
+        accounts.emplace(get_self(), [&](auto& a) {
+            a.index = BRIDGE_ACCOUNT_INDEX;
+            a.address = bridge_address;
+            a.nonce = 1;
+            a.code = {0x00}; // a contract account, the bytecode itself is never read
+            a.balance = 0;
+        });
+        accounts.emplace(get_self(), [&](auto& a) {
+            a.index = BRIDGE_CALLER_INDEX;
+            a.address = bridge_account_address;
+            a.account = bridge_account;
+            a.nonce = 0;
+            a.balance = 0;
+        });
+
+        setSlot(BRIDGE_ACCOUNT_INDEX, slotKey(STORAGE_BRIDGE_TOKEN_CONTRACT_INDEX), stringWord(token_contract.to_string()));
+        setSlot(BRIDGE_ACCOUNT_INDEX, slotKey(STORAGE_BRIDGE_TOKEN_SYMBOL_INDEX), stringWord(token_symbol));
+        setSlot(BRIDGE_ACCOUNT_INDEX, slotKey(NEXT_REQUEST_ID_SLOT), slotKey(1));
+    }
+
+    //--------------------------------------------------------------------------
+    // ACTION: request
+    //
+    // What TokenBridge.sol stores when an EVM user calls bridge(): a pending v2 Request for
+    // `amount` native units to `receiver`, the sender address is derived from `user`.
+    // Returns the request id.
+    //--------------------------------------------------------------------------
+    [[eosio::action]]
+    uint64_t request(name user, name receiver, uint64_t amount, std::string memo) {
+        require_auth(user);
+        check(amount > 0, "amount must be positive");
+        check(memo.size() <= 32, "memo must fit in a bytes32 slot");
+
+        const uint64_t scope = BRIDGE_ACCOUNT_INDEX;
+        const uint64_t id = wordToUint64(getSlot(scope, slotKey(NEXT_REQUEST_ID_SLOT)));
+        check(id > 0, "Not initialized");
+
+        // head: requested_at (uint32) | id (uint64) | sender (address), from the lowest byte up
+        storage_word head = {};
+        writeField(head, 0, 8, user.value);
+        writeField(head, 20, 8, id);
+        writeField(head, 28, 4, current_time_point().sec_since_epoch());
+        storage_word amount_word = {};
+        writeField(amount_word, 0, 8, amount);
+        writeField(amount_word, 8, 1, REQUEST_STATUS_PENDING);
+
+        const storage_word base = mappingKey(id, REQUESTS_MAPPING_SLOT);
+        setSlot(scope, addToKey(base, REQUEST_V2_SLOT_HEAD), head);
+        setSlot(scope, addToKey(base, REQUEST_V2_SLOT_AMOUNT), amount_word);
+        setSlot(scope, addToKey(base, REQUEST_V2_SLOT_RECEIVER), stringWord(receiver.to_string()));
+        setSlot(scope, addToKey(base, REQUEST_V2_SLOT_MEMO), stringWord(memo));
+
+        // activeRequestIds.push(id), activeRequestIndex[id] = position
+        const uint64_t active = wordToUint64(getSlot(scope, slotKey(ACTIVE_REQUEST_IDS_SLOT)));
+        setSlot(scope, arrayElementKey(ACTIVE_REQUEST_IDS_SLOT, active), slotKey(id));
+        setSlot(scope, mappingKey(id, ACTIVE_REQUEST_INDEX_SLOT), slotKey(active));
+        setSlot(scope, slotKey(ACTIVE_REQUEST_IDS_SLOT), slotKey(active + 1));
+        setSlot(scope, slotKey(NEXT_REQUEST_ID_SLOT), slotKey(id + 1));
+        return id;
+    }
+
+    //--------------------------------------------------------------------------
+    // ACTION: raw
+    //
+    // Same parameters as eosio.evm raw. The transaction is the unsigned legacy one evm.boid
+    // builds (encodeEvmCall): [nonce, gas_price, gas_limit, to, value, data, v, r, s].
+    //--------------------------------------------------------------------------
+    [[eosio::action]]
+    void raw(name from, const std::vector<int8_t>& rlptx, bool estimate_gas, std::optional<checksum160> sender) {
+        require_auth(from);
+        check(!estimate_gas, "estimate_gas is not supported by the stub");
+        check(sender.has_value(), "The stub only takes transactions with a sender");
+
+        const rlp::RLPValue tx = rlp::decode(rlptx);
+        check(tx.typ == rlp::RLPValue::VARR && tx.values.size() == 9, "Not a legacy transaction");
+
+        // The sender's nonce, like eosio.evm
+        account_table accounts(get_self(), get_self().value);
+        auto by_address = accounts.get_index<"byaddress"_n>();
+        auto caller = by_address.find(pad160(*sender));
+        check(caller != by_address.end(), "Unknown sender");
+        check(caller->nonce == bytesToUint64(tx.values[0].value), "Wrong nonce");
+        by_address.modify(caller, same_payer, [&](auto& a) { a.nonce++; });
+
+        // values[] directly, RLPValue::operator[] needs a NullRLPValue the library does not define
+        const std::vector<unsigned char>& to = tx.values[3].value;
+        const std::vector<unsigned char>& data = tx.values[5].value;
+        check(to.size() == 20, "Contract creation is not supported by the stub");
+        auto callee = by_address.find(pad160(checksum160(toArray20(to))));
+        check(callee != by_address.end() && !callee->code.empty(), "Call to an unknown contract");
+
+        // requestSuccessful(uint256): the request is done, TokenBridge.sol deletes it
+        if (data.size() == 4 + 32 && toHex(data.data(), 4) == EVM_SUCCESS_CALLBACK_SIGNATURE) {
+            storage_word id_word;
+            std::copy(data.begin() + 4, data.end(), id_word.begin());
+            removeRequest(callee->index, wordToUint64(id_word));
+        }
+    }
+
+private:
+    static storage_word stringWord(const std::string& text) {
+        storage_word word = {};
+        std::copy(text.begin(), text.begin() + std::min<size_t>(text.size(), word.size()), word.begin());
+        return word;
+    }
+
+    // Big-endian value of `len` bytes ending `low` bytes above the lowest byte (wordField in bridge_storage.hpp)
+    static void writeField(storage_word& word, uint8_t low, uint8_t len, uint64_t value) {
+        for (uint8_t i = 0; i < len; i++) {
+            word[31 - low - i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    static uint64_t bytesToUint64(const std::vector<unsigned char>& bytes) {
+        check(bytes.size() <= 8, "Integer does not fit 64 bits");
+        uint64_t value = 0;
+        for (unsigned char b : bytes) value = (value << 8) | b;
+        return value;
+    }
+
+    static std::array<uint8_t, 20> toArray20(const std::vector<unsigned char>& bytes) {
+        std::array<uint8_t, 20> out;
+        std::copy(bytes.begin(), bytes.end(), out.begin());
+        return out;
+    }
+
+    storage_word getSlot(uint64_t scope, const storage_word& key) {
+        account_state_table states(get_self(), scope);
+        auto by_key = states.get_index<"bykey"_n>();
+        auto itr = by_key.find(checksum256(key));
+        storage_word value = {};
+        if (itr != by_key.end()) intx::be::unsafe::store(value.data(), itr->value);
+        return value;
+    }
+
+    // A zero value removes the slot, eosio.evm does not store zero words
+    void setSlot(uint64_t scope, const storage_word& key, const storage_word& value) {
+        account_state_table states(get_self(), scope);
+        auto by_key = states.get_index<"bykey"_n>();
+        auto itr = by_key.find(checksum256(key));
+        const bool zero = value == storage_word{};
+        const uint256_t number = intx::be::unsafe::load<uint256_t>(value.data());
+        if (itr == by_key.end()) {
+            if (zero) return;
+            states.emplace(get_self(), [&](auto& s) {
+                s.index = states.available_primary_key();
+                s.key = checksum256(key);
+                s.value = number;
+            });
+        } else if (zero) {
+            by_key.erase(itr);
+        } else {
+            by_key.modify(itr, same_payer, [&](auto& s) { s.value = number; });
+        }
+    }
+
+    // delete requests[id] and swap-and-pop it out of activeRequestIds
+    void removeRequest(uint64_t scope, uint64_t id) {
+        const storage_word base = mappingKey(id, REQUESTS_MAPPING_SLOT);
+        check(getSlot(scope, addToKey(base, REQUEST_V2_SLOT_HEAD)) != storage_word{}, "Request not found");
+        for (uint8_t slot = 0; slot < REQUEST_V2_SLOT_COUNT; slot++) {
+            setSlot(scope, addToKey(base, slot), storage_word{});
+        }
+
+        const uint64_t length = wordToUint64(getSlot(scope, slotKey(ACTIVE_REQUEST_IDS_SLOT)));
+        const uint64_t position = wordToUint64(getSlot(scope, mappingKey(id, ACTIVE_REQUEST_INDEX_SLOT)));
+        check(length > 0 && wordToUint64(getSlot(scope, arrayElementKey(ACTIVE_REQUEST_IDS_SLOT, position))) == id,
+              "Request is not in activeRequestIds");
+        const uint64_t last = wordToUint64(getSlot(scope, arrayElementKey(ACTIVE_REQUEST_IDS_SLOT, length - 1)));
+        if (last != id) {
+            setSlot(scope, arrayElementKey(ACTIVE_REQUEST_IDS_SLOT, position), slotKey(last));
+            setSlot(scope, mappingKey(last, ACTIVE_REQUEST_INDEX_SLOT), slotKey(position));
+        }
+        setSlot(scope, arrayElementKey(ACTIVE_REQUEST_IDS_SLOT, length - 1), storage_word{});
+        setSlot(scope, mappingKey(id, ACTIVE_REQUEST_INDEX_SLOT), storage_word{});
+        setSlot(scope, slotKey(ACTIVE_REQUEST_IDS_SLOT), slotKey(length - 1));
+    }
+};
@@ -1,9 +1,19 @@
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
 #include <eosio/system.hpp>
+#include <eosio/singleton.hpp>
 #include "../include_feeForwarder/constants.hpp"
+#include <cstring>
 #include <map>
 
+// EVM address codec shared with the token bridge (keccak for the EIP-55 checksum)
+#include <keccak256/k.c>
+#include <eip55.hpp>
+#include <preflight.hpp>
+#include <table_cursor.hpp>
+#include <token_bucket.hpp>
+#include <optional>
+
 using namespace eosio;
 
 namespace token {
@@ -24,6 +34,17 @@ namespace token {
    }
 }
 
+// Result of the getfeestate read-only action
+struct fee_state {
+   name           user;
+   bool           has_fee;      // A fee record exists and has not expired
+   asset          paid;         // Fee recorded for the user (zero if none)
+   time_point_sec created_at;
+   time_point_sec expires_at;
+   asset          required_fee; // Fee currently set in the global config
+   bool           fee_matches;  // The recorded fee still matches the required fee
+};
+
 // FEES_CONTRACT_NAME is defined in the constants.hpp file
 class [[eosio::contract(FEES_CONTRACT_NAME)]] feeForwarder : public contract {
 public:
@@ -56,8 +77,7 @@ public:
             check(fee_token_symbol == fee.symbol, "Fee token symbol does not match the fee name");
             check(is_account(bridge_account), "Bridge account does not exist");
             check(is_account(fee_receiver), "Fee receiver account does not exist");
-            check(evm_memo.substr(0, 2) == "0x" && evm_memo.length() == 42, "Memo must be a valid Ethereum address (42 characters including '0x').");
-            check(std::all_of(evm_memo.begin() + 2, evm_memo.end(), ::isxdigit), "Memo must contain a valid EVM address in hexadecimal format.");
+            check_evm_address(evm_memo, "Memo must be a valid EVM address");
             check(fee.amount > 0, "Fee must be greater than zero");
 
             auto it = _global.find(GLOBAL_ID);
@@ -138,6 +158,32 @@ public:
         }
 
 
+        //--------------------------------------------------------------------------
+        // ACTION: setgovernor
+        //
+        // Throughput governor of the fee payments, token buckets of burst payments
+        // refilled per_hour (include_common/token_bucket.hpp):
+        // - burst / per_hour: all senders together
+        // - account_burst / account_per_hour: each native account
+        // A burst of 0 turns the bucket off.
+        //--------------------------------------------------------------------------
+        [[eosio::action]]
+        void setgovernor(uint32_t burst, uint32_t per_hour, uint32_t account_burst, uint32_t account_per_hour) {
+            require_auth(get_self());
+            // A bucket that never refills would stop bridging for good once emptied
+            check(burst == 0 || per_hour > 0, "per_hour must be set with burst");
+            check(account_burst == 0 || account_per_hour > 0, "account_per_hour must be set with account_burst");
+
+            // The bucket levels are kept, a lower burst cuts them down on their next take
+            governor_singleton governor_conf(get_self(), get_self().value);
+            governor_state gov = governor_conf.get_or_default();
+            gov.burst            = burst;
+            gov.per_hour         = per_hour;
+            gov.account_burst    = account_burst;
+            gov.account_per_hour = account_per_hour;
+            governor_conf.set(gov, get_self());
+        }
+
         //--------------------------------------------------------------------------
         // ACTION: claimrefund
         //
@@ -154,7 +200,7 @@ public:
 
             // Check for expiration (30 days here)
             time_point_sec now = time_point_sec(current_time_point());
-            check(now <= itr->created_at + seconds(2592000), "Refund has expired");
+            check(now <= itr->created_at + seconds(FEE_EXPIRY_SECONDS), "Refund has expired");
 
             // Return the fee
             asset refund_amount     = itr->amount;
@@ -171,6 +217,32 @@ public:
             idx.erase(itr);
         }
 
+        //--------------------------------------------------------------------------
+        // READ-ONLY ACTION: getfeestate
+        //
+        // Fee state of a user in one call: what was paid, when it expires and if
+        // it still matches the global fee (i.e. the next bridge transfer is accepted).
+        //--------------------------------------------------------------------------
+        [[eosio::action, eosio::read_only]]
+        fee_state getfeestate(name user) {
+            auto glob_itr = _global.find(GLOBAL_ID);
+            check(glob_itr != _global.end(), "Global config is not set. Admin must call setglobal first.");
+
+            fee_state state{user, false, asset(0, glob_itr->fee.symbol), time_point_sec(), time_point_sec(), glob_itr->fee, false};
+
+            auto idx = _fees.get_index<"byuser"_n>();
+            auto itr = idx.find(user.value);
+            if (itr == idx.end()) return state;
+
+            time_point_sec now = time_point_sec(current_time_point());
+            state.paid        = itr->amount;
+            state.created_at  = itr->created_at;
+            state.expires_at  = itr->created_at + seconds(FEE_EXPIRY_SECONDS);
+            state.has_fee     = now <= state.expires_at;
+            state.fee_matches = state.has_fee && itr->amount == glob_itr->fee;
+            return state;
+        }
+
         //--------------------------------------------------------------------------
         // NOTIFY HANDLER: on_transfer
         //
@@ -202,6 +274,9 @@ private:
     //--------------------------------------------------------------------------
     static constexpr uint64_t GLOBAL_ID = 0;
 
+    // Unused fee records can be refunded for 30 days, after that they are released to fee_receiver
+    static constexpr uint32_t FEE_EXPIRY_SECONDS = 2592000;
+
     struct [[eosio::table]] global_state {
         uint64_t id;
         asset    fee;                // Fee required to bridge
@@ -259,6 +334,89 @@ private:
     fee_record_table;
     fee_record_table _fees;
 
+    //--------------------------------------------------------------------------
+    // TABLE: throughput governor
+    //
+    // Token buckets taken by every fee payment before any other table read, so
+    // a burst of payments is refused for one singleton read instead of filling
+    // `fees` (and the bridge behind it). Accounts are hashed to one of
+    // GOVERNOR_SLOTS buckets, the state has a fixed size.
+    //--------------------------------------------------------------------------
+    struct bucket_state {
+        uint64_t level = 0;         // 1/BUCKET_UNITS_PER_TOKEN tokens
+        uint32_t updated_at = 0;    // unix seconds, 0 = never used (full)
+    };
+
+    struct [[eosio::table("governor")]] governor_state {
+        uint32_t burst = 0;                 // all senders, 0 = no limit
+        uint32_t per_hour = 0;
+        uint32_t account_burst = 0;         // per native account, 0 = no limit
+        uint32_t account_per_hour = 0;
+        bucket_state global;
+        std::vector<bucket_state> accounts; // GOVERNOR_SLOTS buckets, by governorSlot(account)
+    };
+    typedef singleton<"governor"_n, governor_state> governor_singleton;
+
+    //--------------------------------------------------------------------------
+    // check_evm_address
+    //
+    // Validates a "0x" prefixed EVM address in one pass. Mixed case addresses
+    // must match their EIP-55 checksum, all lower / upper case ones are accepted.
+    //--------------------------------------------------------------------------
+    void check_evm_address(const std::string& address, const char* error_prefix) {
+        evm_bridge::evm_address_bytes decoded;
+        evm_bridge::address_status status = evm_bridge::parseChecksummedAddress(address, decoded);
+        check(status == evm_bridge::ADDRESS_OK, std::string(error_prefix) + ": " + evm_bridge::addressStatusMessage(status));
+    }
+
+    //--------------------------------------------------------------------------
+    // Pre-flight checks
+    //
+    // The transfer handlers validate through include_common/preflight.hpp,
+    // the same functions clients run against their state mirror before they
+    // send a transfer. These map the rows to the views the checks take.
+    //--------------------------------------------------------------------------
+    static evm_bridge::transfer_view transfer_of(name token_contract, const asset& quantity) {
+        return {token_contract.value, quantity.amount, quantity.symbol.raw()};
+    }
+
+    std::optional<evm_bridge::fee_global_view> global_view(global_table::const_iterator it) const {
+        if (it == _global.end()) return std::nullopt;
+        return evm_bridge::fee_global_view{it->fee.amount, it->fee.symbol.raw(), it->fee_token_contract.value};
+    }
+
+    void check_preflight(evm_bridge::preflight_status status, const std::string& memo = std::string()) {
+        if (status == evm_bridge::PREFLIGHT_OK) return;
+        std::string message = evm_bridge::preflightMessage(status);
+        if (status == evm_bridge::PREFLIGHT_BAD_MEMO) {
+            evm_bridge::evm_address_bytes decoded;
+            message += std::string(": ") + evm_bridge::addressStatusMessage(evm_bridge::parseChecksummedAddress(memo, decoded));
+        }
+        check(false, message);
+    }
+
+    //--------------------------------------------------------------------------
+    // take_governed
+    //
+    // Takes a token from the global bucket and from the bucket of the account's
+    // slot, fails the transfer if either is empty.
+    //--------------------------------------------------------------------------
+    void take_governed(name account) {
+        governor_singleton governor_conf(get_self(), get_self().value);
+        governor_state gov = governor_conf.get_or_default();
+        if (gov.burst == 0 && gov.account_burst == 0) return;
+
+        const uint32_t now = current_time_point().sec_since_epoch();
+        check(evm_bridge::takeToken(gov.global, {gov.burst, gov.per_hour}, now),
+              evm_bridge::governorMessage(evm_bridge::GOVERNOR_GLOBAL_LIMIT));
+        if (gov.account_burst > 0) {
+            gov.accounts.resize(evm_bridge::GOVERNOR_SLOTS);
+            check(evm_bridge::takeToken(gov.accounts[evm_bridge::governorSlot(account.value)], {gov.account_burst, gov.account_per_hour}, now),
+                  std::string(evm_bridge::governorMessage(evm_bridge::GOVERNOR_SENDER_LIMIT)) + ": " + account.to_string());
+        }
+        governor_conf.set(gov, get_self());
+    }
+
     //--------------------------------------------------------------------------
     // handle_bridge_token_transfer
     //
@@ -269,24 +427,19 @@ private:
     //  - Then forward to the global_config.bridge_account
     //--------------------------------------------------------------------------
     void handle_bridge_token_transfer(name from, asset quantity, const std::string& memo, const token_config& config) {
-        // 1. Check the global config is set
+        // 1. Global config set, bridging checks and the user paid the bridging fee
         auto glob_itr = _global.find(GLOBAL_ID);
-        check(glob_itr != _global.end(), "Global config is not set. Please call setglobal first.");
-
-        // 2. Basic bridging checks
-        check(quantity.amount >= config.min_amount.amount, "Amount is below the minimum required for bridging");
-        check(memo.size() == 42 && memo.substr(0, 2) == "0x", "Memo must be a valid 42-char Ethereum address with '0x' prefix.");
-        check(std::all_of(memo.begin() + 2, memo.end(), ::isxdigit), "Memo must be a valid hex string (after '0x').");
-        check(get_first_receiver() == config.token_contract, "Invalid token contract for this bridging token");
-        check(quantity.symbol == config.token_symbol, "Mismatched token symbol for bridging token");
-
-        // 3. Verify the user paid the bridging fee
         auto fee_idx = _fees.get_index<"byuser"_n>();
         auto fee_itr = fee_idx.find(from.value);
-        check(fee_itr != fee_idx.end(), "No valid fee record found. Ensure you send the required fee before bridging.");
-        check(fee_itr->amount == glob_itr->fee, "Fee record doesn't match the required bridging fee.");
-
-        // 4. Transfer the bridging token to the configured bridge_account
+        std::optional<evm_bridge::fee_global_view> global = global_view(glob_itr);
+        std::optional<evm_bridge::fee_paid_view> fee;
+        if (fee_itr != fee_idx.end()) fee = evm_bridge::fee_paid_view{fee_itr->amount.amount, fee_itr->amount.symbol.raw()};
+        check_preflight(evm_bridge::preflightBridgeTransfer(
+            transfer_of(get_first_receiver(), quantity), memo,
+            {config.token_contract.value, config.token_symbol.raw(), config.min_amount.amount},
+            global ? &*global : nullptr, fee ? &*fee : nullptr), memo);
+
+        // 2. Transfer the bridging token to the configured bridge_account
         action(
             permission_level{get_self(), "active"_n},
             config.token_contract, // e.g., eosio.token or wherever
@@ -294,19 +447,20 @@ private:
             std::make_tuple(get_self(), glob_itr->bridge_account, quantity, memo)
         ).send();
 
-        // 5. Remove the fee record (it was used)
+        // 3. Remove the fee record (it was used)
         fee_idx.erase(fee_itr);
 
-        // 6. Cleanup expired fee records and auto-forward any released tokens.
+        // 4. Cleanup expired fee records and auto-forward any released tokens.
         asset contract_balance = token::get_balance(glob_itr->fee_token_contract, get_self(), glob_itr->fee_token_symbol.code());
         asset total_encumbered(0, glob_itr->fee_token_symbol);
         time_point_sec now = current_time_point();
-        for (auto itr = _fees.begin(); itr != _fees.end(); ) {
-            if (now > itr->created_at + seconds(2592000)) {
-                itr = _fees.erase(itr);
+        // Streamed with a cursor, the table is scanned on every bridge and multi_index would cache every row
+        for (evm_bridge::table_cursor<fee_record_table> cur(get_self(), get_self().value); cur.valid(); ) {
+            if (now > cur->created_at + seconds(FEE_EXPIRY_SECONDS)) {
+                cur.erase();
             } else {
-                total_encumbered += itr->amount;
-                ++itr;
+                total_encumbered += cur->amount;
+                cur.next();
             }
         }
         asset free_amount = contract_balance - total_encumbered;
@@ -329,21 +483,16 @@ private:
     //  - The amount must match the global fee exactly (no overpay)
     //--------------------------------------------------------------------------
     void handle_fee_transfer(name from, asset quantity) {
-        // 1. Check if a fee record already exists
-        auto fee_idx = _fees.get_index<"byuser"_n>();
-        auto fee_itr = fee_idx.find(from.value);
-        check(fee_itr == fee_idx.end(), "A fee is already recorded for this user. Use or claim the existing fee first.");
+        // 1. Throughput governor, all senders and then this account
+        take_governed(from);
 
-        // 2. Check global config
-        auto glob_itr = _global.find(GLOBAL_ID);
-        check(glob_itr != _global.end(), "Global config is not set. Admin must call setglobal first.");
-
-        // 3. Verify this is the correct fee token contract + correct fee amount
-        check(get_first_receiver() == glob_itr->fee_token_contract, "Invalid fee token contract.");
-        check(quantity.symbol == glob_itr->fee.symbol, "Incorrect fee token symbol.");
-        check(quantity == glob_itr->fee, "Fee amount is incorrect or overpayment not allowed.");
+        // 2. No fee recorded yet for this user, global config set, correct fee token contract + exact fee amount
+        auto fee_idx = _fees.get_index<"byuser"_n>();
+        std::optional<evm_bridge::fee_global_view> global = global_view(_global.find(GLOBAL_ID));
+        check_preflight(evm_bridge::preflightFeeTransfer(
+            transfer_of(get_first_receiver(), quantity), global ? &*global : nullptr, fee_idx.find(from.value) != fee_idx.end()));
 
-        // 4. Record the fee payment
+        // 3. Record the fee payment
         _fees.emplace(get_self(), [&](auto& row) {
             row.id             = _fees.available_primary_key();
             row.user           = from;
@@ -15,38 +15,68 @@
 
 namespace evm_bridge
 {
-   // define a type alias for its "bykey" iterator type:
-   using key_iterator_t = decltype(std::declval<account_state_table>().get_index<"bykey"_n>().begin());
-
-   struct KeyCheck {
-       const char* field_name;
-       key_iterator_t it;
-       eosio::checksum256 raw_key;
-
-       // explicit constructor
-       KeyCheck(const char* f, key_iterator_t i, const eosio::checksum256& r)
-           : field_name(f), it(i), raw_key(r) {}
-   };
-
-   template<typename IndexType>
-   void checkStorageKeys(const std::vector<evm_bridge::KeyCheck>& checks, const IndexType& index) {
-       std::vector<std::string> missing;
-       std::string error_msg = "Missing storage keys:";
-
-       for (const auto& check : checks) {
-           if (check.it == index.end()) {
-               missing.push_back(
-                   std::string("\n- ") + check.field_name + 
-                   " | Raw key: " + bin2hex(check.raw_key.extract_as_byte_array())
-               );
-           }
+   // "[key : value] " for every row of the bridge storage, only built for error messages
+   std::string describeStorageKeys(uint64_t scope) {
+       account_state_table states(eosio::name(EVM_SYSTEM_CONTRACT), scope);
+       auto index = states.get_index<"bykey"_n>();
+       std::string keys;
+       for (auto itr = index.begin(); itr != index.end(); ++itr) {
+           keys += "[" + bin2hex(itr->key.extract_as_byte_array()) + " : " + parseStringFromStorage(itr->value) + "] ";
        }
+       return keys;
+   }
+
+   // Pre-flight settings of reqnotify (include_common/request_preflight.hpp) from the bridge config
+   request_preflight_config requestPreflightConfig(const bridgeconfig& conf) {
+       request_preflight_config config;
+       config.layout = static_cast<request_layout>(conf.get_request_layout());
+       config.token_contract = nativeTokenContract(conf).to_string();
+       config.native_precision = nativeTokenSymbol(conf).precision();
+       return config;
+   }
 
-       if (!missing.empty()) {
-           for (const auto& msg : missing) error_msg += msg;
-           check(false, error_msg.c_str());
+   // check() message of a failed pre-flight: the shared message plus the values the check saw,
+   // only built on the failure path
+   std::string preflightError(preflight_status status, uint64_t req_id, const preflight_request& req, const bridgeconfig& conf) {
+       const std::string message = preflightMessage(status);
+       const std::string id = std::to_string(req_id);
+       const storage_word base_key = mappingKey(req_id, STORAGE_BRIDGE_REQUESTS_INDEX);
+       switch (status) {
+           case PREFLIGHT_REQUEST_MISSING:
+               return message + ": " + requestSlotName(static_cast<request_layout>(conf.get_request_layout()), req.missing_slot) +
+                   " of request ID " + id + " | Raw key: " + bin2hex(addToKey(base_key, req.missing_slot));
+           case PREFLIGHT_NOT_PENDING:
+               return message + ". Current status: " + std::to_string(req.status);
+           case PREFLIGHT_ID_MISMATCH:
+               return message + ": requested " + id + ", stored word " + bin2hex(req.stored_id);
+           case PREFLIGHT_BAD_DECIMALS:
+               return message + ": EVM decimals " + std::to_string(req.evm_decimals) + ", native precision " +
+                   std::to_string(nativeTokenSymbol(conf).precision());
+           case PREFLIGHT_PRECISION_LOSS:
+               return message + ". amountVal: " + intx::to_string(intx::be::unsafe::load<uint256_t>(req.raw_amount.data())) +
+                   ", EVM decimals: " + std::to_string(req.evm_decimals);
+           case PREFLIGHT_INVALID_AMOUNT:
+               return message + ": " + std::to_string(amountSlotAmount(req.raw_amount));
+           case PREFLIGHT_RECEIVER_TOO_LONG:
+               return message + ": " + std::to_string(req.receiver.length());
+           case PREFLIGHT_RECEIVER_INVALID:
+               return message + ": '" + req.receiver + "'";
+           case PREFLIGHT_STILL_ON_EVM:
+               return message + ": request ID " + id + ". Key: " + bin2hex(base_key);
+           default:
+               return message + ": request ID " + id;
        }
    }
+
+   // RLP of the unsigned legacy transaction eosio.evm's raw action expects (value 0, v = chain id, r = s = 0)
+   template<typename To>
+   scratch_bytes encodeEvmCall(uint64_t nonce, const uint256_t& gas_price, uint64_t gas_limit, const To& to,
+                               const scratch_bytes& data, uint8_t chain_id) {
+       scratch_bytes tx;
+       tx.reserve(data.size() + 96);
+       rlp::encode_to(tx, nonce, gas_price, gas_limit, to, uint256_t(0), data, chain_id, 0, 0);
+       return tx;
+   }
    //======================== Admin actions ==========================
     // Initialize the contract
     [[eosio::action]]
@@ -75,6 +105,14 @@ namespace evm_bridge
         check(native_token_contract != eosio::name(), "Invalid native_token_contract");
         check(fees_contract != eosio::name(), "Invalid fees_contract");
 
+        // A static profile build only works with the config it was built for
+        if (HAS_STATIC_CONFIG) {
+            check(evm_chain_id == evmChainId(stored), "evm_chain_id does not match the static config of this build");
+            check(native_token_symbol == nativeTokenSymbol(stored), "native_token_symbol does not match the static config of this build");
+            check(native_token_contract == nativeTokenContract(stored), "native_token_contract does not match the static config of this build");
+            check(fees_contract == feesContract(stored), "fees_contract does not match the static config of this build");
+        }
+
         stored.evm_bridge_address   = evm_bridge_address;
         stored.evm_token_address    = evm_token_address;
         stored.evm_chain_id         = evm_chain_id;
@@ -83,11 +121,10 @@ namespace evm_bridge
         stored.fees_contract        = fees_contract;
 
         // Get the scope
-        account_table accounts(eosio::name(EVM_SYSTEM_CONTRACT), eosio::name(EVM_SYSTEM_CONTRACT).value);
-        auto accounts_byaddress = accounts.get_index<"byaddress"_n>();
-        auto account_bridge = accounts_byaddress.find(pad160(evm_bridge_address));
+        // Only the fixed size head of the row is read, not the bytecode of the bridge contract
+        auto account_bridge = findEvmAccountByAddress(evm_bridge_address);
 
-        stored.evm_bridge_scope = (account_bridge != accounts_byaddress.end()) ? account_bridge->index : 0;
+        stored.evm_bridge_scope = account_bridge ? account_bridge->index : 0;
 
         // Lock the contract if specified
         if (is_locked) {
@@ -97,105 +134,113 @@ namespace evm_bridge
         config_bridge.set(stored, get_self());
     };
 
+    // Switch reqnotify to the Request layout of a newly deployed TokenBridge.sol
+    [[eosio::action]]
+    void tokenbridge::setreqlayout(uint8_t layout) {
+        require_auth(get_self());
+        check(layout == REQUEST_LAYOUT_V1 || layout == REQUEST_LAYOUT_V2, "Invalid request layout");
+
+        auto stored = config_bridge.get();
+        // v2 Requests hold the amount in native units as TokenBridge.sol scaled it for a 4 decimal token,
+        // reqnotify pays it out as is
+        check(layout != REQUEST_LAYOUT_V2 || nativeTokenSymbol(stored).precision() == TOKEN_BRIDGE_V2_PRECISION,
+              "Request layout v2 needs a native token precision of " + std::to_string(TOKEN_BRIDGE_V2_PRECISION));
+        stored.request_layout.emplace(layout);
+        config_bridge.set(stored, get_self());
+    }
+
+    // Switch the bridgeTo calldata, v2 once the TokenBridge.sol with bridgeToV2 is deployed
+    [[eosio::action]]
+    void tokenbridge::setprotocol(uint8_t version) {
+        require_auth(get_self());
+        check(version == BRIDGE_PROTOCOL_V1 || version == BRIDGE_PROTOCOL_V2, "Invalid bridge protocol version");
+
+        auto stored = config_bridge.get();
+        // bridgeToV2 takes native units and TokenBridge.sol scales them for a 4 decimal token, any other
+        // precision would mint the wrong amount on the EVM (v1 scales here with bridgeScaler)
+        check(version != BRIDGE_PROTOCOL_V2 || nativeTokenSymbol(stored).precision() == TOKEN_BRIDGE_V2_PRECISION,
+              "Bridge protocol v2 needs a native token precision of " + std::to_string(TOKEN_BRIDGE_V2_PRECISION));
+        // binary extensions are serialized in order, request_layout must be there before bridge_protocol
+        stored.request_layout.emplace(stored.get_request_layout());
+        stored.bridge_protocol.emplace(version);
+        config_bridge.set(stored, get_self());
+    }
+
     //======================== Token Bridge actions ========================
     // Trustless bridge to tEVM
     [[eosio::on_notify("*::transfer")]]
     void tokenbridge::bridge(eosio::name from, eosio::name to, eosio::asset quantity, std::string memo)
     {
+        scratch_scope scope("bridge");
+
         // Open config singleton
         auto conf = config_bridge.get();
-        
-        // Load the EVM system config via multi-index
-        evm_config_table evmconfig(eosio::name(EVM_SYSTEM_CONTRACT), eosio::name(EVM_SYSTEM_CONTRACT).value);
-        auto it = evmconfig.begin();
-        check(it != evmconfig.end(), "No config row found in eosio.evm's 'config' table");
-        auto evm_conf = *it;
 
-        // Gas
-        uint256_t gas_price_val = (evm_conf.gas_price * 11) / 10;
-        
         // Validate token symbol and contract
-        check(quantity.symbol == conf.native_token_symbol, "Token symbol does not match configured native token");
-        check(get_first_receiver() == conf.native_token_contract, "Contract does not match configured native token contract");
+        check(quantity.symbol == nativeTokenSymbol(conf), "Token symbol does not match configured native token");
+        check(get_first_receiver() == nativeTokenContract(conf), "Contract does not match configured native token contract");
 
         // Validate
         if(from == get_self()) return; // Return so we don't stop the transfer from this contract when bridging from tEVM
         check(to == get_self(), "Recipient is not this contract");
-        check(from == eosio::name(conf.fees_contract), "This account is not allowed to bridge tokens to EVM"); // Allow only fees contract to bridge tokens to EVM
-        check(memo.length() == 42, "Memo needs to contain the 42 character EVM recipient address");
+        check(from == feesContract(conf), "This account is not allowed to bridge tokens to EVM"); // Allow only fees contract to bridge tokens to EVM
+        evm_address_bytes receiver_address;
+        address_status memo_status = parseChecksummedAddress(memo, receiver_address);
+        check(memo_status == ADDRESS_OK, "Memo needs to contain the EVM recipient address: " + std::string(addressStatusMessage(memo_status)));
 
         // Check amount
-        uint256_t amount = uint256_t(quantity.amount);
-        check(amount >= 1, "Minimum amount is not reached");
+        check(quantity.amount >= 1, "Minimum amount is not reached");
+
+        // Throughput governor before the EVM state reads, a refused transfer costs one singleton read
+        // (after the sender checks, the payouts this contract sends are never governed)
+        governor_singleton governor_conf(get_self(), get_self().value);
+        governor gov = governor_conf.get_or_default();
+        if (gov.to_evm_burst > 0) {
+            check(takeToken(gov.to_evm, gov.to_evm_limits(), current_time_point().sec_since_epoch()), governorMessage(GOVERNOR_GLOBAL_LIMIT));
+            governor_conf.set(gov, get_self());
+        }
+
+        // Load the EVM system config via multi-index
+        evm_config_table evmconfig(eosio::name(EVM_SYSTEM_CONTRACT), eosio::name(EVM_SYSTEM_CONTRACT).value);
+        auto it = evmconfig.begin();
+        check(it != evmconfig.end(), "No config row found in eosio.evm's 'config' table");
+        auto evm_conf = *it;
+
+        // Gas
+        uint256_t gas_price_val = gasPriceWithMargin(evm_conf.gas_price);
 
         // Find the EVM account of this contract 
-        account_table _accounts(eosio::name(EVM_SYSTEM_CONTRACT), eosio::name(EVM_SYSTEM_CONTRACT).value);
-        auto accounts_byaccount = _accounts.get_index<"byaccount"_n>();
-        auto evm_account = accounts_byaccount.require_find(get_self().value, ("EVM account not found for " + std::string(BRIDGE_CONTRACT_NAME)).c_str());
+        evm_account_view evm_account = requireEvmAccountByName(get_self());
 
         // --------------------------------------------------------------------------------------------------------
         // --------------------------------------------------------------------------------------------------------
         // --------------------------------------------------------------------------------------------------------
         // Additional EVM state validation for antelope token info
         // Retrieve the EVM token bridge contract state using its bridge scope (from config)
-        account_state_table bridge_states(eosio::name(EVM_SYSTEM_CONTRACT), conf.evm_bridge_scope);
-        auto bridge_state_bykey = bridge_states.get_index<"bykey"_n>();
-
-        uint256_t antelope_token_contract_slot = STORAGE_BRIDGE_TOKEN_CONTRACT_INDEX;
-        uint256_t antelope_token_symbol_slot   = STORAGE_BRIDGE_TOKEN_SYMBOL_INDEX;
+        evm_storage_view bridge_storage(conf.evm_bridge_scope);
 
         // -----------------------------------------------------------------
         // ----- Decode antelope token contract (slot STORAGE_BRIDGE_TOKEN_CONTRACT_INDEX) -----
-        // Create a temporary C-style array of 32 bytes.
-        uint8_t token_contract_slot_c[32] = {0};
-        intx::be::store(token_contract_slot_c, antelope_token_contract_slot);
-
-        // Copy into a std::array (needed for functions like bin2hex).
-        std::array<uint8_t, 32> token_contract_slot_raw;
-        std::copy(std::begin(token_contract_slot_c), std::end(token_contract_slot_c), token_contract_slot_raw.begin());
-
-        // Use the raw padded value directly as the key (without hashing).
-        eosio::checksum256 token_contract_key;
-        std::memcpy((char*)&token_contract_key, token_contract_slot_raw.data(), 32);
-
-        // For debugging: get the expected key as hex.
-        std::string expected_token_key_hex = bin2hex(token_contract_slot_raw);
-
-        // -- Debug: Iterate over the secondary index to see what keys (and their values) are present --
-        bool tokenKeyFound = false;
-        std::string token_debugKeys = "";
-        for (auto itr = bridge_state_bykey.begin(); itr != bridge_state_bykey.end(); ++itr) {
-            auto keyArray = itr->key.extract_as_byte_array(); // returns std::array<uint8_t, 32>
-            std::string storedKeyHex = bin2hex(keyArray);
-            std::string storedValue = parseStringFromStorage(itr->value);
-            token_debugKeys += "[" + storedKeyHex + " : " + storedValue + "] ";
-            if (storedKeyHex == expected_token_key_hex) {
-                tokenKeyFound = true;
-            }
+        // Plain slots are stored under the slot number padded to 32 bytes (without hashing).
+        const std::array<uint8_t, 32> token_contract_slot_raw = uint256ToBytes(STORAGE_BRIDGE_TOKEN_CONTRACT_INDEX);
+        const eosio::checksum256 token_contract_key(token_contract_slot_raw);
+
+        // Single index lookup, the dump of the storage is only built if the key is missing.
+        uint256_t token_contract_value = 0;
+        if (!bridge_storage.get(token_contract_key, token_contract_value)) {
+            check(false,
+                ("EVM state for antelope token contract not found; expected native token contract = " +
+                nativeTokenContract(conf).to_string() + ", expected storage key (raw padded) = " + bin2hex(token_contract_slot_raw) +
+                ", scope = " + std::to_string(conf.evm_bridge_scope) +
+                ", keys present: " + describeStorageKeys(conf.evm_bridge_scope)).c_str());
         }
-        check(tokenKeyFound,
-            ("EVM state for antelope token contract not found; expected native token contract = " +
-            conf.native_token_contract.to_string() + ", expected storage key (raw padded) = " + expected_token_key_hex +
-            ", scope = " + std::to_string(conf.evm_bridge_scope) +
-            ", keys present: " + token_debugKeys).c_str());
-
-        // Instead of using find(), perform a linear search for the matching token contract row.
-        auto token_itr = std::find_if(bridge_state_bykey.begin(), bridge_state_bykey.end(), [&](const auto &row) {
-            auto rowKeyArray = row.key.extract_as_byte_array();
-            return bin2hex(rowKeyArray) == expected_token_key_hex;
-        });
-        check(token_itr != bridge_state_bykey.end(),
-            ("EVM state for antelope token contract not found (by iteration); expected native token contract = " +
-            conf.native_token_contract.to_string() + ", expected storage key (raw padded) = " + expected_token_key_hex +
-            ", scope = " + std::to_string(conf.evm_bridge_scope) +
-            ", keys present: " + token_debugKeys).c_str());
 
         // Decode the stored value using your parseStringFromStorage() function.
-        std::string evm_antelope_token_contract = parseStringFromStorage(token_itr->value);
+        std::string evm_antelope_token_contract = parseStringFromStorage(token_contract_value);
 
         // Normalize both strings for a case-insensitive comparison.
         std::string norm_evm_token_contract = normalizeString(evm_antelope_token_contract);
-        std::string norm_native_token_contract = normalizeString(conf.native_token_contract.to_string());
+        std::string norm_native_token_contract = normalizeString(nativeTokenContract(conf).to_string());
 
         // Check for a mismatch.
         check(norm_evm_token_contract == norm_native_token_contract,
@@ -205,121 +250,138 @@ namespace evm_bridge
 
         // -----------------------------------------------------------------
         // ----- Decode antelope token symbol (slot STORAGE_BRIDGE_TOKEN_SYMBOL_INDEX) -----
-        // Create a temporary C-style array of 32 bytes.
-        uint8_t token_symbol_slot_c[32] = {0};
-        intx::be::store(token_symbol_slot_c, antelope_token_symbol_slot);
-
-        // Copy into a std::array.
-        std::array<uint8_t, 32> token_symbol_slot_raw;
-        std::copy(std::begin(token_symbol_slot_c), std::end(token_symbol_slot_c), token_symbol_slot_raw.begin());
-
-        // Use the raw padded value directly as the key.
-        eosio::checksum256 token_symbol_key;
-        std::memcpy((char*)&token_symbol_key, token_symbol_slot_raw.data(), 32);
-
-        // For debugging: get the expected symbol key as hex.
-        std::string expected_symbol_key_hex = bin2hex(token_symbol_slot_raw);
-
-        // -- Debug: Iterate over the secondary index for symbol keys.
-        bool symbolKeyFound = false;
-        std::string symbol_debugKeys = "";
-        for (auto itr = bridge_state_bykey.begin(); itr != bridge_state_bykey.end(); ++itr) {
-            auto keyArray = itr->key.extract_as_byte_array();
-            std::string storedKeyHex = bin2hex(keyArray);
-            std::string storedValue = parseStringFromStorage(itr->value);
-            symbol_debugKeys += "[" + storedKeyHex + " : " + storedValue + "] ";
-            if (storedKeyHex == expected_symbol_key_hex) {
-                symbolKeyFound = true;
-            }
+        const std::array<uint8_t, 32> token_symbol_slot_raw = uint256ToBytes(STORAGE_BRIDGE_TOKEN_SYMBOL_INDEX);
+        const eosio::checksum256 token_symbol_key(token_symbol_slot_raw);
+
+        uint256_t token_symbol_value = 0;
+        if (!bridge_storage.get(token_symbol_key, token_symbol_value)) {
+            check(false,
+                ("EVM state for antelope token symbol not found; expected storage key (raw padded) = " +
+                bin2hex(token_symbol_slot_raw) + ", scope = " + std::to_string(conf.evm_bridge_scope) +
+                ", keys present: " + describeStorageKeys(conf.evm_bridge_scope)).c_str());
         }
-        check(symbolKeyFound,
-            ("EVM state for antelope token symbol not found; expected storage key (raw padded) = " +
-            expected_symbol_key_hex + ", scope = " + std::to_string(conf.evm_bridge_scope) +
-            ", keys present: " + symbol_debugKeys).c_str());
-
-        // Linear search for the matching symbol row.
-        auto symbol_itr = std::find_if(bridge_state_bykey.begin(), bridge_state_bykey.end(), [&](const auto &row) {
-            auto rowKeyArray = row.key.extract_as_byte_array();
-            return bin2hex(rowKeyArray) == expected_symbol_key_hex;
-        });
-        check(symbol_itr != bridge_state_bykey.end(),
-            ("EVM state for antelope token symbol not found (by iteration); expected storage key (raw padded) = " +
-            expected_symbol_key_hex + ", scope = " + std::to_string(conf.evm_bridge_scope) +
-            ", keys present: " + symbol_debugKeys).c_str());
 
         // Decode the stored value.
-        std::string evm_antelope_token_symbol = parseStringFromStorage(symbol_itr->value);
+        std::string evm_antelope_token_symbol = parseStringFromStorage(token_symbol_value);
         std::string norm_evm_token_symbol = normalizeString(evm_antelope_token_symbol);
 
         // Manually build the full symbol string from the config (e.g. "4,BOID")
-        std::string full_native_symbol = std::to_string(conf.native_token_symbol.precision()) + "," + conf.native_token_symbol.code().to_string();
+        std::string full_native_symbol = std::to_string(nativeTokenSymbol(conf).precision()) + "," + nativeTokenSymbol(conf).code().to_string();
         std::string norm_native_token_symbol = normalizeString(full_native_symbol);
 
         check(norm_evm_token_symbol == norm_native_token_symbol,
             ("Mismatch in antelope token symbol: EVM value = '" + norm_evm_token_symbol +
             "', Telos value = '" + norm_native_token_symbol +
-            "', scope = " + std::to_string(conf.evm_bridge_scope) +
-            ", keys present: " + symbol_debugKeys).c_str());
+            "', scope = " + std::to_string(conf.evm_bridge_scope)).c_str());
 
         // --------------------------------------------------------------------------------------------------------
         // --------------------------------------------------------------------------------------------------------
         // --------------------------------------------------------------------------------------------------------
-        // Prepare EVM Bridge call
-        auto evm_contract = conf.evm_bridge_address.extract_as_byte_array();
-        std::vector<uint8_t> evm_to;
-        evm_to.insert(evm_to.end(), evm_contract.begin(), evm_contract.end());
-
-        // Prepare EVM function signature & arguments | Insert the function signature: 2e5dcb4b (bridgeTo) 4 bytes
-        std::vector<uint8_t> data;
-        auto fnsig = checksum256ToValue(eosio::checksum256(toBin(EVM_BRIDGE_SIGNATURE)));
-        vector<uint8_t> fnsig_bs = intx::to_byte_string(fnsig);
-        fnsig_bs.resize(4);
-        data.insert(data.end(), fnsig_bs.begin(), fnsig_bs.end());
+        // Queued mode: the transfer waits in bridgequeue for the next bridgeToBatch
+        batch_singleton batch_conf(get_self(), get_self().value);
+        batchconfig batch = batch_conf.get_or_default();
+        if (batch.enabled) {
+            bridge_queue_table queue(get_self(), get_self().value);
+            queue.emplace(get_self(), [&](auto& row) {
+                row.id = batch.next_id;
+                row.receiver = eosio::checksum160(receiver_address);
+                row.amount = static_cast<uint64_t>(quantity.amount);
+                row.sender = from;
+                row.queued_at = current_time_point();
+            });
+            batch.next_id++;
+            batch.queued++;
+            batch_conf.set(batch, get_self());
+
+            emit_settlement({0, static_cast<uint64_t>(quantity.amount), from, eosio::checksum160(receiver_address), 0, SETTLE_QUEUED});
+            if (batch_due(batch)) flush_queue(std::min(batch.queued, MAX_BATCH_SIZE));
+            return;
+        }
+
+        // Prepare EVM Bridge call, the calldata is built in place in the action's scratch arena
+        const bool protocol_v2 = conf.get_bridge_protocol() == BRIDGE_PROTOCOL_V2;
+        scratch_bytes data;
+        data.reserve(protocol_v2 ? 4 + 4 * 32 : 4 + 6 * 32);
+
+        // Insert the function signature: 2e5dcb4b (bridgeTo) / f06e8ee4 (bridgeToV2) 4 bytes
+        appendSelector(data, protocol_v2 ? EVM_BRIDGE_V2_SIGNATURE : EVM_BRIDGE_SIGNATURE);
 
         // Token address | Insert the `token` address (32 bytes).
-        auto token_ba = pad160(conf.evm_token_address).extract_as_byte_array();
-        std::vector<uint8_t> token_addr(token_ba.begin(), token_ba.end());
-        token_addr = pad(token_addr, 32, true);
-        data.insert(data.end(), token_addr.begin(), token_addr.end());
+        appendAddressWord(data, conf.evm_token_address);
 
         // Receiver EVM address from memo | Insert the `receiver` address (32 bytes).
-        memo.replace(0, 2, ""); // remove the Ox
-        auto receiver_ba = pad160(eosio::checksum160(toBin(memo))).extract_as_byte_array();
-        std::vector<uint8_t> receiver(receiver_ba.begin(), receiver_ba.end());
-        receiver = pad(receiver, 32, true);
-        data.insert(data.end(), receiver.begin(), receiver.end());
-
-        // Amount | Insert the `amount` (32 bytes).
-        vector<uint8_t> amount_bs = pad(intx::to_byte_string(amount * pow(10, 14)), 32, true); // Assuming token has 4 decimals
-        data.insert(data.end(), amount_bs.begin(), amount_bs.end());
-
-        // Sender
-        std::string sender = from.to_string();
-        insertElementPositions(&data, 128); // Our string position
-        insertString(&data, sender, sender.length());
-
-        // Call TokenBridge.bridgeTo(address token, address receiver, uint amount) on EVM using eosio.evm
-        uint64_t current_nonce = evm_account->nonce; // Get current nonce
+        appendAddressWord(data, eosio::checksum160(receiver_address));
+
+        if (protocol_v2) {
+            // Amount in native units and the sender name, TokenBridge.sol scales the amount itself
+            appendWord(data, static_cast<uint64_t>(quantity.amount));
+            appendWord(data, from.value);
+        } else {
+            // Amount | Insert the `amount` (32 bytes), scaled from the native precision to the EVM decimals.
+            auto scaler = bridgeScaler(conf);
+            appendWord(data, scaler.to_evm(static_cast<uint64_t>(quantity.amount)));
+
+            // Sender
+            std::string sender = from.to_string();
+            insertElementPositions(&data, 128); // Our string position
+            insertString(&data, sender, sender.length());
+        }
+
+        // Call TokenBridge.bridgeTo / bridgeToV2 on EVM using eosio.evm
+        uint64_t current_nonce = evm_account.nonce; // Get current nonce
         action(
             permission_level {get_self(), "active"_n},
             eosio::name(EVM_SYSTEM_CONTRACT),
             "raw"_n,
             std::make_tuple(
                 get_self(),
-                rlp::encode(current_nonce, gas_price_val, BRIDGE_GAS, evm_to, uint256_t(0), data, conf.evm_chain_id, 0, 0),
+                encodeEvmCall(current_nonce, gas_price_val, BRIDGE_GAS, conf.evm_bridge_address.extract_as_byte_array(), data, evmChainId(conf)),
                 false,
-                std::optional<eosio::checksum160>(evm_account->address)
+                std::optional<eosio::checksum160>(evm_account.address)
             )
         ).send();
+
+        update_stats([&](bridgestats& s) {
+            s.to_evm_count++;
+            s.to_evm_volume += static_cast<uint64_t>(quantity.amount);
+            s.gas_limit_spent += BRIDGE_GAS;
+        });
+
+        emit_settlement({0, static_cast<uint64_t>(quantity.amount), from, eosio::checksum160(receiver_address), current_nonce, SETTLE_BRIDGED});
     };
 
     // Trustless bridge from tEVM
     [[eosio::action]]
-    void tokenbridge::reqnotify(uint64_t req_id)
+    settlement tokenbridge::reqnotify(uint64_t req_id)
     {
+        scratch_scope scope("reqnotify");
+
+        // Throughput governor first, a refused request costs one singleton read. The bucket of the
+        // EVM sender is taken once the Request is read, the governor is written back once for both.
+        governor_singleton governor_conf(get_self(), get_self().value);
+        governor gov = governor_conf.get_or_default();
+        const uint32_t now_sec = current_time_point().sec_since_epoch();
+        check(takeToken(gov.to_native, gov.to_native_limits(), now_sec), governorMessage(GOVERNOR_GLOBAL_LIMIT));
+
         // Open config
         auto conf = config_bridge.get();
 
+        // Pre-flight checks shared with the relayers (include_common/request_preflight.hpp): the evm.boid
+        // rows first, then the Request in the TokenBridge.sol storage, in the layout of the deployed contract
+        requests_table _requests(get_self(), get_self().value);
+        evm_storage_view bridge_storage(conf.evm_bridge_scope);
+        preflight_request req;
+        const preflight_status status = preflightNotify(bridge_storage, req_id, _requests.find(req_id) != _requests.end(),
+                                                        is_settled(req_id), requestPreflightConfig(conf), req);
+        check(status == PREFLIGHT_OK, preflightError(status, req_id, req, conf));
+        const eosio::name receiver(req.receiver);
+
+        if (gov.sender_burst > 0) {
+            check(takeToken(gov.sender_bucket(req.sender.data()), gov.sender_limits(), now_sec),
+                  std::string(governorMessage(GOVERNOR_SENDER_LIMIT)) + ": 0x" + toHex(req.sender.data(), req.sender.size()));
+        }
+        if (gov.to_native_burst > 0 || gov.sender_burst > 0) governor_conf.set(gov, get_self());
+
         // Load the EVM system config
         evm_config_table evmconfig(eosio::name(EVM_SYSTEM_CONTRACT), eosio::name(EVM_SYSTEM_CONTRACT).value);
         auto it_config = evmconfig.begin();
@@ -327,250 +389,145 @@ namespace evm_bridge
         auto evm_conf = *it_config;
 
         // Gas price calculation
-        uint256_t gas_price_val = (evm_conf.gas_price * 11) / 10;
+        uint256_t gas_price_val = gasPriceWithMargin(evm_conf.gas_price);
 
         // Find the EVM account of this contract
-        account_table _accounts(eosio::name(EVM_SYSTEM_CONTRACT), eosio::name(EVM_SYSTEM_CONTRACT).value);
-        auto accounts_byaccount = _accounts.get_index<"byaccount"_n>();
-        auto evm_account = accounts_byaccount.require_find(get_self().value,
-            ("EVM account not found for " + std::string(BRIDGE_CONTRACT_NAME)).c_str());
-
-        // ------------------------------------------------------------------
-        // Compute the base key for the mapping entry for this request.
-        eosio::checksum256 baseKey = computeMappingKey(req_id, STORAGE_BRIDGE_REQUESTS_INDEX);
-
-        // Each Request struct occupies 9 storage slots.
-        uint8_t request_property_count = 9;
-        // Compute keys for each property by adding the property index as an offset.
-        checksum256 key_request_id             = addToChecksum256(baseKey, 0);
-        checksum256 key_sender                 = addToChecksum256(baseKey, 1);
-        checksum256 key_amount                 = addToChecksum256(baseKey, 2);
-        checksum256 key_requested_at           = addToChecksum256(baseKey, 3);
-        checksum256 key_antelope_token_contract= addToChecksum256(baseKey, 4);
-        checksum256 key_antelope_symbol        = addToChecksum256(baseKey, 5);
-        checksum256 key_receiver               = addToChecksum256(baseKey, 6);
-        checksum256 key_packed                 = addToChecksum256(baseKey, 7);
-        checksum256 key_memo                   = addToChecksum256(baseKey, 8);
-        // ------------------------------------------------------------------
-
-
-        // Open the account state table.
-        account_state_table bridge_account_states(name(EVM_SYSTEM_CONTRACT), conf.evm_bridge_scope);
-        auto bridge_account_states_bykey = bridge_account_states.get_index<"bykey"_n>();
-
-        // Declare variables to hold the EVM data.
-        uint256_t stored_req_id = 0;
-        std::string senderStr;
-        uint256_t amountVal = 0;
-        uint256_t requestedAtVal = 0;
-        std::string evm_token_contract;
-        std::string evm_token_contract_raw;
-        std::string evm_token_symbol;
-        std::string memoStr;
-        eosio::name receiver;
-        uint8_t evm_decimals = 0;
-        uint8_t request_status = 0;
-        uint256_t packed_value = 0;
-
-        auto it_req_id = bridge_account_states_bykey.find(key_request_id);
-        auto it_sender = bridge_account_states_bykey.find(key_sender);
-        auto it_amount = bridge_account_states_bykey.find(key_amount);
-        auto it_requested_at = bridge_account_states_bykey.find(key_requested_at);
-        auto it_antelope_token_contract = bridge_account_states_bykey.find(key_antelope_token_contract);
-        auto it_antelope_symbol = bridge_account_states_bykey.find(key_antelope_symbol);
-        auto it_receiver = bridge_account_states_bykey.find(key_receiver);
-        auto it_packed = bridge_account_states_bykey.find(key_packed);
-        auto it_memo = bridge_account_states_bykey.find(key_memo);
-
-        std::vector<evm_bridge::KeyCheck> key_checks = {
-            evm_bridge::KeyCheck("request_id", it_req_id, key_request_id),
-            evm_bridge::KeyCheck("sender", it_sender, key_sender),
-            evm_bridge::KeyCheck("amount", it_amount, key_amount),
-            evm_bridge::KeyCheck("requested_at", it_requested_at, key_requested_at),
-            evm_bridge::KeyCheck("token_contract", it_antelope_token_contract, key_antelope_token_contract),
-            evm_bridge::KeyCheck("token_symbol", it_antelope_symbol, key_antelope_symbol),
-            evm_bridge::KeyCheck("receiver", it_receiver, key_receiver),
-            evm_bridge::KeyCheck("packed", it_packed, key_packed),
-            evm_bridge::KeyCheck("memo", it_memo, key_memo)
-        };
-
-        // Check if all keys are present
-        checkStorageKeys(key_checks, bridge_account_states_bykey);
-
-        // Extract values from the EVM state
-        // Request ID
-        stored_req_id = it_req_id->value;
-        
-        // Sender
-        senderStr = "0x" + bin2hex(parseAddressFromStorage(it_sender->value));
-        
-        // Amount
-        amountVal = it_amount->value;
-        
-        // Requested at
-        requestedAtVal = it_requested_at->value;
-        
-        // Token contract
-        evm_token_contract_raw = bin2hex(parseAddressFromStorage(it_antelope_token_contract->value));
-        evm_token_contract = parseStringFromStorage(it_antelope_token_contract->value);
-        
-        // Token symbol
-        evm_token_symbol = parseStringFromStorage(it_antelope_symbol->value);
-        
-        // Receiver
-        std::string raw_receiver = parseStringFromStorage(it_receiver->value);
-        std::transform(raw_receiver.begin(), raw_receiver.end(), raw_receiver.begin(), ::tolower);
-        // Validate and truncate to 12 chars max for EOSIO name
-        check(raw_receiver.length() <= 12, "Receiver name too long" + std::to_string(raw_receiver.length()) +
-        "TokenSymbol: " + evm_token_symbol + "TokenContract: " + evm_token_contract);
-        if (raw_receiver.length() > 12) {
-            raw_receiver = raw_receiver.substr(0, 12);
-        }
-        receiver = eosio::name(raw_receiver);
-
-        // Packed
-        packed_value = it_packed->value;
-        // Decimals
-        evm_decimals = static_cast<uint8_t>(packed_value & 0xFF);
-        // Request status
-        request_status = static_cast<uint8_t>((packed_value >> 8) & 0xFF);
-        check(request_status == 0, 
-            "Request status must be Pending (0) to process. Current status: " + 
-            std::to_string(request_status));
-
-        // Memo
-        memoStr = parseStringFromStorage(it_memo->value);
+        evm_account_view evm_account = requireEvmAccountByName(get_self());
 
-        // Check if the request is pending
-        check(request_status == 0, "Request is not pending");
-
-        std::string norm_evm_token_contract = normalizeString(evm_token_contract);
-        std::string norm_native_token_contract = normalizeString(conf.native_token_contract.to_string());
-        check(norm_evm_token_contract == norm_native_token_contract, "Mismatch in antelope token contract");
-
-        // compare request id with the stored request id
-        check(stored_req_id == intx::uint256(req_id),
-            ("Request ID " + intx::to_string(stored_req_id) + " already exists").c_str());
-
-        // Convert the signature hex string to a 20-byte array
-        std::array<uint8_t, 20> full_sig_arr = toBin(EVM_SUCCESS_CALLBACK_SIGNATURE);
-        // Then create a vector containing only the first 4 bytes (the actual selector)
-        std::vector<uint8_t> fnsig_bs(full_sig_arr.begin(), full_sig_arr.begin() + 4);
-
-        // Prepare 32-byte uint256 parameter for the request id
-        std::array<uint8_t, 32> req_id_arr = uint256ToBytes(stored_req_id);
-        std::vector<uint8_t> req_id_bs(req_id_arr.begin(), req_id_arr.end());
-
-        // Build the calldata: function selector (4 bytes) + padded parameter (32 bytes)
-        std::vector<uint8_t> data = fnsig_bs; // start with the 4-byte selector
-        data.insert(data.end(), req_id_bs.begin(), req_id_bs.end());
-
-        // Get the EVM contract address bytes
-        auto evm_contract_bytes = conf.evm_bridge_address.extract_as_byte_array();
-        std::vector<uint8_t> evm_to(evm_contract_bytes.begin(), evm_contract_bytes.end());
+        // Build the calldata: function selector (4 bytes) + padded request id (32 bytes)
+        scratch_bytes data;
+        data.reserve(4 + 32);
+        appendSelector(data, EVM_SUCCESS_CALLBACK_SIGNATURE);
+        appendWord(data, req.id);
 
         // Get the current nonce and send the action
-        uint64_t current_nonce = evm_account->nonce;
+        uint64_t current_nonce = evm_account.nonce;
         action(
             permission_level{get_self(), "active"_n},
             eosio::name(EVM_SYSTEM_CONTRACT),
             "raw"_n,
             std::make_tuple(
                 get_self(),
-                rlp::encode(current_nonce, gas_price_val, SUCCESS_CB_GAS, evm_to,
-                            uint256_t(0), data, conf.evm_chain_id, 0, 0),
+                encodeEvmCall(current_nonce, gas_price_val, SUCCESS_CB_GAS, conf.evm_bridge_address.extract_as_byte_array(),
+                              data, evmChainId(conf)),
                 false,
-                std::optional<eosio::checksum160>(evm_account->address)
+                std::optional<eosio::checksum160>(evm_account.address)
             )
         ).send();
 
         require_recipient(eosio::name(EVM_SYSTEM_CONTRACT));
 
-        requests_table _requests(get_self(), get_self().value);
-
-        auto existing_request = _requests.find(static_cast<uint64_t>(stored_req_id));
-        check(existing_request == _requests.end(), 
-            ("Request ID " + intx::to_string(stored_req_id) + " already exists").c_str());
-
-        uint64_t wei_scale_factor = 100000000000000ULL; // 1e14
         _requests.emplace(get_self(), [&](auto& r) {
-            r.request_id = static_cast<uint64_t>(stored_req_id);
-            
-            uint64_t evm_timestamp_sec = static_cast<uint64_t>(requestedAtVal);
-            r.timestamp = time_point(seconds(evm_timestamp_sec));
-            
-            uint64_t amount = static_cast<uint64_t>(amountVal / wei_scale_factor);
-            // Build a `uint256_t` of the expected product:
-            uint256_t expected = uint256_t(amount) * uint256_t(wei_scale_factor);
-
-            // Compare the 256-bit numbers in the check error message:
-            check(amountVal == expected,
-                (
-                "Precision loss detected. \n"
-                "amountVal: " + intx::to_string(amountVal) + "\n"
-                "expected:  " + intx::to_string(expected) + "\n"
-                ).c_str()
-            );
-            r.amount = amount;
-            
+            r.request_id = req.id;
+            r.timestamp = time_point(seconds(req.requested_at));
+            r.amount = req.amount;
             r.processed = false;
             r.receiver = receiver;
-            r.sender = senderStr;
-            r.memo = memoStr;
+            r.sender = "0x" + toHex(req.sender.data(), req.sender.size());
+            r.memo = req.memo;
+            r.notified_at.emplace(current_time_point());
         });
+
+        time_point requested_at = time_point(seconds(req.requested_at));
+        update_stats([&](bridgestats& s) {
+            s.to_native_notified++;
+            s.gas_limit_spent += SUCCESS_CB_GAS;
+            if (s.pending_count == 0 || requested_at < s.oldest_pending) s.oldest_pending = requested_at;
+            s.pending_count++;
+            s.notify_latency[latencyBucket((current_time_point() - requested_at).to_seconds())]++;
+        });
+
+        settlement notified = emit_settlement({req.id, req.amount, receiver, eosio::checksum160(), current_nonce, SETTLE_NOTIFIED});
+
+        // The raw EVM call above runs first and removes the request from the EVM storage,
+        // finalize then pays out in this same transaction (and fails it if the callback did not land)
+        action(
+            permission_level{get_self(), "active"_n},
+            get_self(),
+            "finalize"_n,
+            std::make_tuple(notified.request_id)
+        ).send();
+
+        return notified;
     }
 
     [[eosio::action]]
-    void tokenbridge::verifytrx(uint64_t req_id) {
-        auto conf = config_bridge.get();
-        requests_table requests(get_self(), get_self().value);
-        
-        // 1. Cleanup old processed requests (older than 24h)
-        auto by_time = requests.get_index<"timestamp"_n>();
-        auto twenty_four_hours_ago = current_time_point() - hours(24);
-        auto cleanup_cutoff = twenty_four_hours_ago.sec_since_epoch();
-        
-        // Iterate from oldest to newest until we hit non-expired entries
-        auto itr = by_time.begin();
-        while(itr != by_time.end() && itr->timestamp <= twenty_four_hours_ago) {
-            if(itr->processed) {
-                itr = by_time.erase(itr); // Delete processed and expired
-            } else {
-                ++itr; // Keep unprocessed but expired
-            }
-        }
+    settlement tokenbridge::verifytrx(uint64_t req_id) {
+        scratch_scope scope("verifytrx");
+
+        // Settled rows are erased by settle, there is nothing left to clean up here
+        return settle(req_id);
+    }
 
-        // 2. Check requested transaction
-        auto itr_req = requests.require_find(req_id, "Request not found");
-        check(!itr_req->processed, "Request already processed");
+    [[eosio::action]]
+    settlement tokenbridge::finalize(uint64_t req_id) {
+        scratch_scope scope("finalize");
 
-        // 3. Verify EVM state
-        checksum256 baseKey = computeMappingKey(req_id, STORAGE_BRIDGE_REQUESTS_INDEX);
+        // Only sent inline by reqnotify
+        require_auth(get_self());
+        return settle(req_id);
+    }
 
-        account_state_table fresh_account_states(name(EVM_SYSTEM_CONTRACT), conf.evm_bridge_scope);
-        auto fresh_states_bykey = fresh_account_states.get_index<"bykey"_n>();
-        auto base_key_itr = fresh_states_bykey.find(baseKey);
+    settlement tokenbridge::settle(uint64_t req_id) {
+        auto conf = config_bridge.get();
+        requests_table requests(get_self(), get_self().value);
 
-        check(base_key_itr == fresh_states_bykey.end(), 
-            ("Request ID " + std::to_string(req_id) + " still exists in EVM storage. Key: " + 
-             bin2hex(baseKey.extract_as_byte_array())).c_str());
+        // 1. Pre-flight checks shared with the relayers: an unpaid row whose Request is gone from the EVM storage
+        auto itr_req = requests.find(req_id);
+        const bool notified = itr_req != requests.end();
+        const preflight_status status = preflightSettle(evm_storage_view(conf.evm_bridge_scope), req_id, notified,
+                                                        notified && itr_req->processed);
+        check(status == PREFLIGHT_OK, preflightError(status, req_id, preflight_request(), conf));
 
-        // 4. Process transfer
+        // 2. Process transfer
         uint64_t final_units = itr_req->amount; 
-        asset quantity(final_units, conf.native_token_symbol);
+        asset quantity(final_units, nativeTokenSymbol(conf));
+        const name receiver = itr_req->receiver;
+        const binary_extension<time_point> notified_at = itr_req->notified_at;
         
         action(
             permission_level{get_self(), "active"_n},
-            conf.native_token_contract,
+            nativeTokenContract(conf),
             "transfer"_n,
-            make_tuple(get_self(), itr_req->receiver, quantity, itr_req->memo)
+            make_tuple(get_self(), receiver, quantity, itr_req->memo)
         ).send();
 
-        // 5. Mark processed
-        requests.modify(itr_req, same_payer, [&](auto& r) {
-            r.processed = true;
-            r.timestamp = current_time_point(); // Update timestamp for cleanup
+        // 3. Record the id in the ledger and drop the row, reqnotify refuses the id from now on
+        mark_settled(req_id);
+        requests.erase(itr_req);
+
+        time_point oldest = oldest_pending(requests);
+        update_stats([&](bridgestats& s) {
+            s.to_native_released++;
+            s.to_native_volume += final_units;
+            if (s.pending_count > 0) s.pending_count--;
+            s.oldest_pending = oldest;
+            if (notified_at.has_value()) {
+                s.settle_latency[latencyBucket((current_time_point() - notified_at.value()).to_seconds())]++;
+            }
         });
+
+        return emit_settlement({req_id, final_units, receiver, eosio::checksum160(), 0, SETTLE_RELEASED});
+    }
+
+    bool tokenbridge::is_settled(uint64_t req_id) {
+        settled_ids_table ledger(get_self(), get_self().value);
+        auto itr = ledger.find(settledWordIndex(req_id));
+        return itr != ledger.end() && (itr->bits & settledBit(req_id)) != 0;
+    }
+
+    void tokenbridge::mark_settled(uint64_t req_id) {
+        settled_ids_table ledger(get_self(), get_self().value);
+        const uint64_t word = settledWordIndex(req_id);
+        auto itr = ledger.find(word);
+        if (itr == ledger.end()) {
+            ledger.emplace(get_self(), [&](auto& w) {
+                w.word_index = word;
+                w.bits = settledBit(req_id);
+            });
+        } else {
+            ledger.modify(itr, same_payer, [&](auto& w) { w.bits |= settledBit(req_id); });
+        }
     }
 
     // Remove a request from the table | ONLY FOR EMERGENCY USE
@@ -579,58 +536,213 @@ namespace evm_bridge
         require_auth(get_self());
         requests_table requests(get_self(), get_self().value);
         auto itr = requests.require_find(req_id, "Request not found");
+        bool was_pending = !itr->processed;
         requests.erase(itr);
+
+        if (was_pending) {
+            time_point oldest = oldest_pending(requests);
+            update_stats([&](bridgestats& s) {
+                if (s.pending_count > 0) s.pending_count--;
+                s.oldest_pending = oldest;
+            });
+        }
     }
 
-    // calls an action on the EVM to refund Failed requests | ONLY FOR EMERGENCY USE
-    [[eosio::action]] void tokenbridge::refstuckreq() {
+    // Rows processed before the settledids ledger existed, key 1 of the processed index
+    [[eosio::action]]
+    void tokenbridge::drainproc(uint32_t max) {
+        require_auth(get_self());
+        check(max > 0, "max must be greater than zero");
+
+        uint32_t drained = 0;
+        table_cursor<requests_table> cur(get_self(), get_self().value, REQUESTS_INDEX_PROCESSED, 1);
+        while (cur.valid() && drained < max) {
+            mark_settled(cur->request_id);
+            cur.erase();
+            drained++;
+        }
+        check(drained > 0, "No processed rows left");
+    }
+
+    // calls refundStuckReq(start, count) on the EVM | ONLY FOR EMERGENCY USE
+    [[eosio::action]] void tokenbridge::refstuckreq(uint64_t start, uint32_t count) {
+        scratch_scope scope("refstuckreq");
+
         // Authenticate
+        require_auth(get_self());
+        send_recovery(EVM_REF_STUCK_REQ_SIGNATURE, start, count, REFUND_GAS_PER_REQUEST);
+    };
+
+    // calls clearFailedRequests(start, count) on the EVM | ONLY FOR EMERGENCY USE
+    [[eosio::action]] void tokenbridge::clrfailedreq(uint64_t start, uint32_t count) {
+        scratch_scope scope("clrfailedreq");
+
+        require_auth(get_self());
+        send_recovery(EVM_CLEAR_FAILED_REQUESTS_SIGNATURE, start, count, CLEAR_GAS_PER_REQUEST);
+    };
+
+    // calls an action on the EVM removeRequest(uint256) | ONLY FOR EMERGENCY USE
+    [[eosio::action]] void tokenbridge::rmreqonevm(uint64_t req_id) {
+        scratch_scope scope("rmreqonevm");
+
         require_auth(get_self());
         
         // Open config
         auto conf = config_bridge.get();
 
-        // Load the EVM system config
+        // Load EVM config
         evm_config_table evmconfig(eosio::name(EVM_SYSTEM_CONTRACT), eosio::name(EVM_SYSTEM_CONTRACT).value);
         auto it = evmconfig.begin();
         check(it != evmconfig.end(), "No config row found in eosio.evm's 'config' table");
         auto evm_conf = *it;
 
-        // Gas price calculation
-        uint256_t gas_price_val = (evm_conf.gas_price * 11) / 10;
+        // Gas price with 10% buffer
+        uint256_t gas_price_val = gasPriceWithMargin(evm_conf.gas_price);
 
-        // Find the EVM account of this contract
-        account_table _accounts(eosio::name(EVM_SYSTEM_CONTRACT), eosio::name(EVM_SYSTEM_CONTRACT).value);
-        auto accounts_byaccount = _accounts.get_index<"byaccount"_n>();
-        auto evm_account = accounts_byaccount.require_find(get_self().value,
-            ("EVM account not found for " + std::string(BRIDGE_CONTRACT_NAME)).c_str());
+        // Get EVM account
+        evm_account_view evm_account = requireEvmAccountByName(get_self());
 
-        // -----------------------------------------------------------------
-        // call the refundStuckReq() function on the EVM
-        auto fnsig = toBin(EVM_REF_STUCK_REQ_SIGNATURE);
-        std::vector<uint8_t> data(fnsig.begin(), fnsig.begin() + 4); // Use only first 4 bytes
+        // Prepare calldata: removeRequest(uint256)
+        scratch_bytes data;
+        appendSelector(data, EVM_REMOVE_REQUEST_SIGNATURE);
+
+        // Pack request ID as uint256
+        appendWord(data, req_id);
 
-        // Update the RLP encoding to use correct bridge address:
-        uint64_t current_nonce = evm_account->nonce; // Get current nonce
+        // Send EVM transaction
+        uint64_t current_nonce = evm_account.nonce;
         action(
             permission_level{get_self(), "active"_n},
             eosio::name(EVM_SYSTEM_CONTRACT),
             "raw"_n,
             std::make_tuple(
                 get_self(),
-                rlp::encode(current_nonce, gas_price_val, SUCCESS_CB_GAS, 
-                           conf.evm_bridge_address.extract_as_byte_array(), // Correct to: bridge address
-                           uint256_t(0), data, conf.evm_chain_id, 0, 0),
+                encodeEvmCall(current_nonce, gas_price_val, SUCCESS_CB_GAS,
+                              conf.evm_bridge_address.extract_as_byte_array(), data, evmChainId(conf)),
                 false,
-                std::optional<eosio::checksum160>(evm_account->address)
+                std::optional<eosio::checksum160>(evm_account.address)
             )
         ).send();
-    };
+    }
 
-    // calls an action on the EVM clearFailedRequests() | ONLY FOR EMERGENCY USE
-    [[eosio::action]] void tokenbridge::clrfailedreq() {
+    [[eosio::action]]
+    void tokenbridge::setbatch(bool enabled, uint32_t max_batch, uint32_t max_age_sec) {
         require_auth(get_self());
-        
+        check(max_batch <= MAX_BATCH_SIZE, "max_batch cannot be over " + std::to_string(MAX_BATCH_SIZE));
+
+        // Transfers already queued stay there until flushed, also after queued mode is disabled
+        batch_singleton batch_conf(get_self(), get_self().value);
+        batchconfig batch = batch_conf.get_or_default();
+        batch.enabled = enabled;
+        batch.max_batch = max_batch;
+        batch.max_age_sec = max_age_sec;
+        batch_conf.set(batch, get_self());
+    }
+
+    [[eosio::action]]
+    void tokenbridge::setgovernor(uint32_t to_evm_burst, uint32_t to_evm_per_hour, uint32_t to_native_burst,
+                                  uint32_t to_native_per_hour, uint32_t sender_burst, uint32_t sender_per_hour) {
+        require_auth(get_self());
+        // A bucket that never refills would stop its direction for good once emptied
+        check(to_evm_burst == 0 || to_evm_per_hour > 0, "to_evm_per_hour must be set with to_evm_burst");
+        check(to_native_burst == 0 || to_native_per_hour > 0, "to_native_per_hour must be set with to_native_burst");
+        check(sender_burst == 0 || sender_per_hour > 0, "sender_per_hour must be set with sender_burst");
+
+        // The bucket levels are kept, a lower burst cuts them down on their next take
+        governor_singleton governor_conf(get_self(), get_self().value);
+        governor gov = governor_conf.get_or_default();
+        gov.to_evm_burst = to_evm_burst;
+        gov.to_evm_per_hour = to_evm_per_hour;
+        gov.to_native_burst = to_native_burst;
+        gov.to_native_per_hour = to_native_per_hour;
+        gov.sender_burst = sender_burst;
+        gov.sender_per_hour = sender_per_hour;
+        governor_conf.set(gov, get_self());
+    }
+
+    [[eosio::action]]
+    void tokenbridge::flush(uint32_t max) {
+        check(max > 0 && max <= MAX_BATCH_SIZE, "max must be between 1 and " + std::to_string(MAX_BATCH_SIZE));
+
+        // Anyone can push a queue that is due, only the contract can flush earlier (smaller batches cost more gas)
+        batch_singleton batch_conf(get_self(), get_self().value);
+        if (!has_auth(get_self())) {
+            check(batch_due(batch_conf.get_or_default()), "The queue is not due for a flush");
+        }
+        check(flush_queue(max) > 0, "The queue is empty");
+    }
+
+    // Pending rows sort first in the processed index (key 0), ordered by request id
+    [[eosio::action, eosio::read_only]]
+    pending_page tokenbridge::getpending(uint64_t cursor, uint32_t limit) {
+        check(limit > 0, "Limit must be greater than zero");
+        limit = std::min(limit, MAX_QUERY_LIMIT);
+
+        // Seek to the cursor in the primary index and skip processed rows, only builds before the settledids
+        // ledger left any (drainproc moves them out), so a page costs O(log n) plus the rows returned
+        requests_table requests(get_self(), get_self().value);
+
+        pending_page page{{}, 0, false};
+        for (auto itr = requests.lower_bound(cursor); itr != requests.end(); ++itr) {
+            if (itr->processed) continue;
+            if (page.rows.size() == limit) {
+                page.next_cursor = itr->request_id;
+                page.more = true;
+                break;
+            }
+            page.rows.push_back(make_request_view(*itr));
+        }
+        return page;
+    }
+
+    [[eosio::action, eosio::read_only]]
+    std::vector<request_view> tokenbridge::getreq(const std::vector<uint64_t>& ids) {
+        check(ids.size() <= MAX_QUERY_LIMIT, "Too many request ids, max is " + std::to_string(MAX_QUERY_LIMIT));
+
+        requests_table requests(get_self(), get_self().value);
+        std::vector<request_view> rows;
+        rows.reserve(ids.size());
+        for (uint64_t id : ids) {
+            auto itr = requests.find(id);
+            if (itr != requests.end()) rows.push_back(make_request_view(*itr));
+        }
+        return rows;
+    }
+
+    [[eosio::action]]
+    void tokenbridge::logsettle(const settlement& /*s*/) {
+        require_auth(get_self());
+    }
+
+    time_point tokenbridge::oldest_pending(requests_table& requests) {
+        // Request ids grow with requested_at on the EVM, so the first pending id is the oldest one
+        auto by_processed = requests.get_index<"processed"_n>();
+        auto itr = by_processed.lower_bound(0);
+        return (itr != by_processed.end() && !itr->processed) ? itr->timestamp : time_point();
+    }
+
+    settlement tokenbridge::emit_settlement(const settlement& s) {
+        action(
+            permission_level{get_self(), "active"_n},
+            get_self(),
+            "logsettle"_n,
+            std::make_tuple(s)
+        ).send();
+        return s;
+    }
+
+    bool tokenbridge::batch_due(const batchconfig& batch) {
+        if (batch.queued == 0) return false;
+        if (batch.max_batch > 0 && batch.queued >= batch.max_batch) return true;
+        if (batch.max_age_sec == 0) return false;
+
+        bridge_queue_table queue(get_self(), get_self().value);
+        auto oldest = queue.begin();
+        return oldest != queue.end() &&
+               current_time_point().sec_since_epoch() - oldest->queued_at.sec_since_epoch() >= batch.max_age_sec;
+    }
+
+    uint32_t tokenbridge::flush_queue(uint32_t max) {
         // Open config
         auto conf = config_bridge.get();
 
@@ -641,80 +753,114 @@ namespace evm_bridge
         auto evm_conf = *it;
 
         // Gas price calculation
-        uint256_t gas_price_val = (evm_conf.gas_price * 11) / 10;
+        uint256_t gas_price_val = gasPriceWithMargin(evm_conf.gas_price);
 
         // Find the EVM account of this contract
-        account_table _accounts(eosio::name(EVM_SYSTEM_CONTRACT), eosio::name(EVM_SYSTEM_CONTRACT).value);
-        auto accounts_byaccount = _accounts.get_index<"byaccount"_n>();
-        auto evm_account = accounts_byaccount.require_find(get_self().value,
-            ("EVM account not found for " + std::string(BRIDGE_CONTRACT_NAME)).c_str());
-
-        // -----------------------------------------------------------------
-        // call the clearFailedRequests() function on the EVM
-        auto fnsig = toBin(EVM_CLEAR_FAILED_REQUESTS_SIGNATURE);
-        std::vector<uint8_t> data(fnsig.begin(), fnsig.begin() + 4); // Use only first 4 bytes
-
-        // Update the RLP encoding to use correct bridge address:
-        uint64_t current_nonce = evm_account->nonce; // Get current nonce
+        evm_account_view evm_account = requireEvmAccountByName(get_self());
+        uint64_t current_nonce = evm_account.nonce; // Get current nonce
+
+        // The three arrays are filled in one pass over the oldest rows, erased as they are read
+        auto scaler = bridgeScaler(conf);
+        scratch_bytes receivers, amounts, senders;
+        receivers.reserve(max * 32);
+        amounts.reserve(max * 32);
+        senders.reserve(max * 32);
+        uint32_t count = 0;
+        uint64_t volume = 0;
+        for (table_cursor<bridge_queue_table> cur(get_self(), get_self().value); cur.valid() && count < max; ++count) {
+            appendAddressWord(receivers, cur->receiver);
+            appendWord(amounts, scaler.to_evm(cur->amount));
+            appendNameWord(senders, cur->sender);
+            volume += cur->amount;
+            emit_settlement({0, cur->amount, cur->sender, cur->receiver, current_nonce, SETTLE_BRIDGED});
+            cur.erase();
+        }
+        if (count == 0) return 0;
+
+        // bridgeToBatch(address[] receivers, uint256[] amounts, bytes32[] senders): three offsets, then
+        // each array as its length followed by its elements
+        const uint64_t array_size = 32 * (1 + uint64_t(count));
+        scratch_bytes data;
+        data.reserve(4 + 3 * 32 + 3 * array_size);
+        appendSelector(data, EVM_BRIDGE_BATCH_SIGNATURE);
+        insertElementPositions(&data, 3 * 32, 3 * 32 + array_size, 3 * 32 + 2 * array_size);
+        appendWord(data, count);
+        data.insert(data.end(), receivers.begin(), receivers.end());
+        appendWord(data, count);
+        data.insert(data.end(), amounts.begin(), amounts.end());
+        appendWord(data, count);
+        data.insert(data.end(), senders.begin(), senders.end());
+
+        uint64_t gas_limit = BATCH_BASE_GAS + BATCH_GAS_PER_TRANSFER * count;
         action(
             permission_level{get_self(), "active"_n},
             eosio::name(EVM_SYSTEM_CONTRACT),
             "raw"_n,
             std::make_tuple(
                 get_self(),
-                rlp::encode(current_nonce, gas_price_val, SUCCESS_CB_GAS, 
-                           conf.evm_bridge_address.extract_as_byte_array(), // Correct to: bridge address
-                           uint256_t(0), data, conf.evm_chain_id, 0, 0),
+                encodeEvmCall(current_nonce, gas_price_val, gas_limit,
+                              conf.evm_bridge_address.extract_as_byte_array(), data, evmChainId(conf)),
                 false,
-                std::optional<eosio::checksum160>(evm_account->address)
+                std::optional<eosio::checksum160>(evm_account.address)
             )
         ).send();
-    };
 
-    // calls an action on the EVM removeRequest(uint256) | ONLY FOR EMERGENCY USE
-    [[eosio::action]] void tokenbridge::rmreqonevm(uint64_t req_id) {
-        require_auth(get_self());
-        
+        batch_singleton batch_conf(get_self(), get_self().value);
+        batchconfig batch = batch_conf.get_or_default();
+        batch.queued -= std::min(batch.queued, count);
+        batch_conf.set(batch, get_self());
+
+        update_stats([&](bridgestats& s) {
+            s.to_evm_count += count;
+            s.to_evm_volume += volume;
+            s.gas_limit_spent += gas_limit;
+        });
+        return count;
+    }
+
+    void tokenbridge::send_recovery(const char* selector, uint64_t start, uint32_t count, uint64_t gas_per_request) {
+        check(count > 0 && count <= MAX_RECOVERY_PAGE, "count must be between 1 and " + std::to_string(MAX_RECOVERY_PAGE));
+
         // Open config
         auto conf = config_bridge.get();
 
-        // Load EVM config
+        // Load the EVM system config
         evm_config_table evmconfig(eosio::name(EVM_SYSTEM_CONTRACT), eosio::name(EVM_SYSTEM_CONTRACT).value);
         auto it = evmconfig.begin();
         check(it != evmconfig.end(), "No config row found in eosio.evm's 'config' table");
         auto evm_conf = *it;
 
-        // Gas price with 10% buffer
-        uint256_t gas_price_val = (evm_conf.gas_price * 11) / 10;
-
-        // Get EVM account
-        account_table _accounts(eosio::name(EVM_SYSTEM_CONTRACT), eosio::name(EVM_SYSTEM_CONTRACT).value);
-        auto accounts_byaccount = _accounts.get_index<"byaccount"_n>();
-        auto evm_account = accounts_byaccount.require_find(get_self().value,
-            ("EVM account not found for " + std::string(BRIDGE_CONTRACT_NAME)).c_str());
-
-        // Prepare calldata: removeRequest(uint256)
-        auto fnsig = toBin(EVM_REMOVE_REQUEST_SIGNATURE);
-        std::vector<uint8_t> data(fnsig.begin(), fnsig.begin() + 4);
-        
-        // Pack request ID as uint256
-        std::array<uint8_t, 32> req_id_bytes = uint256ToBytes(uint256_t(req_id));
-        data.insert(data.end(), req_id_bytes.begin(), req_id_bytes.end());
+        // Gas price calculation
+        uint256_t gas_price_val = gasPriceWithMargin(evm_conf.gas_price);
 
-        // Send EVM transaction
-        uint64_t current_nonce = evm_account->nonce;
+        // Find the EVM account of this contract
+        evm_account_view evm_account = requireEvmAccountByName(get_self());
+
+        // selector(uint256 start, uint256 count), TokenBridge.sol keeps its own cursor for RECOVERY_CURSOR
+        scratch_bytes data;
+        data.reserve(4 + 2 * 32);
+        appendSelector(data, selector);
+        appendWord(data, start);
+        appendWord(data, count);
+
+        // Only the gas of the page is reserved, whatever the size of the backlog
+        uint64_t gas_limit = RECOVERY_BASE_GAS + gas_per_request * count;
+        uint64_t current_nonce = evm_account.nonce; // Get current nonce
         action(
             permission_level{get_self(), "active"_n},
             eosio::name(EVM_SYSTEM_CONTRACT),
             "raw"_n,
             std::make_tuple(
                 get_self(),
-                rlp::encode(current_nonce, gas_price_val, SUCCESS_CB_GAS,
-                          conf.evm_bridge_address.extract_as_byte_array(),
-                          uint256_t(0), data, conf.evm_chain_id, 0, 0),
+                encodeEvmCall(current_nonce, gas_price_val, gas_limit,
+                              conf.evm_bridge_address.extract_as_byte_array(), data, evmChainId(conf)),
                 false,
-                std::optional<eosio::checksum160>(evm_account->address)
+                std::optional<eosio::checksum160>(evm_account.address)
             )
         ).send();
+
+        update_stats([&](bridgestats& s) {
+            s.gas_limit_spent += gas_limit;
+        });
     }
 }
\ No newline at end of file
@@ -0,0 +1,38 @@
+// Benchmark contract for the uint256 kernels (include_common/u256_kernels.hpp) in wasm.
+//
+// Runs the cases of u256_bench.hpp, the ones antelope-tools u256bench times on x86-64:
+//  - `verify` checks every kernel against the intx operators and fails on a mismatch
+//  - `bench` runs one case, generic intx form or kernel, and prints the checksum; the time is
+//    the elapsed of the action (benchU256.sh reads it from the trace)
+// Local chains only, it stores nothing.
+
+#include <eosio/eosio.hpp>
+#include <string>
+
+#include <intx/base.hpp>
+
+#include <u256_bench.hpp>
+
+using namespace eosio;
+using namespace evm_bridge;
+
+class [[eosio::contract("u256bench")]] u256bench : public contract {
+public:
+    using contract::contract;
+
+    [[eosio::action]] void verify() {
+        uint32_t failures = verifyU256Kernels([](const char* kernel, const uint256_t& x, uint64_t d) {
+            print(kernel, " mismatch: x.lo ", x.lo.lo, " d ", d, "\n");
+        });
+        check(failures == 0, std::to_string(failures) + " kernel mismatches");
+        print("verified\n");
+    }
+
+    [[eosio::action]] void bench(std::string kernel, bool fast, uint32_t iterations) {
+        const u256_bench_case* bench_case = findU256BenchCase(kernel);
+        check(bench_case != nullptr, "Unknown case " + kernel);
+        const u256_bench_inputs inputs;
+        uint64_t checksum = (fast ? bench_case->fast : bench_case->generic)(iterations, inputs);
+        print(kernel, fast ? " kernel" : " intx", " checksum ", checksum, "\n");
+    }
+};
@@ -0,0 +1,23 @@
+#!/bin/bash
+
+# Builds the host side tools (relayer / monitoring helpers) into ./build
+# Requires g++ with C++17 and the Boost headers (asio / beast)
+
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:-"-std=c++17 -O2 -Wall"}
+# external/ goes last so its trimmed boost copy does not shadow the system boost
+INCLUDES="-I./include/ -I../antelope-compile/include_common/ -idirafter ../antelope-compile/external/"
+
+# Create build directory if it doesn't exist
+if [ ! -d "$PWD/build" ]; then
+  mkdir -p build
+fi
+
+TOOLS=${@:-"shipmirror wasmsize bridgeaudit tracereplay cpupack loadgen u256bench preflight"}
+
+for TOOL in $TOOLS; do
+  echo ">>> Building $TOOL..."
+  $CXX $CXXFLAGS $INCLUDES -o "./build/$TOOL" "./src/$TOOL.cpp" -lpthread || exit 1
+done
+
+echo ">>> Build complete."
@@ -0,0 +1,165 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Minimal reader/writer for the Antelope binary (ABI) serialization used by the
+// state history plugin and by eosio.evm / evm.boid / xsend.boid table rows.
+namespace bridge_tools
+{
+  struct abi_error : std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+  // Non-owning view over a serialized `bytes` field
+  struct byte_view {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+  };
+
+  class abi_reader {
+    public:
+      abi_reader(const uint8_t* data, size_t size) : _pos(data), _end(data + size) {}
+      explicit abi_reader(byte_view view) : abi_reader(view.data, view.size) {}
+
+      size_t remaining() const { return static_cast<size_t>(_end - _pos); }
+      const uint8_t* position() const { return _pos; }
+
+      void read(uint8_t* out, size_t size) {
+        require(size);
+        std::memcpy(out, _pos, size);
+        _pos += size;
+      }
+
+      void skip(size_t size) {
+        require(size);
+        _pos += size;
+      }
+
+      // Fixed width little endian integers
+      template <typename T>
+      T read_raw() {
+        T value;
+        read(reinterpret_cast<uint8_t*>(&value), sizeof(T));
+        return value;
+      }
+
+      bool read_bool() { return read_raw<uint8_t>() != 0; }
+
+      uint32_t read_varuint32() {
+        uint32_t value = 0;
+        for (uint8_t shift = 0; shift < 35; shift += 7) {
+          uint8_t b = read_raw<uint8_t>();
+          value |= static_cast<uint32_t>(b & 0x7f) << shift;
+          if (!(b & 0x80)) return value;
+        }
+        throw abi_error("varuint32 is too long");
+      }
+
+      byte_view read_bytes() {
+        uint32_t size = read_varuint32();
+        require(size);
+        byte_view view{_pos, size};
+        _pos += size;
+        return view;
+      }
+
+      std::string read_string() {
+        byte_view view = read_bytes();
+        return std::string(reinterpret_cast<const char*>(view.data), view.size);
+      }
+
+      template <size_t N>
+      std::array<uint8_t, N> read_array() {
+        std::array<uint8_t, N> out;
+        read(out.data(), N);
+        return out;
+      }
+
+    private:
+      void require(size_t size) const {
+        if (remaining() < size) throw abi_error("unexpected end of stream");
+      }
+
+      const uint8_t* _pos;
+      const uint8_t* _end;
+  };
+
+  class abi_writer {
+    public:
+      template <typename T>
+      void write_raw(T value) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+        _buf.insert(_buf.end(), p, p + sizeof(T));
+      }
+
+      void write_bool(bool value) { write_raw<uint8_t>(value ? 1 : 0); }
+
+      void write_varuint32(uint32_t value) {
+        do {
+          uint8_t b = value & 0x7f;
+          value >>= 7;
+          if (value) b |= 0x80;
+          _buf.push_back(b);
+        } while (value);
+      }
+
+      void write(const uint8_t* data, size_t size) { _buf.insert(_buf.end(), data, data + size); }
+
+      void write_bytes(const uint8_t* data, size_t size) {
+        write_varuint32(static_cast<uint32_t>(size));
+        write(data, size);
+      }
+
+      void write_string(std::string_view s) {
+        write_bytes(reinterpret_cast<const uint8_t*>(s.data()), s.size());
+      }
+
+      const std::vector<uint8_t>& buffer() const { return _buf; }
+      std::vector<uint8_t>& buffer() { return _buf; }
+
+    private:
+      std::vector<uint8_t> _buf;
+  };
+
+  //======================== Antelope names ========================
+  constexpr uint64_t char_to_symbol(char c) {
+    if (c >= 'a' && c <= 'z') return (c - 'a') + 6;
+    if (c >= '1' && c <= '5') return (c - '1') + 1;
+    if (c == '.') return 0;
+    throw abi_error(std::string("invalid character in name: ") + c);
+  }
+
+  constexpr uint64_t string_to_name(std::string_view str) {
+    if (str.size() > 13) throw abi_error("name is longer than 13 characters");
+    uint64_t value = 0;
+    for (size_t i = 0; i < str.size() && i < 12; ++i) {
+      value |= (char_to_symbol(str[i]) & 0x1f) << (64 - 5 * (i + 1));
+    }
+    if (str.size() == 13) {
+      uint64_t last = char_to_symbol(str[12]);
+      if (last > 0x0f) throw abi_error("invalid 13th character in name");
+      value |= last;
+    }
+    return value;
+  }
+
+  inline std::string name_to_string(uint64_t value) {
+    static const char* charmap = ".12345abcdefghijklmnopqrstuvwxyz";
+    std::string str(13, '.');
+    uint64_t tmp = value;
+    for (uint32_t i = 0; i <= 12; ++i) {
+      char c = charmap[tmp & (i == 0 ? 0x0f : 0x1f)];
+      str[12 - i] = c;
+      tmp >>= (i == 0 ? 4 : 5);
+    }
+    str.erase(str.find_last_not_of('.') + 1);
+    return str;
+  }
+}
@@ -0,0 +1,281 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <bridge_storage.hpp>
+#include <hex_codec.hpp>
+#include "bridge_mirror.hpp"
+#include "work_pool.hpp"
+
+// Reconciliation of a bridge_mirror: every request id TokenBridge.sol handed out and every
+// evm.boid `requests` row (or settledids bit) against the Request stored in TokenBridge.sol, activeRequestIds
+// against activeRequestIndex and the evm.boid token balance against the requests it still
+// has to pay out. The state can also be a snapshot_view (state_snapshot.hpp), which has the
+// same queries.
+//
+// The mirror is only read, both passes run on a work_pool and every worker collects its
+// findings on its own, they are merged and sorted by request id at the end.
+namespace bridge_tools
+{
+  enum class audit_issue : uint8_t {
+    paid_still_on_evm,      // verifytrx paid out, the Request is still in TokenBridge.sol
+    notified_not_settled,   // reqnotify ran and the EVM removed the Request, never paid out
+    notified_still_on_evm,  // reqnotify ran, the EVM callback did not remove the Request
+    amount_mismatch,        // native row and EVM Request disagree on the amount
+    precision_loss,         // EVM amount is not a whole number of native units
+    pending_not_active,     // pending Request missing from activeRequestIds
+    active_without_request, // activeRequestIds entry with no Request behind it
+    active_index_mismatch,  // activeRequestIndex does not point back to the array entry
+    underfunded             // evm.boid balance below the amount of the unpaid requests
+  };
+  static constexpr size_t AUDIT_ISSUE_COUNT = static_cast<size_t>(audit_issue::underfunded) + 1;
+
+  inline const char* to_string(audit_issue issue) {
+    switch (issue) {
+      case audit_issue::paid_still_on_evm:      return "paid_still_on_evm";
+      case audit_issue::notified_not_settled:   return "notified_not_settled";
+      case audit_issue::notified_still_on_evm:  return "notified_still_on_evm";
+      case audit_issue::amount_mismatch:        return "amount_mismatch";
+      case audit_issue::precision_loss:         return "precision_loss";
+      case audit_issue::pending_not_active:     return "pending_not_active";
+      case audit_issue::active_without_request: return "active_without_request";
+      case audit_issue::active_index_mismatch:  return "active_index_mismatch";
+      default:                                  return "underfunded";
+    }
+  }
+
+  struct audit_finding {
+    uint64_t request_id;
+    audit_issue issue;
+    std::string detail;
+  };
+
+  struct audit_options {
+    uint8_t native_decimals = 4;
+    uint64_t token_symbol = 0; // symbol code of the bridged token, 0 = no balance check
+    size_t chunk = 4096;       // ids per work_pool chunk
+  };
+
+  struct audit_report {
+    uint64_t requests_checked = 0;
+    uint64_t active_checked = 0;
+    uint64_t unpaid_amount = 0; // native units owed by evm.boid (notified, not processed)
+    std::array<uint64_t, AUDIT_ISSUE_COUNT> counts = {};
+    std::vector<audit_finding> findings;
+
+    uint64_t total() const {
+      uint64_t sum = 0;
+      for (uint64_t count : counts) sum += count;
+      return sum;
+    }
+  };
+
+  // Symbol code as stored in eosio.token `accounts` (characters from the lowest byte up)
+  inline uint64_t symbol_code_value(const std::string& code) {
+    if (code.empty() || code.size() > 7) throw abi_error("invalid symbol code " + code);
+    uint64_t value = 0;
+    for (size_t i = 0; i < code.size(); ++i) {
+      if (code[i] < 'A' || code[i] > 'Z') throw abi_error("invalid symbol code " + code);
+      value |= static_cast<uint64_t>(code[i]) << (8 * i);
+    }
+    return value;
+  }
+
+  template<typename State>
+  class basic_bridge_audit {
+    public:
+      basic_bridge_audit(const State& state, evm_bridge::request_layout layout, audit_options options)
+        : _state(state), _layout(layout), _options(options) {}
+
+      audit_report run(work_pool& pool) const {
+        std::vector<partial> partials(pool.threads());
+        const storage_word* length_word = _state.storage(evm_bridge::slotKey(evm_bridge::ACTIVE_REQUEST_IDS_SLOT));
+        uint64_t active_length = length_word ? evm_bridge::wordToUint64(*length_word) : 0;
+        const storage_word active_base = evm_bridge::arrayBaseKey(evm_bridge::ACTIVE_REQUEST_IDS_SLOT);
+
+        // 1. activeRequestIds entries, also collects the ids only known to the EVM side
+        pool.run(active_length, _options.chunk, [&](size_t begin, size_t end, unsigned worker) {
+          for (size_t i = begin; i < end; ++i) check_active_entry(active_base, i, partials[worker]);
+        });
+
+        // keccak dominates the run time, pass 2 looks the active ids up here instead of
+        // hashing its way through activeRequestIndex again
+        std::vector<uint64_t> active_ids;
+        active_ids.reserve(active_length);
+        for (const auto& p : partials) active_ids.insert(active_ids.end(), p.active_ids.begin(), p.active_ids.end());
+        std::sort(active_ids.begin(), active_ids.end());
+
+        // Every id TokenBridge.sol handed out, a Request that is in neither the native table nor
+        // activeRequestIds can only be found this way (mapping keys cannot be enumerated)
+        uint64_t next_id = std::max<uint64_t>(word_at(evm_bridge::slotKey(evm_bridge::NEXT_REQUEST_ID_SLOT)), 1);
+        std::vector<uint64_t> ids;
+        ids.reserve(next_id - 1);
+        for (uint64_t id = 1; id < next_id; ++id) ids.push_back(id);
+        std::vector<uint64_t> extra;
+        auto outside = [&](uint64_t id) { if (id == 0 || id >= next_id) extra.push_back(id); };
+        _state.for_each_request_id(outside);
+        for (uint64_t id : active_ids) outside(id);
+        std::sort(extra.begin(), extra.end());
+        extra.erase(std::unique(extra.begin(), extra.end()), extra.end());
+        ids.insert(ids.end(), extra.begin(), extra.end());
+
+        // 2. Every request id known to either side
+        pool.run(ids.size(), _options.chunk, [&](size_t begin, size_t end, unsigned worker) {
+          for (size_t i = begin; i < end; ++i) check_request(ids[i], active_ids, partials[worker]);
+        });
+
+        audit_report report;
+        report.requests_checked = ids.size();
+        report.active_checked = active_length;
+        for (auto& p : partials) {
+          report.unpaid_amount += p.unpaid_amount;
+          for (size_t i = 0; i < AUDIT_ISSUE_COUNT; ++i) report.counts[i] += p.counts[i];
+          std::move(p.findings.begin(), p.findings.end(), std::back_inserter(report.findings));
+        }
+
+        if (_options.token_symbol) {
+          const int64_t* balance = _state.native_balance(_options.token_symbol);
+          int64_t held = balance ? *balance : 0;
+          if (held < 0 || static_cast<uint64_t>(held) < report.unpaid_amount) {
+            report.counts[static_cast<size_t>(audit_issue::underfunded)]++;
+            report.findings.push_back({0, audit_issue::underfunded,
+              "balance " + std::to_string(held) + " < unpaid " + std::to_string(report.unpaid_amount)});
+          }
+        }
+
+        std::sort(report.findings.begin(), report.findings.end(), [](const audit_finding& a, const audit_finding& b) {
+          return a.request_id != b.request_id ? a.request_id < b.request_id : a.issue < b.issue;
+        });
+        return report;
+      }
+
+    private:
+      struct partial {
+        std::vector<audit_finding> findings;
+        std::array<uint64_t, AUDIT_ISSUE_COUNT> counts = {};
+        std::vector<uint64_t> active_ids;
+        uint64_t unpaid_amount = 0;
+
+        void add(uint64_t id, audit_issue issue, std::string detail) {
+          counts[static_cast<size_t>(issue)]++;
+          findings.push_back({id, issue, std::move(detail)});
+        }
+      };
+
+      // What TokenBridge.sol stores for one request
+      struct evm_request {
+        bool present = false;
+        bool pending = false;
+        bool amount_valid = false; // amount fits a native amount without rounding
+        uint64_t amount = 0;       // native units
+        storage_word raw_amount = {};
+      };
+
+      uint64_t word_at(const storage_word& key) const {
+        const storage_word* value = _state.storage(key);
+        return value ? evm_bridge::wordToUint64(*value) : 0;
+      }
+
+      evm_request read_request(uint64_t id) const {
+        evm_request req;
+        storage_word base = evm_bridge::mappingKey(id, evm_bridge::REQUESTS_MAPPING_SLOT);
+        bool v2 = _layout == evm_bridge::REQUEST_LAYOUT_V2;
+        uint8_t slots = v2 ? uint8_t(evm_bridge::REQUEST_V2_SLOT_COUNT) : uint8_t(evm_bridge::REQUEST_SLOT_COUNT);
+        for (uint8_t s = 0; s < slots && !req.present; ++s) req.present = _state.storage(evm_bridge::addToKey(base, s)) != nullptr;
+        if (!req.present) return req;
+
+        // Zero words are not stored, a missing slot reads as 0 (Pending, amount 0)
+        const storage_word zero = {};
+        const storage_word* status = _state.storage(evm_bridge::addToKey(base, v2 ? uint8_t(evm_bridge::REQUEST_V2_SLOT_AMOUNT) : uint8_t(evm_bridge::REQUEST_SLOT_PACKED)));
+        req.pending = evm_bridge::requestStatus(status ? *status : zero, _layout) == evm_bridge::REQUEST_STATUS_PENDING;
+
+        if (v2) {
+          req.raw_amount = status ? *status : zero;
+          req.amount = evm_bridge::amountSlotAmount(req.raw_amount);
+          req.amount_valid = true;
+          return req;
+        }
+
+        const storage_word* amount = _state.storage(evm_bridge::addToKey(base, evm_bridge::REQUEST_SLOT_AMOUNT));
+        req.raw_amount = amount ? *amount : zero;
+        uint8_t evm_decimals = status ? evm_bridge::packedDecimals(*status) : 0;
+        if (evm_decimals < _options.native_decimals) return req;
+        uint64_t divisor = 1;
+        for (uint8_t i = _options.native_decimals; i < evm_decimals; ++i) divisor *= 10;
+        req.amount_valid = divide(req.raw_amount, divisor, req.amount);
+        return req;
+      }
+
+      // Big-endian 256 bit value / divisor, false when there is a remainder or the quotient does not fit 64 bits
+      static bool divide(const storage_word& value, uint64_t divisor, uint64_t& quotient) {
+        unsigned __int128 remainder = 0;
+        quotient = 0;
+        bool fits = true;
+        for (uint8_t byte : value) {
+          remainder = (remainder << 8) | byte;
+          unsigned __int128 digit = remainder / divisor;
+          remainder %= divisor;
+          if (quotient >> 56) fits = false;
+          quotient = (quotient << 8) | static_cast<uint64_t>(digit);
+        }
+        return fits && remainder == 0;
+      }
+
+      // activeRequestIds[i] is indexed back by activeRequestIndex (that it points at a Request is checked in pass 2)
+      void check_active_entry(const storage_word& active_base, uint64_t i, partial& out) const {
+        uint64_t id = word_at(evm_bridge::addToKey(active_base, i));
+        out.active_ids.push_back(id);
+
+        uint64_t index = word_at(evm_bridge::mappingKey(id, evm_bridge::ACTIVE_REQUEST_INDEX_SLOT));
+        if (index != i) {
+          out.add(id, audit_issue::active_index_mismatch, "activeRequestIds[" + std::to_string(i) + "], activeRequestIndex " + std::to_string(index));
+        }
+      }
+
+      void check_request(uint64_t id, const std::vector<uint64_t>& active_ids, partial& out) const {
+        auto native = _state.request(id);
+        evm_request evm = read_request(id);
+
+        if (native) {
+          if (!native->processed) out.unpaid_amount += native->amount;
+          if (native->processed && evm.present) {
+            out.add(id, audit_issue::paid_still_on_evm, "amount " + std::to_string(native->amount));
+          } else if (!native->processed && !evm.present) {
+            out.add(id, audit_issue::notified_not_settled, "amount " + std::to_string(native->amount) + " receiver " + name_to_string(native->receiver));
+          } else if (!native->processed) {
+            out.add(id, audit_issue::notified_still_on_evm, "amount " + std::to_string(native->amount));
+          }
+          if (evm.present && evm.amount_valid && evm.amount != native->amount) {
+            out.add(id, audit_issue::amount_mismatch, "native " + std::to_string(native->amount) + " evm " + std::to_string(evm.amount));
+          }
+        } else if (evm.present && _state.settled_in_ledger(id)) {
+          // Settled rows are erased, only the settledids bit is left
+          out.add(id, audit_issue::paid_still_on_evm, "settled in settledids");
+        }
+
+        bool active = std::binary_search(active_ids.begin(), active_ids.end(), id);
+        if (!evm.present) {
+          if (active) out.add(id, audit_issue::active_without_request, "");
+          return;
+        }
+        if (!evm.amount_valid) {
+          out.add(id, audit_issue::precision_loss, "evm amount 0x" + evm_bridge::toHex(evm.raw_amount));
+        }
+        if (evm.pending && !active) {
+          out.add(id, audit_issue::pending_not_active, "");
+        }
+      }
+
+      const State& _state;
+      evm_bridge::request_layout _layout;
+      audit_options _options;
+  };
+
+  using bridge_audit = basic_bridge_audit<bridge_mirror>;
+}
@@ -0,0 +1,351 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include <bridge_storage.hpp>
+#include <settled_ledger.hpp>
+#include "abi_stream.hpp"
+
+// In-memory mirror of the bridge state, fed with state history table deltas.
+//
+// Tracks three tables:
+//  - eosio.evm   accountstate (scope = EVM account index of TokenBridge.sol), keyed like `bykey`
+//  - eosio.evm   account      (to resolve the bridge scope and the nonce of evm.boid)
+//  - evm.boid    requests     (requests notified on the native side, plus processed rows of older builds)
+//  - evm.boid    settledids   (bitmap of the settled request ids, their rows are erased on settlement)
+//  - optionally the `accounts` rows of the native token contract scoped to evm.boid (its balances)
+//  - xsend.boid  fees         (bridge fees paid and not used yet)
+namespace bridge_tools
+{
+  using evm_bridge::storage_word;
+
+  struct word_hash {
+    // Storage keys are keccak hashes (or small slot numbers), mix the first and last word.
+    size_t operator()(const storage_word& w) const {
+      uint64_t a, b;
+      std::memcpy(&a, w.data(), 8);
+      std::memcpy(&b, w.data() + 24, 8);
+      return static_cast<size_t>(a ^ (b * 0x9E3779B97F4A7C15ULL));
+    }
+  };
+
+  struct evm_account_row {
+    uint64_t index = 0;
+    std::array<uint8_t, 20> address = {};
+    uint64_t account = 0;
+    uint64_t nonce = 0;
+  };
+
+  struct native_request_row {
+    uint64_t request_id = 0;
+    int64_t timestamp_us = 0;
+    bool processed = false;
+    uint64_t amount = 0;
+    uint64_t receiver = 0;
+    std::string sender;
+    std::string memo;
+  };
+
+  // xsend.boid fee_record
+  struct fee_row {
+    uint64_t id = 0;
+    uint64_t user = 0;
+    int64_t amount = 0;
+    uint64_t symbol = 0;
+    uint64_t token_contract = 0;
+    uint32_t created_at = 0;
+  };
+
+  enum class request_state : uint8_t {
+    unknown,  // not on the EVM and never seen on the native side
+    pending,  // stored in TokenBridge.sol with status Pending, reqnotify not run yet
+    notified, // reqnotify done, waiting for verifytrx
+    settled   // verifytrx paid out the native tokens
+  };
+
+  inline const char* to_string(request_state state) {
+    switch (state) {
+      case request_state::pending:  return "pending";
+      case request_state::notified: return "notified";
+      case request_state::settled:  return "settled";
+      default:                      return "unknown";
+    }
+  }
+
+  struct mirror_config {
+    uint64_t evm_contract = string_to_name("eosio.evm");
+    uint64_t bridge_contract = string_to_name("evm.boid");
+    // EVM account index of TokenBridge.sol, 0 = resolve it from bridge_address
+    uint64_t bridge_scope = 0;
+    std::array<uint8_t, 20> bridge_address = {};
+    // Request struct of the deployed TokenBridge.sol (request_layout in evm.boid bridgeconfig)
+    evm_bridge::request_layout layout = evm_bridge::REQUEST_LAYOUT_V1;
+    // Token contract whose balances of bridge_contract are tracked, 0 = not tracked
+    uint64_t token_contract = 0;
+    uint64_t fees_contract = string_to_name("xsend.boid");
+  };
+
+  //======================== Rows ========================
+  // Decoders shared by the mirror and the snapshot overlay (state_snapshot.hpp)
+
+  // Account { index, address, account, nonce, code, balance } - code and balance are not needed
+  inline evm_account_row decode_account(abi_reader& ds) {
+    evm_account_row row;
+    row.index = ds.read_raw<uint64_t>();
+    row.address = ds.read_array<20>();
+    row.account = ds.read_raw<uint64_t>();
+    row.nonce = ds.read_raw<uint64_t>();
+    return row;
+  }
+
+  // requests { request_id, timestamp, processed, amount, receiver, sender, memo }
+  inline native_request_row decode_request(abi_reader& ds) {
+    native_request_row row;
+    row.request_id = ds.read_raw<uint64_t>();
+    row.timestamp_us = ds.read_raw<int64_t>();
+    row.processed = ds.read_bool();
+    row.amount = ds.read_raw<uint64_t>();
+    row.receiver = ds.read_raw<uint64_t>();
+    row.sender = ds.read_string();
+    row.memo = ds.read_string();
+    return row;
+  }
+
+  // fee_record { id, user, amount, token_contract, created_at }
+  inline fee_row decode_fee(abi_reader& ds) {
+    fee_row row;
+    row.id = ds.read_raw<uint64_t>();
+    row.user = ds.read_raw<uint64_t>();
+    row.amount = ds.read_raw<int64_t>();
+    row.symbol = ds.read_raw<uint64_t>();
+    row.token_contract = ds.read_raw<uint64_t>();
+    row.created_at = ds.read_raw<uint32_t>();
+    return row;
+  }
+
+  static constexpr uint64_t ACCOUNT_TABLE = string_to_name("account");
+  static constexpr uint64_t ACCOUNTSTATE_TABLE = string_to_name("accountstate");
+  static constexpr uint64_t REQUESTS_TABLE = string_to_name("requests");
+  static constexpr uint64_t SETTLEDIDS_TABLE = string_to_name("settledids");
+  static constexpr uint64_t ACCOUNTS_TABLE = string_to_name("accounts");
+  static constexpr uint64_t FEES_TABLE = string_to_name("fees");
+
+  // Calls the handler for every tracked row of a get_blocks_result `deltas` (vector<table_delta>):
+  //   on_account(present, primary_key, evm_account_row)
+  //   on_storage(present, primary_key, key, value)      accountstate of the bridge scope
+  //   on_request(present, primary_key, native_request_row)
+  //   on_settled(present, word_index, bits)
+  //   on_balance(present, symbol_code, amount)
+  //   on_fee(present, primary_key, fee_row)
+  // Removed rows come with their last value. The bridge scope is read from the handler's
+  // config() on every row, it can be resolved by on_account in the middle of a block.
+  // An empty buffer is a block without deltas (captures keep a record for every block).
+  template<typename Handler>
+  void for_each_tracked_row(const uint8_t* data, size_t size, Handler& handler) {
+    if (size == 0) return;
+    abi_reader deltas(data, size);
+    uint32_t count = deltas.read_varuint32();
+    for (uint32_t i = 0; i < count; ++i) {
+      uint32_t version = deltas.read_varuint32();
+      if (version != 0) throw abi_error("unsupported table_delta version " + std::to_string(version));
+      bool contract_rows = deltas.read_string() == "contract_row";
+      uint32_t rows = deltas.read_varuint32();
+      for (uint32_t r = 0; r < rows; ++r) {
+        bool present = deltas.read_bool();
+        byte_view row = deltas.read_bytes();
+        if (!contract_rows) continue;
+
+        abi_reader ds(row);
+        if (ds.read_varuint32() != 0) throw abi_error("unsupported contract_row version");
+        uint64_t code = ds.read_raw<uint64_t>();
+        uint64_t scope = ds.read_raw<uint64_t>();
+        uint64_t table = ds.read_raw<uint64_t>();
+        uint64_t primary_key = ds.read_raw<uint64_t>();
+        ds.skip(8); // payer
+        abi_reader value(ds.read_bytes());
+
+        const mirror_config& config = handler.config();
+        if (code == config.evm_contract) {
+          if (table == ACCOUNT_TABLE) {
+            handler.on_account(present, primary_key, decode_account(value));
+          } else if (table == ACCOUNTSTATE_TABLE && scope == config.bridge_scope && scope != 0) {
+            value.skip(8); // index, same as the primary key
+            storage_word key = value.read_array<32>();
+            handler.on_storage(present, primary_key, key, value.read_array<32>());
+          }
+        } else if (code == config.bridge_contract && scope == config.bridge_contract && table == REQUESTS_TABLE) {
+          handler.on_request(present, primary_key, decode_request(value));
+        } else if (code == config.bridge_contract && scope == config.bridge_contract && table == SETTLEDIDS_TABLE) {
+          value.skip(8); // word_index, same as the primary key
+          handler.on_settled(present, primary_key, value.read_raw<uint64_t>());
+        } else if (code == config.token_contract && scope == config.bridge_contract && table == ACCOUNTS_TABLE) {
+          handler.on_balance(present, primary_key, value.read_raw<int64_t>()); // account { asset balance }
+        } else if (code == config.fees_contract && scope == config.fees_contract && table == FEES_TABLE) {
+          handler.on_fee(present, primary_key, decode_fee(value));
+        }
+        handler.on_row();
+      }
+    }
+  }
+
+  class bridge_mirror {
+    public:
+      explicit bridge_mirror(mirror_config config) : _config(config) {}
+
+      // Applies the `deltas` field of a get_blocks_result (vector<table_delta>)
+      void apply_deltas(const uint8_t* data, size_t size) {
+        for_each_tracked_row(data, size, *this);
+      }
+
+      //======================== Queries ========================
+      // O(1): one keccak for the mapping key, then hash lookups only
+      request_state state_of(uint64_t req_id) const {
+        auto native = _requests.find(req_id);
+        if (native != _requests.end()) {
+          return native->second.processed ? request_state::settled : request_state::notified;
+        }
+        if (settled_in_ledger(req_id)) return request_state::settled;
+        const storage_word* status = storage(evm_bridge::requestStatusKey(req_id, _config.layout));
+        if (status && evm_bridge::requestStatus(*status, _config.layout) == evm_bridge::REQUEST_STATUS_PENDING &&
+            storage(evm_bridge::mappingKey(req_id, evm_bridge::REQUESTS_MAPPING_SLOT))) {
+          return request_state::pending;
+        }
+        return request_state::unknown;
+      }
+
+      bool is_pending(uint64_t req_id) const { return state_of(req_id) == request_state::pending; }
+      bool is_notified(uint64_t req_id) const { return state_of(req_id) == request_state::notified; }
+      bool is_settled(uint64_t req_id) const { return state_of(req_id) == request_state::settled; }
+
+      const storage_word* storage(const storage_word& key) const {
+        auto it = _storage.find(key);
+        return it == _storage.end() ? nullptr : &it->second;
+      }
+
+      // Bit of the id in evm.boid settledids
+      bool settled_in_ledger(uint64_t req_id) const {
+        auto it = _settled.find(evm_bridge::settledWordIndex(req_id));
+        return it != _settled.end() && (it->second & evm_bridge::settledBit(req_id)) != 0;
+      }
+
+      const native_request_row* request(uint64_t req_id) const {
+        auto it = _requests.find(req_id);
+        return it == _requests.end() ? nullptr : &it->second;
+      }
+
+      const evm_account_row* account_by_name(uint64_t account) const {
+        auto it = _accounts_by_name.find(account);
+        if (it == _accounts_by_name.end()) return nullptr;
+        auto row = _accounts.find(it->second);
+        return row == _accounts.end() ? nullptr : &row->second;
+      }
+
+      // Balance of bridge_contract in the tracked token contract, by symbol code (primary key of `accounts`)
+      const int64_t* native_balance(uint64_t symbol_code) const {
+        auto it = _balances.find(symbol_code);
+        return it == _balances.end() ? nullptr : &it->second;
+      }
+
+      const fee_row* fee(uint64_t id) const {
+        auto it = _fees.find(id);
+        return it == _fees.end() ? nullptr : &it->second;
+      }
+
+      template<typename F>
+      void for_each_request_id(F&& f) const {
+        for (const auto& entry : _requests) f(entry.first);
+      }
+
+      const std::unordered_map<uint64_t, native_request_row>& requests() const { return _requests; }
+      const std::unordered_map<uint64_t, storage_word>& storage_keys() const { return _storage_keys; }
+      const std::unordered_map<uint64_t, evm_account_row>& accounts() const { return _accounts; }
+      const std::unordered_map<uint64_t, uint64_t>& settled_words() const { return _settled; }
+      const std::unordered_map<uint64_t, int64_t>& balances() const { return _balances; }
+      const std::unordered_map<uint64_t, fee_row>& fees() const { return _fees; }
+      uint64_t bridge_scope() const { return _config.bridge_scope; }
+      size_t storage_size() const { return _storage.size(); }
+      size_t account_count() const { return _accounts.size(); }
+      uint64_t rows_applied() const { return _rows_applied; }
+
+      //======================== Row handlers (for_each_tracked_row) ========================
+      // Also used to seed the mirror from a snapshot
+      const mirror_config& config() const { return _config; }
+
+      void on_account(bool present, uint64_t primary_key, const evm_account_row& row) {
+        if (!present) {
+          _accounts.erase(primary_key);
+          _accounts_by_name.erase(row.account);
+          return;
+        }
+        if (row.account) _accounts_by_name[row.account] = primary_key;
+        _accounts[primary_key] = row;
+
+        if (_config.bridge_scope == 0 && row.address == _config.bridge_address) {
+          _config.bridge_scope = row.index;
+        }
+      }
+
+      void on_storage(bool present, uint64_t primary_key, const storage_word& key, const storage_word& value) {
+        auto previous = _storage_keys.find(primary_key);
+        if (previous != _storage_keys.end() && previous->second != key) _storage.erase(previous->second);
+
+        if (!present) {
+          _storage.erase(key);
+          _storage_keys.erase(primary_key);
+          return;
+        }
+        _storage[key] = value;
+        _storage_keys[primary_key] = key;
+      }
+
+      void on_request(bool present, uint64_t primary_key, native_request_row row) {
+        if (!present) {
+          _requests.erase(primary_key);
+          return;
+        }
+        _requests[primary_key] = std::move(row);
+      }
+
+      void on_settled(bool present, uint64_t word_index, uint64_t bits) {
+        if (!present) {
+          _settled.erase(word_index);
+          return;
+        }
+        _settled[word_index] = bits;
+      }
+
+      void on_balance(bool present, uint64_t symbol_code, int64_t amount) {
+        if (!present) {
+          _balances.erase(symbol_code);
+          return;
+        }
+        _balances[symbol_code] = amount;
+      }
+
+      void on_fee(bool present, uint64_t primary_key, const fee_row& row) {
+        if (!present) {
+          _fees.erase(primary_key);
+          return;
+        }
+        _fees[primary_key] = row;
+      }
+
+      void on_row() { ++_rows_applied; }
+
+    private:
+      mirror_config _config;
+      std::unordered_map<storage_word, storage_word, word_hash> _storage; // bykey -> value
+      std::unordered_map<uint64_t, storage_word> _storage_keys;         // accountstate primary key -> key
+      std::unordered_map<uint64_t, evm_account_row> _accounts;
+      std::unordered_map<uint64_t, uint64_t> _accounts_by_name;
+      std::unordered_map<uint64_t, native_request_row> _requests;
+      std::unordered_map<uint64_t, uint64_t> _settled;                   // settledids word_index -> bits
+      std::unordered_map<uint64_t, int64_t> _balances;
+      std::unordered_map<uint64_t, fee_row> _fees;
+      uint64_t _rows_applied = 0;
+  };
+}
@@ -0,0 +1,253 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include <hex_codec.hpp>
+
+#include "abi_stream.hpp"
+#include "sha256.hpp"
+
+// Minimal nodeos / keosd HTTP client for the tools that push transactions (loadgen).
+//
+// Transactions are packed here, signed by keosd (`/v1/wallet/sign_transaction`, the key never
+// leaves the wallet) and pushed packed, so the transaction id (sha256 of the packed
+// transaction) is known before it reaches the chain. Only the few response fields the tools
+// need are read, there is no general JSON parser.
+namespace bridge_tools
+{
+  class chain_error : public std::runtime_error {
+    public:
+      using std::runtime_error::runtime_error;
+  };
+
+  //======================== HTTP ========================
+  struct http_endpoint {
+    std::string host;
+    std::string port;
+
+    // "host:port"
+    static http_endpoint parse(const std::string& text) {
+      size_t colon = text.rfind(':');
+      if (colon == std::string::npos) throw chain_error("expected host:port, got " + text);
+      return {text.substr(0, colon), text.substr(colon + 1)};
+    }
+  };
+
+  // Blocking keep-alive HTTP/1.1 client, one per thread. A request that fails on a kept-alive
+  // connection (closed by the server in between) is sent once more on a new connection.
+  class http_client {
+    public:
+      explicit http_client(const http_endpoint& endpoint) : _host(endpoint.host), _port(endpoint.port) {}
+
+      // POST body to target, returns the status code and fills response
+      unsigned post(const std::string& target, const std::string& body, std::string& response) {
+        for (int attempt = 0;; ++attempt) {
+          try {
+            if (!_stream) connect();
+            return send(target, body, response);
+          } catch (const boost::system::system_error& e) {
+            _stream.reset();
+            if (attempt == 1) throw chain_error("http " + _host + ":" + _port + target + ": " + e.what());
+          }
+        }
+      }
+
+    private:
+      using tcp = boost::asio::ip::tcp;
+
+      void connect() {
+        tcp::resolver resolver(_ioc);
+        _stream = std::make_unique<boost::beast::tcp_stream>(_ioc);
+        _stream->connect(resolver.resolve(_host, _port));
+        _stream->socket().set_option(tcp::no_delay(true)); // latencies are measured through it
+      }
+
+      unsigned send(const std::string& target, const std::string& body, std::string& response) {
+        namespace http = boost::beast::http;
+        http::request<http::string_body> req{http::verb::post, target, 11};
+        req.set(http::field::host, _host);
+        req.set(http::field::content_type, "application/json");
+        req.keep_alive(true);
+        req.body() = body;
+        req.prepare_payload();
+        http::write(*_stream, req);
+
+        boost::beast::flat_buffer buffer;
+        http::response<http::string_body> res;
+        http::read(*_stream, buffer, res);
+        if (!res.keep_alive()) _stream.reset();
+        response = std::move(res.body());
+        return res.result_int();
+      }
+
+      std::string _host;
+      std::string _port;
+      boost::asio::io_context _ioc;
+      std::unique_ptr<boost::beast::tcp_stream> _stream;
+  };
+
+  //======================== JSON fields ========================
+  // Value of the first "key" at or after `from`: the characters of a string (escapes are kept),
+  // or the raw token of a number / literal. Empty when the key is missing.
+  inline std::string json_field(const std::string& json, const std::string& key, size_t from = 0) {
+    size_t pos = json.find("\"" + key + "\"", from);
+    if (pos == std::string::npos) return {};
+    pos = json.find(':', pos + key.size() + 2);
+    if (pos == std::string::npos) return {};
+    pos = json.find_first_not_of(" \t\r\n", pos + 1);
+    if (pos == std::string::npos) return {};
+    if (json[pos] == '[') pos = json.find_first_not_of(" \t\r\n", pos + 1); // first element of an array
+    if (pos == std::string::npos) return {};
+    if (json[pos] == '"') {
+      size_t end = pos + 1;
+      while (end < json.size() && json[end] != '"') end += json[end] == '\\' ? 2 : 1;
+      return json.substr(pos + 1, end - pos - 1);
+    }
+    size_t end = json.find_first_of(",}] \t\r\n", pos);
+    return json.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+  }
+
+  // The message of a nodeos / keosd error response ({"error": {"what", "details": [{"message"}]}})
+  inline std::string json_error(const std::string& json) {
+    size_t error = json.find("\"error\"");
+    if (error == std::string::npos) return json.substr(0, 200);
+    std::string what = json_field(json, "what", error);
+    size_t details = json.find("\"details\"", error);
+    std::string detail = details == std::string::npos ? std::string() : json_field(json, "message", details);
+    return detail.empty() ? what : what + ": " + detail;
+  }
+
+  //======================== Transactions ========================
+  struct chain_action {
+    uint64_t account = 0;
+    uint64_t name = 0;
+    uint64_t actor = 0;            // signs with actor@active
+    std::vector<uint8_t> data;     // packed action data
+  };
+
+  struct chain_transaction {
+    uint32_t expiration = 0;       // unix seconds
+    uint16_t ref_block_num = 0;
+    uint32_t ref_block_prefix = 0;
+    std::vector<chain_action> actions;
+
+    std::vector<uint8_t> pack() const {
+      abi_writer w;
+      w.write_raw<uint32_t>(expiration);
+      w.write_raw<uint16_t>(ref_block_num);
+      w.write_raw<uint32_t>(ref_block_prefix);
+      w.write_varuint32(0);       // max_net_usage_words
+      w.write_raw<uint8_t>(0);    // max_cpu_usage_ms
+      w.write_varuint32(0);       // delay_sec
+      w.write_varuint32(0);       // context_free_actions
+      w.write_varuint32(static_cast<uint32_t>(actions.size()));
+      for (const auto& act : actions) {
+        w.write_raw<uint64_t>(act.account);
+        w.write_raw<uint64_t>(act.name);
+        w.write_varuint32(1);
+        w.write_raw<uint64_t>(act.actor);
+        w.write_raw<uint64_t>(string_to_name("active"));
+        w.write_bytes(act.data.data(), act.data.size());
+      }
+      w.write_varuint32(0);       // transaction_extensions
+      return w.buffer();
+    }
+
+    // The JSON form keosd signs, action data stays hex since keosd has no ABI
+    std::string to_json() const {
+      char time[32];
+      std::time_t t = expiration;
+      std::tm tm;
+      gmtime_r(&t, &tm);
+      std::strftime(time, sizeof(time), "%Y-%m-%dT%H:%M:%S", &tm);
+
+      std::string json = "{\"expiration\":\"" + std::string(time) + "\",\"ref_block_num\":" + std::to_string(ref_block_num) +
+        ",\"ref_block_prefix\":" + std::to_string(ref_block_prefix) +
+        ",\"max_net_usage_words\":0,\"max_cpu_usage_ms\":0,\"delay_sec\":0,\"context_free_actions\":[],\"actions\":[";
+      for (size_t i = 0; i < actions.size(); ++i) {
+        const auto& act = actions[i];
+        if (i) json += ",";
+        json += "{\"account\":\"" + name_to_string(act.account) + "\",\"name\":\"" + name_to_string(act.name) +
+          "\",\"authorization\":[{\"actor\":\"" + name_to_string(act.actor) + "\",\"permission\":\"active\"}],\"data\":\"" +
+          evm_bridge::toHex(act.data.data(), act.data.size()) + "\"}";
+      }
+      return json + "],\"transaction_extensions\":[]}";
+    }
+  };
+
+  // A signed transaction ready to push
+  struct signed_transaction {
+    sha256_digest id = {};
+    std::vector<uint8_t> packed;
+    std::string signature;
+  };
+
+  struct chain_info {
+    std::string chain_id;
+    uint32_t head_block_num = 0;
+    uint16_t ref_block_num = 0;    // TaPoS from the last irreversible block
+    uint32_t ref_block_prefix = 0;
+  };
+
+  //======================== API ========================
+  class chain_api {
+    public:
+      chain_api(const http_endpoint& node, const http_endpoint& wallet) : _node(node), _wallet(wallet) {}
+
+      chain_info get_info() {
+        std::string body = call(_node, "/v1/chain/get_info", "{}");
+        chain_info info;
+        info.chain_id = json_field(body, "chain_id");
+        info.head_block_num = static_cast<uint32_t>(std::stoul(json_field(body, "head_block_num")));
+        std::string lib_id = json_field(body, "last_irreversible_block_id");
+        uint8_t id[32];
+        if (lib_id.size() != 64 || !evm_bridge::decodeHex(lib_id.data(), 32, id)) throw chain_error("bad get_info response");
+        // ref_block_num is the low 16 bits of the block number (big endian in the id),
+        // ref_block_prefix the third 32 bit word of the id read little endian
+        info.ref_block_num = static_cast<uint16_t>(id[2] << 8 | id[3]);
+        info.ref_block_prefix = uint32_t(id[8]) | uint32_t(id[9]) << 8 | uint32_t(id[10]) << 16 | uint32_t(id[11]) << 24;
+        return info;
+      }
+
+      signed_transaction sign(const chain_transaction& trx, const std::string& public_key, const std::string& chain_id) {
+        std::string body = call(_wallet, "/v1/wallet/sign_transaction",
+          "[" + trx.to_json() + ",[\"" + public_key + "\"],\"" + chain_id + "\"]");
+        signed_transaction out;
+        out.packed = trx.pack();
+        out.id = sha256::hash(out.packed);
+        out.signature = json_field(body, "signatures");
+        if (out.signature.empty()) throw chain_error("keosd returned no signature");
+        return out;
+      }
+
+      // Pushes and waits for the node to execute it, returns the transaction id it reports
+      std::string push(const signed_transaction& trx) {
+        std::string body = call(_node, "/v1/chain/push_transaction",
+          "{\"signatures\":[\"" + trx.signature + "\"],\"compression\":\"none\",\"packed_context_free_data\":\"\",\"packed_trx\":\"" +
+          evm_bridge::toHex(trx.packed.data(), trx.packed.size()) + "\"}");
+        return json_field(body, "transaction_id");
+      }
+
+    private:
+      static std::string call(http_client& client, const std::string& target, const std::string& request) {
+        std::string response;
+        unsigned status = client.post(target, request, response);
+        if (status != 200 && status != 201 && status != 202) throw chain_error(target + ": " + json_error(response));
+        return response;
+      }
+
+      http_client _node;
+      http_client _wallet;
+  };
+}
@@ -0,0 +1,265 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "abi_stream.hpp"
+
+// CPU cost model and transaction packer for the relayer's reqnotify / verifytrx submissions.
+//
+// The billed CPU of a transaction is modelled as
+//   cpu_us = overhead + sum over its actions of (base[action] + per_log_row[action] * log2(1 + rows))
+// where `rows` is the size of the tables the action looks up (evm.boid `requests` plus the
+// bridge scope `accountstate`): every lookup walks a secondary index, so the cost grows with
+// the log of the table. The parameters are fitted from billed CPU in receipts with recursive
+// least squares and a forgetting factor, so older receipts weigh less and the model follows
+// the chain (new contract build, more rows, busier producers). When the prediction error
+// keeps the same sign for a while the covariance is inflated to re-learn faster.
+namespace bridge_tools
+{
+  struct cost_sample {
+    uint64_t action = 0; // action name
+    uint64_t rows = 0;   // rows of the tables the action looks up when it runs
+  };
+
+  struct cpu_model_options {
+    double forgetting = 0.995;       // RLS forgetting factor, 1 = every receipt weighs the same
+    double prior_overhead_us = 150;  // starting point before any receipt was seen
+    double prior_base_us = 250;
+    double prior_per_log_row_us = 15;
+    double prior_variance = 1e6;     // how little the priors are trusted (us^2)
+    double drift_threshold = 0.15;   // relative bias of recent predictions that counts as drift
+    double drift_boost = 20;         // covariance inflation on drift
+    uint32_t drift_warmup = 50;      // receipts before drift is checked
+  };
+
+  class cpu_cost_model {
+    public:
+      explicit cpu_cost_model(cpu_model_options options = {}) : _options(options) {
+        _theta = {options.prior_overhead_us};
+        _p = {options.prior_variance};
+      }
+
+      //======================== Prediction ========================
+      double predict(const cost_sample& sample) const {
+        auto it = _index.find(sample.action);
+        double base = it != _index.end() ? _theta[it->second] : _options.prior_base_us;
+        double slope = it != _index.end() ? _theta[it->second + 1] : _options.prior_per_log_row_us;
+        return std::max(0.0, base + slope * log_rows(sample.rows));
+      }
+
+      double overhead() const { return std::max(0.0, _theta[0]); }
+
+      double predict(const std::vector<cost_sample>& actions) const {
+        double cpu = overhead();
+        for (const auto& sample : actions) cpu += predict(sample);
+        return cpu;
+      }
+
+      // Standard deviation of the recent per transaction prediction errors
+      double sigma() const { return std::sqrt(_error_variance); }
+
+      //======================== Calibration ========================
+      // One receipt: the actions of a transaction and the CPU it was billed
+      void observe(const std::vector<cost_sample>& actions, double billed_us) {
+        std::vector<double> x(_theta.size(), 0.0);
+        x[0] = 1;
+        for (const auto& sample : actions) {
+          size_t i = index_of(sample.action);
+          x.resize(_theta.size(), 0.0);
+          x[i] += 1;
+          x[i + 1] += log_rows(sample.rows);
+        }
+
+        double predicted = 0;
+        for (size_t i = 0; i < x.size(); ++i) predicted += _theta[i] * x[i];
+        double error = billed_us - predicted;
+
+        // RLS: k = P x / (lambda + x' P x), theta += k e, P = (P - k x' P) / lambda
+        const size_t n = _theta.size();
+        std::vector<double> px(n, 0.0);
+        for (size_t r = 0; r < n; ++r) {
+          for (size_t c = 0; c < n; ++c) px[r] += _p[r * n + c] * x[c];
+        }
+        double denom = _options.forgetting;
+        for (size_t i = 0; i < n; ++i) denom += x[i] * px[i];
+        for (size_t i = 0; i < n; ++i) _theta[i] += px[i] / denom * error;
+        for (size_t r = 0; r < n; ++r) {
+          for (size_t c = 0; c < n; ++c) _p[r * n + c] = (_p[r * n + c] - px[r] * px[c] / denom) / _options.forgetting;
+        }
+        // Directions the receipts do not excite (the row count barely moves) would grow by
+        // 1 / lambda on every receipt, the covariance is kept at the prior trust at most
+        double largest = 0;
+        for (size_t i = 0; i < n; ++i) largest = std::max(largest, _p[i * n + i]);
+        if (largest > _options.prior_variance) {
+          for (double& v : _p) v *= _options.prior_variance / largest;
+        }
+
+        // Error statistics use the prediction made before the update
+        const double alpha = 0.05;
+        _error_variance = _samples ? (1 - alpha) * _error_variance + alpha * error * error : error * error;
+        _bias = (1 - alpha) * _bias + alpha * error / std::max(predicted, 1.0);
+        _abs_error += std::fabs(error);
+        ++_samples;
+        if (_samples >= _options.drift_warmup && std::fabs(_bias) > _options.drift_threshold) {
+          for (double& v : _p) v *= _options.drift_boost;
+          _bias = 0;
+          ++_drifts;
+        }
+      }
+
+      uint64_t samples() const { return _samples; }
+      uint64_t drifts() const { return _drifts; }
+      double mean_abs_error() const { return _samples ? _abs_error / _samples : 0; }
+
+      //======================== Persistence ========================
+      // Text file: `overhead <us> <sigma>` then `action <name> <base us> <us per log2 row>` lines.
+      // The covariance is not kept, a loaded model starts from the prior trust again and
+      // adapts to the first receipts it observes.
+      void save(const std::string& path) const {
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        if (!file) throw abi_error("cannot write cost model " + path);
+        std::fprintf(file, "overhead %.3f %.3f\n", _theta[0], sigma());
+        for (const auto& [action, i] : ordered_actions()) {
+          std::fprintf(file, "action %s %.3f %.3f\n", name_to_string(action).c_str(), _theta[i], _theta[i + 1]);
+        }
+        if (std::fclose(file) != 0) throw abi_error("cannot write cost model " + path);
+      }
+
+      static cpu_cost_model load(const std::string& path, cpu_model_options options = {}) {
+        std::FILE* file = std::fopen(path.c_str(), "r");
+        if (!file) throw abi_error("cannot open cost model " + path);
+        cpu_cost_model model(options);
+        char kind[16], action[16];
+        double a, b;
+        while (std::fscanf(file, "%15s", kind) == 1) {
+          if (std::string(kind) == "overhead" && std::fscanf(file, "%lf %lf", &a, &b) == 2) {
+            model._theta[0] = a;
+            model._error_variance = b * b;
+          } else if (std::string(kind) == "action" && std::fscanf(file, "%15s %lf %lf", action, &a, &b) == 3) {
+            size_t i = model.index_of(string_to_name(action));
+            model._theta[i] = a;
+            model._theta[i + 1] = b;
+          } else {
+            std::fclose(file);
+            throw abi_error("malformed cost model " + path);
+          }
+        }
+        std::fclose(file);
+        return model;
+      }
+
+      // (action, parameter index) in name order
+      std::vector<std::pair<uint64_t, size_t>> ordered_actions() const {
+        std::vector<std::pair<uint64_t, size_t>> out(_index.begin(), _index.end());
+        std::sort(out.begin(), out.end(), [](const auto& a, const auto& b) {
+          return name_to_string(a.first) < name_to_string(b.first);
+        });
+        return out;
+      }
+
+      double parameter(size_t i) const { return _theta[i]; }
+
+    private:
+      static double log_rows(uint64_t rows) { return std::log2(1.0 + double(rows)); }
+
+      // Parameter index of the action's base cost (per_log_row follows), new actions start from the priors
+      size_t index_of(uint64_t action) {
+        auto it = _index.find(action);
+        if (it != _index.end()) return it->second;
+
+        const size_t old_n = _theta.size(), n = old_n + 2;
+        std::vector<double> p(n * n, 0.0);
+        for (size_t r = 0; r < old_n; ++r) {
+          for (size_t c = 0; c < old_n; ++c) p[r * n + c] = _p[r * old_n + c];
+        }
+        p[old_n * n + old_n] = _options.prior_variance;
+        p[(old_n + 1) * n + old_n + 1] = _options.prior_variance / 100; // slope is in us per log2 row
+        _p = std::move(p);
+        _theta.push_back(_options.prior_base_us);
+        _theta.push_back(_options.prior_per_log_row_us);
+        _index[action] = old_n;
+        return old_n;
+      }
+
+      cpu_model_options _options;
+      std::unordered_map<uint64_t, size_t> _index;
+      std::vector<double> _theta; // overhead, then base / per_log_row of every action
+      std::vector<double> _p;     // covariance, row major
+      double _error_variance = 0;
+      double _bias = 0;
+      double _abs_error = 0;
+      uint64_t _samples = 0;
+      uint64_t _drifts = 0;
+  };
+
+  //======================== Packing ========================
+  struct pending_action {
+    uint64_t action = 0;
+    uint64_t request_id = 0;
+    uint64_t rows = 0;
+  };
+
+  struct packer_options {
+    double target_us = 20000;   // CPU a transaction should stay under (the relayer's limit minus headroom)
+    double safety = 2;          // sigmas kept free on top of the prediction
+    size_t max_actions = 100;   // per transaction, also bounds the transaction size
+  };
+
+  struct packed_transaction {
+    std::vector<pending_action> actions;
+    double predicted_us = 0;
+    bool oversize = false;      // a single action already predicted above the target
+  };
+
+  // First fit in the order of the pending work: every action goes into the first transaction
+  // that still has room, so the oldest requests are submitted first and the transactions only
+  // get partly filled at the end of the backlog. Transactions without room for the cheapest
+  // action seen so far are not searched again, which keeps a large backlog linear.
+  class cpu_packer {
+    public:
+      cpu_packer(const cpu_cost_model& model, packer_options options) : _model(model), _options(options) {}
+
+      std::vector<packed_transaction> pack(const std::vector<pending_action>& pending) const {
+        std::vector<packed_transaction> out;
+        const double budget = _options.target_us - _options.safety * _model.sigma();
+        size_t first_open = 0; // transactions before it are full
+        double cheapest = budget;
+        for (const auto& action : pending) {
+          double cost = _model.predict(cost_sample{action.action, action.rows});
+          cheapest = std::min(cheapest, cost);
+          bool placed = false;
+          for (size_t t = first_open; t < out.size() && !placed; ++t) {
+            packed_transaction& trx = out[t];
+            if (trx.oversize || trx.actions.size() >= _options.max_actions || trx.predicted_us + cost > budget) continue;
+            trx.actions.push_back(action);
+            trx.predicted_us += cost;
+            placed = true;
+          }
+          if (!placed) {
+            packed_transaction trx;
+            trx.actions.push_back(action);
+            trx.predicted_us = _model.overhead() + cost;
+            trx.oversize = trx.predicted_us > budget;
+            out.push_back(std::move(trx));
+          }
+          while (first_open < out.size()) {
+            const packed_transaction& trx = out[first_open];
+            if (!trx.oversize && trx.actions.size() < _options.max_actions && trx.predicted_us + cheapest <= budget) break;
+            ++first_open;
+          }
+        }
+        return out;
+      }
+
+    private:
+      const cpu_cost_model& _model;
+      packer_options _options;
+  };
+}
@@ -0,0 +1,101 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "abi_stream.hpp"
+
+// Capture file of state history table deltas, used to replay a mirror offline.
+// Every record is: uint32 block_num | uint32 size | `size` bytes of get_blocks_result_v0.deltas
+// (all integers little endian).
+namespace bridge_tools
+{
+  class delta_capture_writer {
+    public:
+      explicit delta_capture_writer(const std::string& path) : _file(std::fopen(path.c_str(), "ab")) {
+        if (!_file) throw abi_error("cannot open capture file " + path);
+      }
+      ~delta_capture_writer() { if (_file) std::fclose(_file); }
+      delta_capture_writer(const delta_capture_writer&) = delete;
+      delta_capture_writer& operator=(const delta_capture_writer&) = delete;
+
+      void write(uint32_t block_num, byte_view deltas) {
+        uint32_t size = static_cast<uint32_t>(deltas.size);
+        std::fwrite(&block_num, sizeof(block_num), 1, _file);
+        std::fwrite(&size, sizeof(size), 1, _file);
+        if (size) std::fwrite(deltas.data, 1, size, _file);
+      }
+
+      void flush() { std::fflush(_file); }
+
+    private:
+      std::FILE* _file;
+  };
+
+  class delta_capture_reader {
+    public:
+      explicit delta_capture_reader(const std::string& path) : _file(std::fopen(path.c_str(), "rb")) {
+        if (!_file) throw abi_error("cannot open capture file " + path);
+      }
+      ~delta_capture_reader() { if (_file) std::fclose(_file); }
+      delta_capture_reader(const delta_capture_reader&) = delete;
+      delta_capture_reader& operator=(const delta_capture_reader&) = delete;
+
+      // Returns false at the end of the file, the view stays valid until the next call
+      bool next(uint32_t& block_num, byte_view& deltas) {
+        uint32_t header[2];
+        if (std::fread(header, sizeof(uint32_t), 2, _file) != 2) return false;
+        block_num = header[0];
+        _buf.resize(header[1]);
+        if (header[1] && std::fread(_buf.data(), 1, header[1], _file) != header[1]) {
+          throw abi_error("truncated capture record for block " + std::to_string(block_num));
+        }
+        deltas = byte_view{_buf.data(), _buf.size()};
+        return true;
+      }
+
+    private:
+      std::FILE* _file;
+      std::vector<uint8_t> _buf;
+  };
+
+  // Keeps the contract_row rows of the given contracts from a get_blocks_result `deltas`,
+  // re-encoded as a vector<table_delta> (empty when nothing matched)
+  inline std::vector<uint8_t> filter_contract_rows(byte_view deltas, const std::unordered_set<uint64_t>& codes) {
+    abi_reader ds(deltas);
+    std::vector<std::pair<bool, byte_view>> kept;
+    uint32_t count = ds.read_varuint32();
+    for (uint32_t i = 0; i < count; ++i) {
+      if (ds.read_varuint32() != 0) throw abi_error("unsupported table_delta version");
+      bool contract_rows = ds.read_string() == "contract_row";
+      uint32_t rows = ds.read_varuint32();
+      for (uint32_t r = 0; r < rows; ++r) {
+        bool present = ds.read_bool();
+        byte_view row = ds.read_bytes();
+        // contract_row_v0: varuint version, then code
+        if (contract_rows && row.size > 9) {
+          uint64_t code;
+          std::memcpy(&code, row.data + 1, 8);
+          if (codes.count(code)) kept.push_back({present, row});
+        }
+      }
+    }
+
+    abi_writer w;
+    if (kept.empty()) return w.buffer();
+    w.write_varuint32(1);
+    w.write_varuint32(0);
+    w.write_string("contract_row");
+    w.write_varuint32(static_cast<uint32_t>(kept.size()));
+    for (const auto& [present, row] : kept) {
+      w.write_bool(present);
+      w.write_bytes(row.data, row.size);
+    }
+    return w.buffer();
+  }
+}
@@ -0,0 +1,25 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Host stand-in for the one CDT header the vendored intx (antelope-compile/external/intx)
+// includes: eosio::check throws instead of aborting the action, and the standard headers the
+// real one brings in and intx relies on are included. Only the host tools that build the
+// shared 256 bit code (u256bench) pick it up.
+namespace eosio
+{
+  inline void check(bool condition, const std::string& message) {
+    if (!condition) throw std::runtime_error(message);
+  }
+
+  inline void check(bool condition, const char* message) {
+    if (!condition) throw std::runtime_error(message);
+  }
+}
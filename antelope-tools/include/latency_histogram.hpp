@@ -0,0 +1,69 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// Log-linear latency histogram in microseconds (the HdrHistogram bucket layout): values below
+// 64 get their own bucket, above that every power of two is cut in 32 buckets, so a
+// percentile is off by at most 1/32 (~3%) whatever the range. Fixed size, no allocation,
+// one per thread and merged for the report.
+namespace bridge_tools
+{
+  class latency_histogram {
+    public:
+      static constexpr uint32_t SUB_BUCKETS = 32;
+      static constexpr uint32_t BUCKETS = 2 * SUB_BUCKETS + 58 * SUB_BUCKETS;
+
+      void record(uint64_t us) {
+        ++_counts[bucket_of(us)];
+        ++_count;
+        _sum += us;
+        _max = std::max(_max, us);
+      }
+
+      void merge(const latency_histogram& other) {
+        for (uint32_t i = 0; i < BUCKETS; ++i) _counts[i] += other._counts[i];
+        _count += other._count;
+        _sum += other._sum;
+        _max = std::max(_max, other._max);
+      }
+
+      uint64_t count() const { return _count; }
+      uint64_t max() const { return _max; }
+      double mean() const { return _count ? double(_sum) / double(_count) : 0; }
+
+      // Smallest recorded value v with at least fraction q of the values <= v (upper end of its bucket)
+      uint64_t percentile(double q) const {
+        if (_count == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * double(_count) + 0.5);
+        rank = std::clamp<uint64_t>(rank, 1, _count);
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < BUCKETS; ++i) {
+          seen += _counts[i];
+          if (seen >= rank) return std::min(upper_of(i), _max);
+        }
+        return _max;
+      }
+
+      static uint32_t bucket_of(uint64_t us) {
+        if (us < 2 * SUB_BUCKETS) return static_cast<uint32_t>(us);
+        const uint32_t shift = 63 - __builtin_clzll(us) - 5; // keep the top 6 bits
+        return 2 * SUB_BUCKETS + (shift - 1) * SUB_BUCKETS + static_cast<uint32_t>((us >> shift) - SUB_BUCKETS);
+      }
+
+      static uint64_t upper_of(uint32_t bucket) {
+        if (bucket < 2 * SUB_BUCKETS) return bucket;
+        const uint32_t shift = (bucket - 2 * SUB_BUCKETS) / SUB_BUCKETS + 1;
+        const uint64_t top = (bucket - 2 * SUB_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS;
+        return ((top + 1) << shift) - 1;
+      }
+
+    private:
+      std::array<uint64_t, BUCKETS> _counts = {};
+      uint64_t _count = 0;
+      uint64_t _sum = 0;
+      uint64_t _max = 0;
+  };
+}
@@ -0,0 +1,50 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include <request_preflight.hpp>
+
+#include "abi_stream.hpp"
+#include "bridge_mirror.hpp"
+
+// Dry run of the relayer's evm.boid actions against a bridge_mirror or a snapshot_view, with
+// the checks the contract runs (include_common/request_preflight.hpp). An action that fails
+// here fails on chain too, after its storage reads, and costs the relayer a failed transaction
+// and a retry. The relayer can include this header directly and check each candidate first.
+namespace bridge_tools
+{
+  static constexpr uint64_t ACTION_REQNOTIFY = string_to_name("reqnotify");
+  static constexpr uint64_t ACTION_VERIFYTRX = string_to_name("verifytrx");
+
+  // Storage interface of the checks over the mirrored accountstate of TokenBridge.sol
+  template<typename State>
+  struct mirror_storage {
+    const State& state;
+
+    bool load(const storage_word& key, storage_word& value) const {
+      const storage_word* stored = state.storage(key);
+      if (!stored) return false;
+      value = *stored;
+      return true;
+    }
+
+    bool contains(const storage_word& key) const { return state.storage(key) != nullptr; }
+  };
+
+  // reqnotify or verifytrx for request_id, req gets the decoded Request of a reqnotify
+  template<typename State>
+  evm_bridge::preflight_status dry_run(const State& state, uint64_t action, uint64_t request_id,
+                                       const evm_bridge::request_preflight_config& config, evm_bridge::preflight_request& req) {
+    const mirror_storage<State> storage{state};
+    const auto row = state.request(request_id);
+    if (action == ACTION_REQNOTIFY) {
+      return evm_bridge::preflightNotify(storage, request_id, static_cast<bool>(row), state.settled_in_ledger(request_id), config, req);
+    }
+    if (action == ACTION_VERIFYTRX) {
+      return evm_bridge::preflightSettle(storage, request_id, static_cast<bool>(row), row && row->processed);
+    }
+    throw abi_error("no pre-flight check for action " + name_to_string(action));
+  }
+}
@@ -0,0 +1,114 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+
+#include "abi_stream.hpp"
+
+// Blocking client for the state history plugin websocket protocol (get_blocks_request_v0).
+// Table deltas (and the traces with fetch_traces) are requested, the callback gets the raw
+// `deltas` / `traces` bytes of every block.
+namespace bridge_tools
+{
+  struct ship_request {
+    uint32_t start_block = 0;
+    uint32_t end_block = 0xffffffff;
+    uint32_t max_messages_in_flight = 16;
+    bool irreversible_only = true; // no fork handling in the mirror, stay on irreversible blocks
+    bool fetch_traces = false;
+  };
+
+  using ship_block_handler = std::function<bool(uint32_t block_num, byte_view deltas, byte_view traces)>;
+
+  class ship_client {
+    public:
+      ship_client(std::string host, std::string port) : _host(std::move(host)), _port(std::move(port)) {}
+
+      // Streams blocks until end_block is reached or the handler returns false
+      void run(const ship_request& request, const ship_block_handler& on_block) {
+        namespace beast = boost::beast;
+        namespace websocket = beast::websocket;
+        using tcp = boost::asio::ip::tcp;
+
+        boost::asio::io_context ioc;
+        tcp::resolver resolver(ioc);
+        websocket::stream<tcp::socket> ws(ioc);
+
+        boost::asio::connect(ws.next_layer(), resolver.resolve(_host, _port));
+        ws.handshake(_host + ":" + _port, "/");
+        ws.read_message_max(1024ull * 1024 * 1024);
+
+        // The first message is the protocol ABI (JSON), the layout below is hard-coded
+        beast::flat_buffer buffer;
+        ws.read(buffer);
+        buffer.consume(buffer.size());
+
+        ws.binary(true);
+        ws.write(boost::asio::buffer(get_blocks_request(request)));
+
+        uint32_t unacked = 0;
+        for (;;) {
+          ws.read(buffer);
+          auto data = buffer.data();
+          abi_reader ds(static_cast<const uint8_t*>(data.data()), data.size());
+
+          if (ds.read_varuint32() != 1) throw abi_error("expected get_blocks_result_v0");
+          ds.skip(4 + 32); // head
+          ds.skip(4 + 32); // last_irreversible
+          bool has_block = ds.read_bool();
+          uint32_t block_num = 0;
+          if (has_block) {
+            block_num = ds.read_raw<uint32_t>();
+            ds.skip(32);
+          }
+          if (ds.read_bool()) ds.skip(4 + 32); // prev_block
+          if (ds.read_bool()) ds.read_bytes();  // block
+          byte_view traces, deltas;
+          if (ds.read_bool()) traces = ds.read_bytes();
+          if (ds.read_bool()) deltas = ds.read_bytes();
+
+          bool keep_going = !has_block || on_block(block_num, deltas, traces);
+          buffer.consume(buffer.size());
+
+          if (++unacked >= request.max_messages_in_flight / 2) {
+            ws.write(boost::asio::buffer(get_blocks_ack(unacked)));
+            unacked = 0;
+          }
+          if (!keep_going || (has_block && block_num + 1 >= request.end_block)) break;
+        }
+        ws.close(websocket::close_code::normal);
+      }
+
+    private:
+      static std::vector<uint8_t> get_blocks_request(const ship_request& request) {
+        abi_writer w;
+        w.write_varuint32(1); // get_blocks_request_v0
+        w.write_raw<uint32_t>(request.start_block);
+        w.write_raw<uint32_t>(request.end_block);
+        w.write_raw<uint32_t>(request.max_messages_in_flight);
+        w.write_varuint32(0); // have_positions
+        w.write_bool(request.irreversible_only);
+        w.write_bool(false);  // fetch_block
+        w.write_bool(request.fetch_traces);
+        w.write_bool(true);   // fetch_deltas
+        return w.buffer();
+      }
+
+      static std::vector<uint8_t> get_blocks_ack(uint32_t num_messages) {
+        abi_writer w;
+        w.write_varuint32(2); // get_blocks_ack_request_v0
+        w.write_raw<uint32_t>(num_messages);
+        return w.buffer();
+      }
+
+      std::string _host;
+      std::string _port;
+  };
+}
@@ -0,0 +1,581 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "abi_stream.hpp"
+#include "bridge_mirror.hpp"
+#include "delta_capture.hpp"
+
+// On-disk snapshot of the bridge state tracked by bridge_mirror, shared by shipmirror,
+// bridgeaudit and the dashboards.
+//
+//   header | storage | accounts | accounts by name | requests | balances | fees | settled ids | strings | delta log
+//
+// The base sections are arrays of fixed-width records sorted by their key (`bykey` order for
+// the storage), read in place through mmap with a binary search. Blocks received after the
+// snapshot was written are appended to the end as delta capture records
+// (uint32 block_num | uint32 size | contract_row deltas of the tracked contracts), a reader
+// applies them on top of the base on open and compaction folds them into a new base.
+// All integers are little endian (the tools only run on little endian hosts).
+namespace bridge_tools
+{
+  static constexpr char SNAPSHOT_MAGIC[8] = {'B', 'R', 'D', 'G', 'S', 'N', 'A', 'P'};
+  static constexpr uint32_t SNAPSHOT_VERSION = 2; // 2: settled ids section
+
+  enum snapshot_section_id : uint8_t {
+    SNAPSHOT_STORAGE,
+    SNAPSHOT_ACCOUNTS,
+    SNAPSHOT_ACCOUNTS_BY_NAME,
+    SNAPSHOT_REQUESTS,
+    SNAPSHOT_BALANCES,
+    SNAPSHOT_FEES,
+    SNAPSHOT_SETTLED,
+    SNAPSHOT_STRINGS, // count is in bytes
+    SNAPSHOT_SECTIONS
+  };
+
+  struct snapshot_section {
+    uint64_t offset;
+    uint64_t count;
+  };
+
+  struct snapshot_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t block_num;   // last block folded into the base
+    uint8_t layout;
+    uint8_t reserved[3];
+    uint64_t evm_contract;
+    uint64_t bridge_contract;
+    uint64_t token_contract;
+    uint64_t fees_contract;
+    uint64_t bridge_scope;
+    uint8_t bridge_address[20];
+    uint8_t reserved2[4];
+    snapshot_section sections[SNAPSHOT_SECTIONS];
+    uint64_t base_size;   // the delta log starts here
+  };
+  static_assert(sizeof(snapshot_header) == 224, "snapshot header layout");
+
+  struct snapshot_storage_record {
+    storage_word key;
+    storage_word value;
+    uint64_t primary_key;
+  };
+  static_assert(sizeof(snapshot_storage_record) == 72, "snapshot storage record layout");
+
+  struct snapshot_account_record {
+    uint64_t primary_key;
+    uint64_t index;
+    uint64_t account;
+    uint64_t nonce;
+    std::array<uint8_t, 20> address;
+    uint8_t reserved[4];
+  };
+  static_assert(sizeof(snapshot_account_record) == 56, "snapshot account record layout");
+
+  struct snapshot_name_record {
+    uint64_t account;
+    uint64_t primary_key;
+  };
+
+  struct snapshot_request_record {
+    uint64_t request_id;
+    int64_t timestamp_us;
+    uint64_t amount;
+    uint64_t receiver;
+    uint32_t sender_offset; // into the strings section
+    uint32_t sender_size;
+    uint32_t memo_offset;
+    uint32_t memo_size;
+    uint8_t processed;
+    uint8_t reserved[7];
+  };
+  static_assert(sizeof(snapshot_request_record) == 56, "snapshot request record layout");
+
+  struct snapshot_balance_record {
+    uint64_t symbol_code;
+    int64_t amount;
+  };
+
+  struct snapshot_fee_record {
+    uint64_t id;
+    uint64_t user;
+    int64_t amount;
+    uint64_t symbol;
+    uint64_t token_contract;
+    uint32_t created_at;
+    uint32_t reserved;
+  };
+  static_assert(sizeof(snapshot_fee_record) == 48, "snapshot fee record layout");
+
+  // evm.boid settledids row
+  struct snapshot_settled_record {
+    uint64_t word_index;
+    uint64_t bits;
+  };
+
+  // A request without copying its strings, they point into the mapping (or the overlay)
+  struct request_view {
+    uint64_t request_id = 0;
+    int64_t timestamp_us = 0;
+    bool processed = false;
+    uint64_t amount = 0;
+    uint64_t receiver = 0;
+    std::string_view sender;
+    std::string_view memo;
+  };
+
+  //======================== Writer ========================
+  // Writes the mirror as a new base (empty delta log). Goes through a temporary file and a rename,
+  // readers that have the old file mapped keep reading it.
+  inline void write_snapshot(const std::string& path, const bridge_mirror& mirror, uint32_t block_num) {
+    const mirror_config& config = mirror.config();
+    std::vector<snapshot_storage_record> storage;
+    storage.reserve(mirror.storage_keys().size());
+    for (const auto& [primary_key, key] : mirror.storage_keys()) {
+      const storage_word* value = mirror.storage(key);
+      if (value) storage.push_back({key, *value, primary_key});
+    }
+    std::sort(storage.begin(), storage.end(), [](const auto& a, const auto& b) { return a.key < b.key; });
+
+    std::vector<snapshot_account_record> accounts;
+    std::vector<snapshot_name_record> names;
+    for (const auto& [primary_key, row] : mirror.accounts()) {
+      snapshot_account_record record = {primary_key, row.index, row.account, row.nonce, row.address, {}};
+      accounts.push_back(record);
+      if (row.account) names.push_back({row.account, primary_key});
+    }
+    std::sort(accounts.begin(), accounts.end(), [](const auto& a, const auto& b) { return a.primary_key < b.primary_key; });
+    std::sort(names.begin(), names.end(), [](const auto& a, const auto& b) { return a.account < b.account; });
+
+    std::vector<snapshot_request_record> requests;
+    std::string strings;
+    for (const auto& [id, row] : mirror.requests()) {
+      snapshot_request_record record = {};
+      record.request_id = id;
+      record.timestamp_us = row.timestamp_us;
+      record.amount = row.amount;
+      record.receiver = row.receiver;
+      record.processed = row.processed;
+      record.sender_offset = static_cast<uint32_t>(strings.size());
+      record.sender_size = static_cast<uint32_t>(row.sender.size());
+      strings += row.sender;
+      record.memo_offset = static_cast<uint32_t>(strings.size());
+      record.memo_size = static_cast<uint32_t>(row.memo.size());
+      strings += row.memo;
+      requests.push_back(record);
+    }
+    std::sort(requests.begin(), requests.end(), [](const auto& a, const auto& b) { return a.request_id < b.request_id; });
+
+    std::vector<snapshot_balance_record> balances;
+    for (const auto& [symbol_code, amount] : mirror.balances()) balances.push_back({symbol_code, amount});
+    std::sort(balances.begin(), balances.end(), [](const auto& a, const auto& b) { return a.symbol_code < b.symbol_code; });
+
+    std::vector<snapshot_fee_record> fees;
+    for (const auto& [id, row] : mirror.fees()) fees.push_back({id, row.user, row.amount, row.symbol, row.token_contract, row.created_at, 0});
+    std::sort(fees.begin(), fees.end(), [](const auto& a, const auto& b) { return a.id < b.id; });
+
+    std::vector<snapshot_settled_record> settled;
+    for (const auto& [word_index, bits] : mirror.settled_words()) settled.push_back({word_index, bits});
+    std::sort(settled.begin(), settled.end(), [](const auto& a, const auto& b) { return a.word_index < b.word_index; });
+
+    snapshot_header header = {};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.header_size = sizeof(snapshot_header);
+    header.block_num = block_num;
+    header.layout = config.layout;
+    header.evm_contract = config.evm_contract;
+    header.bridge_contract = config.bridge_contract;
+    header.token_contract = config.token_contract;
+    header.fees_contract = config.fees_contract;
+    header.bridge_scope = config.bridge_scope;
+    std::memcpy(header.bridge_address, config.bridge_address.data(), 20);
+
+    std::vector<uint8_t> file(sizeof(header));
+    auto section = [&](snapshot_section_id id, const void* data, size_t count, size_t record_size) {
+      file.resize((file.size() + 7) & ~size_t(7)); // every section starts 8 byte aligned
+      header.sections[id] = {file.size(), count};
+      const uint8_t* bytes = static_cast<const uint8_t*>(data);
+      file.insert(file.end(), bytes, bytes + count * record_size);
+    };
+    section(SNAPSHOT_STORAGE, storage.data(), storage.size(), sizeof(snapshot_storage_record));
+    section(SNAPSHOT_ACCOUNTS, accounts.data(), accounts.size(), sizeof(snapshot_account_record));
+    section(SNAPSHOT_ACCOUNTS_BY_NAME, names.data(), names.size(), sizeof(snapshot_name_record));
+    section(SNAPSHOT_REQUESTS, requests.data(), requests.size(), sizeof(snapshot_request_record));
+    section(SNAPSHOT_BALANCES, balances.data(), balances.size(), sizeof(snapshot_balance_record));
+    section(SNAPSHOT_FEES, fees.data(), fees.size(), sizeof(snapshot_fee_record));
+    section(SNAPSHOT_SETTLED, settled.data(), settled.size(), sizeof(snapshot_settled_record));
+    section(SNAPSHOT_STRINGS, strings.data(), strings.size(), 1);
+    header.base_size = file.size();
+    std::memcpy(file.data(), &header, sizeof(header));
+
+    std::string tmp = path + ".tmp";
+    std::FILE* out = std::fopen(tmp.c_str(), "wb");
+    if (!out) throw abi_error("cannot create snapshot " + tmp);
+    bool written = std::fwrite(file.data(), 1, file.size(), out) == file.size();
+    written = std::fflush(out) == 0 && written;
+    written = ::fsync(fileno(out)) == 0 && written;
+    std::fclose(out);
+    if (!written || std::rename(tmp.c_str(), path.c_str()) != 0) throw abi_error("cannot write snapshot " + path);
+  }
+
+  //======================== Reader ========================
+  class snapshot_view {
+    public:
+      explicit snapshot_view(const std::string& path) : _path(path) {
+        _fd = ::open(path.c_str(), O_RDONLY);
+        if (_fd < 0) throw abi_error("cannot open snapshot " + path);
+        load();
+      }
+
+      ~snapshot_view() {
+        if (_data) ::munmap(const_cast<uint8_t*>(_data), _size);
+        if (_fd >= 0) ::close(_fd);
+      }
+      snapshot_view(const snapshot_view&) = delete;
+      snapshot_view& operator=(const snapshot_view&) = delete;
+
+      // Picks up the blocks appended since the view was opened (or last refreshed). A compaction
+      // (write_snapshot, `shipmirror live --compact-every`) renames a new file over the path, the
+      // view then reopens the path and rebuilds its overlay from the new delta log.
+      void refresh() {
+        struct stat st, path_st;
+        if (::fstat(_fd, &st) != 0) throw abi_error("cannot stat snapshot " + _path);
+        if (::stat(_path.c_str(), &path_st) == 0 && (path_st.st_ino != st.st_ino || path_st.st_dev != st.st_dev)) {
+          reopen();
+          return;
+        }
+        if (static_cast<size_t>(st.st_size) == _size) return;
+        ::munmap(const_cast<uint8_t*>(_data), _size);
+        map();
+        apply_log();
+      }
+
+      //======================== Queries (same as bridge_mirror) ========================
+      const storage_word* storage(const storage_word& key) const {
+        auto it = _storage.find(key);
+        if (it != _storage.end()) return it->second ? &*it->second : nullptr;
+        auto records = section<snapshot_storage_record>(SNAPSHOT_STORAGE);
+        auto found = std::lower_bound(records.first, records.second, key, [](const auto& r, const storage_word& k) { return r.key < k; });
+        return found != records.second && found->key == key ? &found->value : nullptr;
+      }
+
+      std::optional<request_view> request(uint64_t id) const {
+        auto it = _requests.find(id);
+        if (it != _requests.end()) {
+          if (!it->second) return std::nullopt;
+          const native_request_row& row = *it->second;
+          return request_view{row.request_id, row.timestamp_us, row.processed, row.amount, row.receiver, row.sender, row.memo};
+        }
+        const snapshot_request_record* r = find(section<snapshot_request_record>(SNAPSHOT_REQUESTS), id,
+          [](const snapshot_request_record& rec) { return rec.request_id; });
+        if (!r) return std::nullopt;
+        return request_base(r);
+      }
+
+      bool settled_in_ledger(uint64_t id) const {
+        const uint64_t word_index = evm_bridge::settledWordIndex(id);
+        auto it = _settled.find(word_index);
+        if (it != _settled.end()) return it->second && (*it->second & evm_bridge::settledBit(id)) != 0;
+        const snapshot_settled_record* r = find(section<snapshot_settled_record>(SNAPSHOT_SETTLED), word_index,
+          [](const snapshot_settled_record& rec) { return rec.word_index; });
+        return r && (r->bits & evm_bridge::settledBit(id)) != 0;
+      }
+
+      std::optional<evm_account_row> account(uint64_t primary_key) const {
+        auto it = _accounts.find(primary_key);
+        if (it != _accounts.end()) return it->second;
+        const snapshot_account_record* r = find(section<snapshot_account_record>(SNAPSHOT_ACCOUNTS), primary_key,
+          [](const snapshot_account_record& rec) { return rec.primary_key; });
+        if (!r) return std::nullopt;
+        return evm_account_row{r->index, r->address, r->account, r->nonce};
+      }
+
+      std::optional<evm_account_row> account_by_name(uint64_t account_name) const {
+        auto it = _accounts_by_name.find(account_name);
+        if (it != _accounts_by_name.end()) return it->second ? account(*it->second) : std::nullopt;
+        const snapshot_name_record* r = find(section<snapshot_name_record>(SNAPSHOT_ACCOUNTS_BY_NAME), account_name,
+          [](const snapshot_name_record& rec) { return rec.account; });
+        return r ? account(r->primary_key) : std::nullopt;
+      }
+
+      const int64_t* native_balance(uint64_t symbol_code) const {
+        auto it = _balances.find(symbol_code);
+        if (it != _balances.end()) return it->second ? &*it->second : nullptr;
+        const snapshot_balance_record* r = find(section<snapshot_balance_record>(SNAPSHOT_BALANCES), symbol_code,
+          [](const snapshot_balance_record& rec) { return rec.symbol_code; });
+        return r ? &r->amount : nullptr;
+      }
+
+      std::optional<fee_row> fee(uint64_t id) const {
+        auto it = _fees.find(id);
+        if (it != _fees.end()) return it->second;
+        const snapshot_fee_record* r = find(section<snapshot_fee_record>(SNAPSHOT_FEES), id,
+          [](const snapshot_fee_record& rec) { return rec.id; });
+        if (!r) return std::nullopt;
+        return fee_row{r->id, r->user, r->amount, r->symbol, r->token_contract, r->created_at};
+      }
+
+      template<typename F>
+      void for_each_request_id(F&& f) const {
+        auto records = section<snapshot_request_record>(SNAPSHOT_REQUESTS);
+        for (auto r = records.first; r != records.second; ++r) {
+          if (!_requests.count(r->request_id)) f(r->request_id);
+        }
+        for (const auto& [id, row] : _requests) if (row) f(id);
+      }
+
+      size_t storage_size() const {
+        size_t size = _header.sections[SNAPSHOT_STORAGE].count;
+        auto records = section<snapshot_storage_record>(SNAPSHOT_STORAGE);
+        for (const auto& [key, value] : _storage) {
+          bool in_base = std::binary_search(records.first, records.second, key, [](const auto& a, const auto& b) {
+            return key_of(a) < key_of(b);
+          });
+          if (value && !in_base) ++size;
+          else if (!value && in_base) --size;
+        }
+        return size;
+      }
+
+      uint64_t bridge_scope() const { return _config.bridge_scope; }
+      uint32_t block_num() const { return _block_num; }
+      uint64_t base_size() const { return _header.base_size; }
+      uint64_t log_size() const { return _size - _header.base_size; }
+      uint64_t base_count(snapshot_section_id id) const { return _header.sections[id].count; }
+
+      // Base and delta log folded into a mirror (compaction, tools that keep following SHiP)
+      bridge_mirror to_mirror() const {
+        bridge_mirror mirror(_config);
+        for (auto [r, end] = section<snapshot_account_record>(SNAPSHOT_ACCOUNTS); r != end; ++r) {
+          mirror.on_account(true, r->primary_key, {r->index, r->address, r->account, r->nonce});
+        }
+        for (auto [r, end] = section<snapshot_storage_record>(SNAPSHOT_STORAGE); r != end; ++r) {
+          mirror.on_storage(true, r->primary_key, r->key, r->value);
+        }
+        for (auto [r, end] = section<snapshot_request_record>(SNAPSHOT_REQUESTS); r != end; ++r) {
+          request_view row = request_base(r);
+          mirror.on_request(true, r->request_id, {row.request_id, row.timestamp_us, row.processed, row.amount,
+                                                  row.receiver, std::string(row.sender), std::string(row.memo)});
+        }
+        for (auto [r, end] = section<snapshot_balance_record>(SNAPSHOT_BALANCES); r != end; ++r) {
+          mirror.on_balance(true, r->symbol_code, r->amount);
+        }
+        for (auto [r, end] = section<snapshot_fee_record>(SNAPSHOT_FEES); r != end; ++r) {
+          mirror.on_fee(true, r->id, {r->id, r->user, r->amount, r->symbol, r->token_contract, r->created_at});
+        }
+        for (auto [r, end] = section<snapshot_settled_record>(SNAPSHOT_SETTLED); r != end; ++r) {
+          mirror.on_settled(true, r->word_index, r->bits);
+        }
+
+        abi_reader log(_data + _header.base_size, _size - _header.base_size);
+        while (log.remaining() >= 8) {
+          log.skip(4);
+          uint32_t size = log.read_raw<uint32_t>();
+          if (log.remaining() < size) break; // record still being appended
+          if (size) mirror.apply_deltas(log.position(), size);
+          log.skip(size);
+        }
+        return mirror;
+      }
+
+      //======================== Row handlers (for_each_tracked_row) ========================
+      // Fill the overlay, a nullopt value marks a row removed since the base was written.
+      // eosio.evm never changes the key of an accountstate row (a slot set to zero is removed),
+      // so the overlay is keyed by the storage key only.
+      const mirror_config& config() const { return _config; }
+
+      void on_account(bool present, uint64_t primary_key, const evm_account_row& row) {
+        if (present) {
+          _accounts[primary_key] = row;
+          if (row.account) _accounts_by_name[row.account] = primary_key;
+          if (_config.bridge_scope == 0 && row.address == _config.bridge_address) _config.bridge_scope = row.index;
+        } else {
+          _accounts[primary_key] = std::nullopt;
+          if (row.account) _accounts_by_name[row.account] = std::nullopt;
+        }
+      }
+      void on_storage(bool present, uint64_t, const storage_word& key, const storage_word& value) {
+        _storage[key] = present ? std::optional<storage_word>(value) : std::nullopt;
+      }
+      void on_request(bool present, uint64_t primary_key, native_request_row row) {
+        _requests[primary_key] = present ? std::optional<native_request_row>(std::move(row)) : std::nullopt;
+      }
+      void on_settled(bool present, uint64_t word_index, uint64_t bits) {
+        _settled[word_index] = present ? std::optional<uint64_t>(bits) : std::nullopt;
+      }
+      void on_balance(bool present, uint64_t symbol_code, int64_t amount) {
+        _balances[symbol_code] = present ? std::optional<int64_t>(amount) : std::nullopt;
+      }
+      void on_fee(bool present, uint64_t primary_key, const fee_row& row) {
+        _fees[primary_key] = present ? std::optional<fee_row>(row) : std::nullopt;
+      }
+      void on_row() {}
+
+    private:
+      // Maps the open file, checks the header and applies the delta log on top of the base
+      void load() {
+        map();
+
+        if (_size < sizeof(snapshot_header)) throw abi_error("snapshot " + _path + " is truncated");
+        std::memcpy(&_header, _data, sizeof(_header));
+        if (std::memcmp(_header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) throw abi_error(_path + " is not a bridge snapshot");
+        if (_header.version != SNAPSHOT_VERSION || _header.header_size != sizeof(snapshot_header)) {
+          throw abi_error("unsupported snapshot version " + std::to_string(_header.version));
+        }
+        if (_header.base_size > _size) throw abi_error("snapshot " + _path + " is truncated");
+        const size_t record_sizes[SNAPSHOT_SECTIONS] = {
+          sizeof(snapshot_storage_record), sizeof(snapshot_account_record), sizeof(snapshot_name_record),
+          sizeof(snapshot_request_record), sizeof(snapshot_balance_record), sizeof(snapshot_fee_record),
+          sizeof(snapshot_settled_record), 1};
+        for (uint8_t id = 0; id < SNAPSHOT_SECTIONS; ++id) {
+          const snapshot_section& s = _header.sections[id];
+          if (s.offset % 8 || s.offset > _header.base_size || s.count > (_header.base_size - s.offset) / record_sizes[id]) {
+            throw abi_error("snapshot " + _path + " has a corrupt section table");
+          }
+        }
+
+        _config.layout = static_cast<evm_bridge::request_layout>(_header.layout);
+        _config.evm_contract = _header.evm_contract;
+        _config.bridge_contract = _header.bridge_contract;
+        _config.token_contract = _header.token_contract;
+        _config.fees_contract = _header.fees_contract;
+        _config.bridge_scope = _header.bridge_scope;
+        std::memcpy(_config.bridge_address.data(), _header.bridge_address, 20);
+        _block_num = _header.block_num;
+        _applied = _header.base_size;
+        apply_log();
+      }
+
+      // The file at the path was replaced: drop the old mapping and overlay, load the new file
+      void reopen() {
+        int fd = ::open(_path.c_str(), O_RDONLY);
+        if (fd < 0) throw abi_error("cannot open snapshot " + _path);
+        ::munmap(const_cast<uint8_t*>(_data), _size);
+        ::close(_fd);
+        _fd = fd;
+        _data = nullptr;
+        _storage.clear();
+        _accounts.clear();
+        _accounts_by_name.clear();
+        _requests.clear();
+        _balances.clear();
+        _fees.clear();
+        _settled.clear();
+        load();
+      }
+
+      void map() {
+        struct stat st;
+        if (::fstat(_fd, &st) != 0) throw abi_error("cannot stat snapshot " + _path);
+        _size = static_cast<size_t>(st.st_size);
+        void* data = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, _fd, 0);
+        if (data == MAP_FAILED) throw abi_error("cannot map snapshot " + _path);
+        _data = static_cast<const uint8_t*>(data);
+      }
+
+      // Applies the complete delta log records not seen yet
+      void apply_log() {
+        abi_reader log(_data + _applied, _size - _applied);
+        while (log.remaining() >= 8) {
+          uint32_t block_num = log.read_raw<uint32_t>();
+          uint32_t size = log.read_raw<uint32_t>();
+          if (log.remaining() < size) break; // record still being appended
+          if (size) for_each_tracked_row(log.position(), size, *this);
+          log.skip(size);
+          _applied += 8 + size;
+          _block_num = std::max(_block_num, block_num);
+        }
+      }
+
+      template<typename Record>
+      std::pair<const Record*, const Record*> section(snapshot_section_id id) const {
+        const Record* begin = reinterpret_cast<const Record*>(_data + _header.sections[id].offset);
+        return {begin, begin + _header.sections[id].count};
+      }
+
+      static const storage_word& key_of(const storage_word& key) { return key; }
+      static const storage_word& key_of(const snapshot_storage_record& r) { return r.key; }
+
+      template<typename Record, typename Key>
+      static const Record* find(std::pair<const Record*, const Record*> records, uint64_t key, Key key_of) {
+        auto found = std::lower_bound(records.first, records.second, key, [&](const Record& r, uint64_t k) { return key_of(r) < k; });
+        return found != records.second && key_of(*found) == key ? found : nullptr;
+      }
+
+      request_view request_base(const snapshot_request_record* r) const {
+        const char* strings = reinterpret_cast<const char*>(_data + _header.sections[SNAPSHOT_STRINGS].offset);
+        return request_view{r->request_id, r->timestamp_us, r->processed != 0, r->amount, r->receiver,
+                            std::string_view(strings + r->sender_offset, r->sender_size),
+                            std::string_view(strings + r->memo_offset, r->memo_size)};
+      }
+
+      std::string _path;
+      int _fd = -1;
+      const uint8_t* _data = nullptr;
+      size_t _size = 0;
+      size_t _applied = 0;
+      snapshot_header _header = {};
+      mirror_config _config;
+      uint32_t _block_num = 0;
+
+      std::unordered_map<storage_word, std::optional<storage_word>, word_hash> _storage;
+      std::unordered_map<uint64_t, std::optional<evm_account_row>> _accounts;
+      std::unordered_map<uint64_t, std::optional<uint64_t>> _accounts_by_name;
+      std::unordered_map<uint64_t, std::optional<native_request_row>> _requests;
+      std::unordered_map<uint64_t, std::optional<int64_t>> _balances;
+      std::unordered_map<uint64_t, std::optional<fee_row>> _fees;
+      std::unordered_map<uint64_t, std::optional<uint64_t>> _settled;
+  };
+
+  //======================== Delta log ========================
+  // Appends blocks to a snapshot, keeping only the rows of the contracts it tracks
+  class snapshot_appender {
+    public:
+      snapshot_appender(const std::string& path, const mirror_config& config)
+        : _writer(path), _codes{config.evm_contract, config.bridge_contract, config.fees_contract} {
+        if (config.token_contract) _codes.insert(config.token_contract);
+      }
+
+      // Every block gets a record, an empty one when none of its rows are tracked, so the
+      // last block of the log is where a restarted reader continues from
+      void append(uint32_t block_num, byte_view deltas) {
+        std::vector<uint8_t> kept = deltas.size ? filter_contract_rows(deltas, _codes) : std::vector<uint8_t>();
+        _writer.write(block_num, byte_view{kept.data(), kept.size()});
+        _writer.flush();
+      }
+
+    private:
+      delta_capture_writer _writer;
+      std::unordered_set<uint64_t> _codes;
+  };
+
+  // Folds the delta log into a new base
+  inline void compact_snapshot(const std::string& path) {
+    uint32_t block_num;
+    bridge_mirror mirror = [&] {
+      snapshot_view view(path);
+      block_num = view.block_num();
+      return view.to_mirror();
+    }();
+    write_snapshot(path, mirror, block_num);
+  }
+}
@@ -0,0 +1,285 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "abi_stream.hpp"
+#include "delta_capture.hpp"
+
+// Capture of the production transactions that touch the watched contracts (evm.boid,
+// xsend.boid), read from the state history `traces`, plus the contract rows they changed.
+//
+// Every record is: uint32 block_num | uint8 kind | uint32 size | `size` bytes (little endian)
+//  - TRACE_RECORD_TRANSACTION: captured_transaction (see write / read below)
+//  - TRACE_RECORD_DELTAS:      vector<table_delta> holding only the `contract_row` rows of
+//                              the watched contracts, same encoding as get_blocks_result deltas
+namespace bridge_tools
+{
+  enum trace_record_kind : uint8_t {
+    TRACE_RECORD_TRANSACTION = 0,
+    TRACE_RECORD_DELTAS      = 1
+  };
+
+  struct captured_action {
+    uint32_t action_ordinal = 0;
+    uint32_t creator_action_ordinal = 0; // 0 = signed by the user (a root action)
+    uint64_t receiver = 0;
+    uint64_t account = 0;
+    uint64_t name = 0;
+    std::vector<std::pair<uint64_t, uint64_t>> authorization; // actor, permission
+    std::vector<uint8_t> data;
+    int64_t elapsed_us = 0;
+    std::string console;
+    std::vector<uint8_t> return_value;
+    bool failed = false;
+  };
+
+  struct captured_transaction {
+    std::array<uint8_t, 32> id = {};
+    uint8_t status = 0; // transaction_status, 0 = executed
+    uint32_t cpu_usage_us = 0;
+    int64_t elapsed_us = 0;
+    std::vector<captured_action> actions; // sorted by action_ordinal
+
+    bool executed() const { return status == 0; }
+  };
+
+  //======================== state history traces ========================
+  // Decoder for the `traces` of get_blocks_result_v0 (vector<transaction_trace>), keeps the
+  // transactions with at least one action received by a watched account.
+  class trace_parser {
+    public:
+      explicit trace_parser(std::unordered_set<uint64_t> watched) : _watched(std::move(watched)) {}
+
+      std::vector<captured_transaction> parse(byte_view traces) const {
+        std::vector<captured_transaction> out;
+        abi_reader ds(traces);
+        uint32_t count = ds.read_varuint32();
+        for (uint32_t i = 0; i < count; ++i) {
+          captured_transaction trx;
+          if (read_transaction_trace(ds, trx) && trx.status != 3 /* delayed, runs later */) out.push_back(std::move(trx));
+        }
+        return out;
+      }
+
+      bool watched(uint64_t account) const { return _watched.count(account) != 0; }
+
+    private:
+      // transaction_trace_v0, returns true when a watched account received one of its actions
+      bool read_transaction_trace(abi_reader& ds, captured_transaction& trx) const {
+        if (ds.read_varuint32() != 0) throw abi_error("unsupported transaction_trace version");
+        trx.id = ds.read_array<32>();
+        trx.status = ds.read_raw<uint8_t>();
+        trx.cpu_usage_us = ds.read_raw<uint32_t>();
+        ds.read_varuint32(); // net_usage_words
+        trx.elapsed_us = ds.read_raw<int64_t>();
+        ds.skip(8 + 1);      // net_usage, scheduled
+
+        bool relevant = false;
+        uint32_t actions = ds.read_varuint32();
+        trx.actions.resize(actions);
+        for (auto& act : trx.actions) {
+          read_action_trace(ds, act);
+          relevant = relevant || watched(act.receiver);
+        }
+        std::sort(trx.actions.begin(), trx.actions.end(), [](const captured_action& a, const captured_action& b) {
+          return a.action_ordinal < b.action_ordinal;
+        });
+
+        if (ds.read_bool()) ds.skip(8 + 8);         // account_ram_delta
+        if (ds.read_bool()) ds.read_bytes();         // except
+        if (ds.read_bool()) ds.skip(8);              // error_code
+        if (ds.read_bool()) {                        // failed_dtrx_trace
+          captured_transaction failed;
+          read_transaction_trace(ds, failed);
+        }
+        if (ds.read_bool()) skip_partial_transaction(ds);
+        return relevant;
+      }
+
+      // action_trace_v0 / action_trace_v1 (v1 adds return_value)
+      static void read_action_trace(abi_reader& ds, captured_action& act) {
+        uint32_t version = ds.read_varuint32();
+        if (version > 1) throw abi_error("unsupported action_trace version " + std::to_string(version));
+        act.action_ordinal = ds.read_varuint32();
+        act.creator_action_ordinal = ds.read_varuint32();
+        if (ds.read_bool()) {                        // action_receipt_v0
+          if (ds.read_varuint32() != 0) throw abi_error("unsupported action_receipt version");
+          ds.skip(8 + 32 + 8 + 8);                   // receiver, act_digest, global / recv sequence
+          uint32_t auths = ds.read_varuint32();
+          ds.skip(static_cast<size_t>(auths) * 16);  // auth_sequence
+          ds.read_varuint32();                       // code_sequence
+          ds.read_varuint32();                       // abi_sequence
+        }
+        act.receiver = ds.read_raw<uint64_t>();
+        act.account = ds.read_raw<uint64_t>();
+        act.name = ds.read_raw<uint64_t>();
+        uint32_t auths = ds.read_varuint32();
+        act.authorization.resize(auths);
+        for (auto& level : act.authorization) {
+          level.first = ds.read_raw<uint64_t>();
+          level.second = ds.read_raw<uint64_t>();
+        }
+        byte_view data = ds.read_bytes();
+        act.data.assign(data.data, data.data + data.size);
+        ds.skip(1);                                  // context_free
+        act.elapsed_us = ds.read_raw<int64_t>();
+        act.console = ds.read_string();
+        uint32_t ram_deltas = ds.read_varuint32();
+        ds.skip(static_cast<size_t>(ram_deltas) * 16);
+        if (ds.read_bool()) {                        // except
+          ds.read_bytes();
+          act.failed = true;
+        }
+        if (ds.read_bool()) ds.skip(8);              // error_code
+        if (version == 1) {
+          byte_view ret = ds.read_bytes();
+          act.return_value.assign(ret.data, ret.data + ret.size);
+        }
+      }
+
+      // partial_transaction_v0, only skipped
+      static void skip_partial_transaction(abi_reader& ds) {
+        if (ds.read_varuint32() != 0) throw abi_error("unsupported partial_transaction version");
+        ds.skip(4 + 2 + 4);                          // expiration, ref_block_num, ref_block_prefix
+        ds.read_varuint32();                         // max_net_usage_words
+        ds.skip(1);                                  // max_cpu_usage_ms
+        ds.read_varuint32();                         // delay_sec
+        uint32_t extensions = ds.read_varuint32();
+        for (uint32_t i = 0; i < extensions; ++i) {
+          ds.skip(2);
+          ds.read_bytes();
+        }
+        uint32_t signatures = ds.read_varuint32();
+        for (uint32_t i = 0; i < signatures; ++i) {
+          uint32_t type = ds.read_varuint32();
+          ds.skip(65);                               // k1 / r1 / webauthn compact signature
+          if (type == 2) {                           // webauthn: auth_data, client_json
+            ds.read_bytes();
+            ds.read_bytes();
+          } else if (type > 2) {
+            throw abi_error("unsupported signature type");
+          }
+        }
+        uint32_t cfd = ds.read_varuint32();
+        for (uint32_t i = 0; i < cfd; ++i) ds.read_bytes();
+      }
+
+      std::unordered_set<uint64_t> _watched;
+  };
+
+  //======================== capture file ========================
+  class trace_capture_writer {
+    public:
+      explicit trace_capture_writer(const std::string& path) : _file(std::fopen(path.c_str(), "ab")) {
+        if (!_file) throw abi_error("cannot open capture file " + path);
+      }
+      ~trace_capture_writer() { if (_file) std::fclose(_file); }
+      trace_capture_writer(const trace_capture_writer&) = delete;
+      trace_capture_writer& operator=(const trace_capture_writer&) = delete;
+
+      void write(uint32_t block_num, const captured_transaction& trx) {
+        abi_writer w;
+        w.write(trx.id.data(), trx.id.size());
+        w.write_raw<uint8_t>(trx.status);
+        w.write_raw<uint32_t>(trx.cpu_usage_us);
+        w.write_raw<int64_t>(trx.elapsed_us);
+        w.write_varuint32(static_cast<uint32_t>(trx.actions.size()));
+        for (const auto& act : trx.actions) {
+          w.write_varuint32(act.action_ordinal);
+          w.write_varuint32(act.creator_action_ordinal);
+          w.write_raw<uint64_t>(act.receiver);
+          w.write_raw<uint64_t>(act.account);
+          w.write_raw<uint64_t>(act.name);
+          w.write_varuint32(static_cast<uint32_t>(act.authorization.size()));
+          for (const auto& level : act.authorization) {
+            w.write_raw<uint64_t>(level.first);
+            w.write_raw<uint64_t>(level.second);
+          }
+          w.write_bytes(act.data.data(), act.data.size());
+          w.write_raw<int64_t>(act.elapsed_us);
+          w.write_string(act.console);
+          w.write_bytes(act.return_value.data(), act.return_value.size());
+          w.write_bool(act.failed);
+        }
+        write_record(block_num, TRACE_RECORD_TRANSACTION, w.buffer());
+      }
+
+      void write_deltas(uint32_t block_num, const std::vector<uint8_t>& deltas) {
+        if (!deltas.empty()) write_record(block_num, TRACE_RECORD_DELTAS, deltas);
+      }
+
+    private:
+      void write_record(uint32_t block_num, uint8_t kind, const std::vector<uint8_t>& payload) {
+        uint32_t size = static_cast<uint32_t>(payload.size());
+        std::fwrite(&block_num, sizeof(block_num), 1, _file);
+        std::fwrite(&kind, sizeof(kind), 1, _file);
+        std::fwrite(&size, sizeof(size), 1, _file);
+        if (size) std::fwrite(payload.data(), 1, size, _file);
+      }
+
+      std::FILE* _file;
+  };
+
+  class trace_capture_reader {
+    public:
+      explicit trace_capture_reader(const std::string& path) : _file(std::fopen(path.c_str(), "rb")) {
+        if (!_file) throw abi_error("cannot open capture file " + path);
+      }
+      ~trace_capture_reader() { if (_file) std::fclose(_file); }
+      trace_capture_reader(const trace_capture_reader&) = delete;
+      trace_capture_reader& operator=(const trace_capture_reader&) = delete;
+
+      // Next record, `payload` stays valid until the following call
+      bool next(uint32_t& block_num, uint8_t& kind, byte_view& payload) {
+        uint32_t size;
+        if (std::fread(&block_num, sizeof(block_num), 1, _file) != 1) return false;
+        if (std::fread(&kind, sizeof(kind), 1, _file) != 1 ||
+            std::fread(&size, sizeof(size), 1, _file) != 1) throw abi_error("truncated capture record");
+        _buffer.resize(size);
+        if (size && std::fread(_buffer.data(), 1, size, _file) != size) throw abi_error("truncated capture record");
+        payload = byte_view{_buffer.data(), size};
+        return true;
+      }
+
+      static captured_transaction read_transaction(byte_view payload) {
+        abi_reader ds(payload);
+        captured_transaction trx;
+        trx.id = ds.read_array<32>();
+        trx.status = ds.read_raw<uint8_t>();
+        trx.cpu_usage_us = ds.read_raw<uint32_t>();
+        trx.elapsed_us = ds.read_raw<int64_t>();
+        trx.actions.resize(ds.read_varuint32());
+        for (auto& act : trx.actions) {
+          act.action_ordinal = ds.read_varuint32();
+          act.creator_action_ordinal = ds.read_varuint32();
+          act.receiver = ds.read_raw<uint64_t>();
+          act.account = ds.read_raw<uint64_t>();
+          act.name = ds.read_raw<uint64_t>();
+          act.authorization.resize(ds.read_varuint32());
+          for (auto& level : act.authorization) {
+            level.first = ds.read_raw<uint64_t>();
+            level.second = ds.read_raw<uint64_t>();
+          }
+          byte_view data = ds.read_bytes();
+          act.data.assign(data.data, data.data + data.size);
+          act.elapsed_us = ds.read_raw<int64_t>();
+          act.console = ds.read_string();
+          byte_view ret = ds.read_bytes();
+          act.return_value.assign(ret.data, ret.data + ret.size);
+          act.failed = ds.read_bool();
+        }
+        return trx;
+      }
+
+    private:
+      std::FILE* _file;
+      std::vector<uint8_t> _buffer;
+  };
+}
@@ -0,0 +1,86 @@
+// Licensed under the MIT License..
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing parallel loop for the offline tools.
+//
+// [0, count) is cut in chunks and every worker gets a contiguous share in its own deque.
+// A worker takes chunks from the back of its deque and, once it is empty, steals from the
+// front of the others, so a share that turns out slower (bigger rows, more storage lookups)
+// is finished by the idle workers instead of the whole run waiting for one thread.
+namespace bridge_tools
+{
+  class work_pool {
+    public:
+      explicit work_pool(unsigned threads = 0)
+        : _threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+      unsigned threads() const { return _threads; }
+
+      // Calls task(begin, end, worker) for every chunk, worker is in [0, threads()).
+      // The calling thread is worker 0. Returns once every chunk is done.
+      template<typename Task>
+      void run(size_t count, size_t chunk, Task&& task) {
+        if (count == 0) return;
+        chunk = std::max<size_t>(chunk, 1);
+
+        std::vector<queue> queues(_threads);
+        size_t chunks = (count + chunk - 1) / chunk;
+        for (size_t c = 0; c < chunks; ++c) {
+          size_t begin = c * chunk;
+          queues[c * _threads / chunks].ranges.push_back({begin, std::min(begin + chunk, count)});
+        }
+
+        auto worker = [&](unsigned self) {
+          range r;
+          while (pop(queues[self], r) || steal(queues, self, r)) task(r.begin, r.end, self);
+        };
+
+        std::vector<std::thread> pool;
+        pool.reserve(_threads - 1);
+        for (unsigned t = 1; t < _threads; ++t) pool.emplace_back(worker, t);
+        worker(0);
+        for (auto& thread : pool) thread.join();
+      }
+
+    private:
+      struct range {
+        size_t begin;
+        size_t end;
+      };
+
+      struct queue {
+        std::mutex lock;
+        std::deque<range> ranges;
+      };
+
+      static bool pop(queue& q, range& r) {
+        std::lock_guard<std::mutex> guard(q.lock);
+        if (q.ranges.empty()) return false;
+        r = q.ranges.back();
+        q.ranges.pop_back();
+        return true;
+      }
+
+      // No chunk is added once the run started, so all queues empty means the work is done
+      static bool steal(std::vector<queue>& queues, unsigned self, range& r) {
+        for (size_t i = 1; i < queues.size(); ++i) {
+          queue& victim = queues[(self + i) % queues.size()];
+          std::lock_guard<std::mutex> guard(victim.lock);
+          if (victim.ranges.empty()) continue;
+          r = victim.ranges.front();
+          victim.ranges.pop_front();
+          return true;
+        }
+        return false;
+      }
+
+      unsigned _threads;
+  };
+}
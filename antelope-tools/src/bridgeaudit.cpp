@@ -0,0 +1,154 @@
+// Licensed under the MIT License..
+//
+// bridgeaudit - reconciles evm.boid `requests` with the TokenBridge.sol storage
+//
+//   bridgeaudit --scope <n> [--token <account> --symbol <code>] [--threads <n>] capture.bin [capture2.bin ...]
+//   bridgeaudit --snapshot state.snap [--symbol <code>] [--threads <n>]
+//
+// The capture files are the delta snapshots recorded by `shipmirror live --capture` (start them
+// from the first block of the state history node so both sides are complete). A state snapshot
+// (`shipmirror snapshot` / `shipmirror live --snapshot`) is audited in place, it already holds
+// the scope, layout and contracts it was written with.
+// Common options: --evm <eosio.evm account> --contract <bridge contract> --layout <1|2>
+//                 --bridge <0x TokenBridge.sol address> (resolves the scope when --scope is not given)
+// Exits with 2 when the audit found anything.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <keccak256/k.c>
+#include <bridge_storage.hpp>
+#include <eip55.hpp>
+
+#include "abi_stream.hpp"
+#include "bridge_audit.hpp"
+#include "bridge_mirror.hpp"
+#include "delta_capture.hpp"
+#include "state_snapshot.hpp"
+#include "work_pool.hpp"
+
+using namespace bridge_tools;
+
+namespace
+{
+  struct options {
+    std::vector<std::string> inputs;
+    std::string snapshot;
+    mirror_config mirror;
+    audit_options audit;
+    unsigned threads = 0;
+    size_t limit = 100;
+  };
+
+  [[noreturn]] void usage() {
+    std::fprintf(stderr,
+      "usage: bridgeaudit [options] <capture file>...\n"
+      "       bridgeaudit --snapshot <snapshot file> [options]\n"
+      "options: --scope <evm account index> --bridge <0x address> --layout <1|2> --evm <account> --contract <account>\n"
+      "         --token <token contract> --symbol <symbol code> --decimals <native decimals>\n"
+      "         --threads <n> --chunk <ids per task> --limit <findings printed, 0 = all>\n");
+    std::exit(1);
+  }
+
+  options parse_options(int argc, char** argv) {
+    options opts;
+    std::string symbol;
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) usage();
+        return argv[++i];
+      };
+      if (arg == "--snapshot") opts.snapshot = value();
+      else if (arg == "--scope") opts.mirror.bridge_scope = std::stoull(value());
+      else if (arg == "--bridge") {
+        std::string address = value();
+        evm_bridge::address_status status = evm_bridge::parseChecksummedAddress(address, opts.mirror.bridge_address);
+        if (status != evm_bridge::ADDRESS_OK) {
+          std::fprintf(stderr, "bridgeaudit: --bridge %s: %s\n", address.c_str(), evm_bridge::addressStatusMessage(status));
+          std::exit(1);
+        }
+      }
+      else if (arg == "--layout") {
+        unsigned long layout = std::stoul(value());
+        if (layout != evm_bridge::REQUEST_LAYOUT_V1 && layout != evm_bridge::REQUEST_LAYOUT_V2) usage();
+        opts.mirror.layout = static_cast<evm_bridge::request_layout>(layout);
+      }
+      else if (arg == "--evm") opts.mirror.evm_contract = string_to_name(value());
+      else if (arg == "--contract") opts.mirror.bridge_contract = string_to_name(value());
+      else if (arg == "--token") opts.mirror.token_contract = string_to_name(value());
+      else if (arg == "--symbol") symbol = value();
+      else if (arg == "--decimals") opts.audit.native_decimals = static_cast<uint8_t>(std::stoul(value()));
+      else if (arg == "--threads") opts.threads = std::stoul(value());
+      else if (arg == "--chunk") opts.audit.chunk = std::stoull(value());
+      else if (arg == "--limit") opts.limit = std::stoull(value());
+      else if (arg.rfind("--", 0) == 0) usage();
+      else opts.inputs.push_back(arg);
+    }
+    if (opts.inputs.empty() == opts.snapshot.empty()) usage();
+    if (opts.mirror.token_contract != 0 && symbol.empty()) usage();
+    if (!symbol.empty()) opts.audit.token_symbol = symbol_code_value(symbol);
+    return opts;
+  }
+
+  double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  template<typename State>
+  int audit(const State& state, size_t native_requests, double load_seconds, const options& opts) {
+    if (state.bridge_scope() == 0) throw abi_error("bridge scope unknown, pass --scope or --bridge");
+
+    work_pool pool(opts.threads);
+    auto start = std::chrono::steady_clock::now();
+    audit_report report = basic_bridge_audit<State>(state, state.config().layout, opts.audit).run(pool);
+    double audit_seconds = seconds_since(start);
+
+    size_t printed = 0;
+    for (const auto& finding : report.findings) {
+      if (opts.limit && printed++ >= opts.limit) break;
+      std::printf("request %llu: %s%s%s\n", (unsigned long long)finding.request_id, to_string(finding.issue),
+        finding.detail.empty() ? "" : " ", finding.detail.c_str());
+    }
+
+    std::printf("bridge scope: %llu, storage slots: %zu, native requests: %zu, active on evm: %llu\n",
+      (unsigned long long)state.bridge_scope(), state.storage_size(), native_requests,
+      (unsigned long long)report.active_checked);
+    std::printf("checked %llu requests on %u threads in %.3fs (load %.3fs), unpaid %llu\n",
+      (unsigned long long)report.requests_checked, pool.threads(), audit_seconds, load_seconds,
+      (unsigned long long)report.unpaid_amount);
+    for (size_t i = 0; i < AUDIT_ISSUE_COUNT; ++i) {
+      if (report.counts[i]) std::printf("%s: %llu\n", to_string(static_cast<audit_issue>(i)), (unsigned long long)report.counts[i]);
+    }
+    return report.total() ? 2 : 0;
+  }
+}
+
+int main(int argc, char** argv) {
+  try {
+    options opts = parse_options(argc, argv);
+    auto start = std::chrono::steady_clock::now();
+    if (!opts.snapshot.empty()) {
+      snapshot_view view(opts.snapshot);
+      size_t native_requests = 0;
+      view.for_each_request_id([&](uint64_t) { ++native_requests; });
+      return audit(view, native_requests, seconds_since(start), opts);
+    }
+
+    bridge_mirror mirror(opts.mirror);
+    for (const auto& path : opts.inputs) {
+      delta_capture_reader reader(path);
+      uint32_t block_num;
+      byte_view deltas;
+      while (reader.next(block_num, deltas)) mirror.apply_deltas(deltas.data, deltas.size);
+    }
+    return audit(mirror, mirror.requests().size(), seconds_since(start), opts);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "bridgeaudit: %s\n", e.what());
+    return 1;
+  }
+}
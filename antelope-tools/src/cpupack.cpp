@@ -0,0 +1,195 @@
+// Licensed under the MIT License..
+//
+// cpupack - fits the relayer's CPU cost model from receipts and packs pending work into transactions
+//
+//   cpupack calibrate --scope <n> [--model model.txt] capture.bin [capture2.bin ...]
+//   cpupack pack --model model.txt [--target-us n] [--safety k] [--max-actions n] (--snapshot state.snap | --rows n) < pending.txt
+//
+// calibrate reads `tracereplay capture` files: every executed transaction whose root actions are
+// all evm.boid actions is a receipt, the captured deltas are replayed into a mirror to know how
+// many rows the actions looked up at the time. The fitted model is written to --model.
+// pack reads `<action> <request id>` lines (the relayer's backlog, oldest first) and prints one
+// line per transaction: predicted cpu_us, action count and the actions (reqnotify:12,reqnotify:13).
+// The current table sizes come from a state snapshot (shipmirror live --snapshot) or --rows.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <keccak256/k.c>
+#include <bridge_storage.hpp>
+#include <eip55.hpp>
+
+#include "abi_stream.hpp"
+#include "bridge_mirror.hpp"
+#include "cpu_packer.hpp"
+#include "state_snapshot.hpp"
+#include "trace_capture.hpp"
+
+using namespace bridge_tools;
+
+namespace
+{
+  struct options {
+    std::string mode;
+    std::vector<std::string> inputs;
+    std::string model;
+    std::string snapshot;
+    uint64_t rows = 0;
+    bool rows_given = false;
+    mirror_config mirror;
+    packer_options packer;
+  };
+
+  [[noreturn]] void usage() {
+    std::fprintf(stderr,
+      "usage: cpupack calibrate [options] [--model <out file>] <trace capture>...\n"
+      "       cpupack pack --model <file> [--target-us <n>] [--safety <sigmas>] [--max-actions <n>]\n"
+      "                    (--snapshot <file> | --rows <n>) < pending\n"
+      "options: --scope <evm account index> --bridge <0x address> --evm <account> --contract <account>\n");
+    std::exit(1);
+  }
+
+  options parse_options(int argc, char** argv) {
+    if (argc < 2) usage();
+    options opts;
+    opts.mode = argv[1];
+    for (int i = 2; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) usage();
+        return argv[++i];
+      };
+      if (arg == "--model") opts.model = value();
+      else if (arg == "--snapshot") opts.snapshot = value();
+      else if (arg == "--rows") {
+        opts.rows = std::stoull(value());
+        opts.rows_given = true;
+      }
+      else if (arg == "--target-us") opts.packer.target_us = std::stod(value());
+      else if (arg == "--safety") opts.packer.safety = std::stod(value());
+      else if (arg == "--max-actions") opts.packer.max_actions = std::stoull(value());
+      else if (arg == "--scope") opts.mirror.bridge_scope = std::stoull(value());
+      else if (arg == "--bridge") {
+        std::string address = value();
+        evm_bridge::address_status status = evm_bridge::parseChecksummedAddress(address, opts.mirror.bridge_address);
+        if (status != evm_bridge::ADDRESS_OK) {
+          std::fprintf(stderr, "cpupack: --bridge %s: %s\n", address.c_str(), evm_bridge::addressStatusMessage(status));
+          std::exit(1);
+        }
+      }
+      else if (arg == "--evm") opts.mirror.evm_contract = string_to_name(value());
+      else if (arg == "--contract") opts.mirror.bridge_contract = string_to_name(value());
+      else if (arg.rfind("--", 0) == 0) usage();
+      else opts.inputs.push_back(arg);
+    }
+
+    if (opts.mode == "calibrate") {
+      if (opts.inputs.empty()) usage();
+    } else if (opts.mode == "pack") {
+      if (!opts.inputs.empty() || opts.model.empty() || opts.snapshot.empty() == !opts.rows_given) usage();
+    } else {
+      usage();
+    }
+    return opts;
+  }
+
+  // Rows an evm.boid action looks up: its `requests` table and the bridge storage
+  template<typename State>
+  uint64_t rows_of(const State& state, size_t requests) {
+    return requests + state.storage_size();
+  }
+
+  //======================== calibrate ========================
+  int calibrate(const options& opts) {
+    cpu_cost_model model;
+    bridge_mirror mirror(opts.mirror);
+    uint64_t skipped = 0;
+
+    for (const auto& path : opts.inputs) {
+      trace_capture_reader reader(path);
+      uint32_t block_num;
+      uint8_t kind;
+      byte_view payload;
+      while (reader.next(block_num, kind, payload)) {
+        if (kind == TRACE_RECORD_DELTAS) {
+          mirror.apply_deltas(payload.data, payload.size);
+          continue;
+        }
+        captured_transaction trx = trace_capture_reader::read_transaction(payload);
+        // The deltas of a block follow its transactions, the sizes are the ones before the block
+        uint64_t rows = rows_of(mirror, mirror.requests().size());
+        std::vector<cost_sample> actions;
+        bool bridge_only = trx.executed();
+        for (const auto& act : trx.actions) {
+          if (act.creator_action_ordinal != 0 || act.receiver != act.account) continue;
+          if (act.account != opts.mirror.bridge_contract) bridge_only = false;
+          actions.push_back({act.name, rows});
+        }
+        if (!bridge_only || actions.empty()) {
+          ++skipped;
+          continue;
+        }
+        model.observe(actions, trx.cpu_usage_us);
+      }
+    }
+
+    std::printf("receipts: %llu (skipped %llu), mean abs error %.1fus, sigma %.1fus, drifts %llu\n",
+      (unsigned long long)model.samples(), (unsigned long long)skipped, model.mean_abs_error(), model.sigma(),
+      (unsigned long long)model.drifts());
+    std::printf("overhead %.1fus\n", model.overhead());
+    for (const auto& [action, i] : model.ordered_actions()) {
+      std::printf("%-12s %8.1fus + %6.2fus per log2 row\n", name_to_string(action).c_str(), model.parameter(i), model.parameter(i + 1));
+    }
+    if (!opts.model.empty()) model.save(opts.model);
+    return 0;
+  }
+
+  //======================== pack ========================
+  int pack(const options& opts) {
+    cpu_cost_model model = cpu_cost_model::load(opts.model);
+    uint64_t rows = opts.rows;
+    if (!opts.snapshot.empty()) {
+      snapshot_view view(opts.snapshot);
+      size_t requests = 0;
+      view.for_each_request_id([&](uint64_t) { ++requests; });
+      rows = rows_of(view, requests);
+    }
+
+    std::vector<pending_action> pending;
+    std::string action;
+    uint64_t request_id;
+    while (std::cin >> action >> request_id) pending.push_back({string_to_name(action), request_id, rows});
+
+    cpu_packer packer(model, opts.packer);
+    auto transactions = packer.pack(pending);
+    size_t oversize = 0;
+    for (const auto& trx : transactions) {
+      std::string list;
+      for (const auto& act : trx.actions) {
+        if (!list.empty()) list += ",";
+        list += name_to_string(act.action) + ":" + std::to_string(act.request_id);
+      }
+      std::printf("%.0f\t%zu\t%s%s\n", trx.predicted_us, trx.actions.size(), list.c_str(), trx.oversize ? "\toversize" : "");
+      if (trx.oversize) ++oversize;
+    }
+    std::fprintf(stderr, "%zu actions in %zu transactions (%zu over the target), rows %llu, sigma %.1fus\n",
+      pending.size(), transactions.size(), oversize, (unsigned long long)rows, model.sigma());
+    return 0;
+  }
+}
+
+int main(int argc, char** argv) {
+  options opts = parse_options(argc, argv);
+  try {
+    if (opts.mode == "calibrate") return calibrate(opts);
+    return pack(opts);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "cpupack: %s\n", e.what());
+    return 1;
+  }
+}
@@ -0,0 +1,607 @@
+// Licensed under the MIT License..
+//
+// loadgen - end-to-end throughput and latency of the bridge on a local chain
+//
+//   loadgen accounts --prefix <p> --count <n>
+//   loadgen run --key <public key> --fee-symbol <p,SYM> --fee <units> [options]
+//
+// accounts prints the load account names (prefix + 4 characters) for the setup script.
+// run drives both directions from those accounts at a Poisson arrival rate:
+//  - to EVM:    fee + token transfers to xsend.boid in one transaction -> evm.boid `bridge`
+//               -> eosio.evm raw (logsettle BRIDGED, or QUEUED then BRIDGED on flush)
+//  - to native: eosio.evm `request` (the stub's stand-in for TokenBridge.sol bridge()) -> the
+//               built-in relayer sends reqnotify -> finalize pays out (logsettle NOTIFIED, RELEASED)
+// The transactions are signed by keosd before the clock starts, the relayer signs while it runs
+// like a real one. Stage times are taken when the block holding the event arrives over SHiP
+// (head blocks, one producer, no fork handling), the report gives p50 / p99 / p999 per stage.
+// --ramp repeats the run with the rate multiplied each round until completion drops below
+// --min-completion or the end-to-end p99 goes over --max-p99-ms, the last good round is the
+// saturation throughput.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <keccak256/k.c>
+#include <eip55.hpp>
+#include <hex_codec.hpp>
+
+#include "abi_stream.hpp"
+#include "chain_api.hpp"
+#include "latency_histogram.hpp"
+#include "ship_client.hpp"
+#include "trace_capture.hpp"
+#include "work_pool.hpp"
+
+using namespace bridge_tools;
+
+namespace
+{
+  // Same values as settle_outcome in include_tokenBridge/settlement.hpp
+  enum settle_outcome : uint8_t {
+    SETTLE_BRIDGED  = 1,
+    SETTLE_NOTIFIED = 2,
+    SETTLE_RELEASED = 3,
+    SETTLE_QUEUED   = 4
+  };
+
+  enum direction : uint8_t {
+    TO_EVM    = 0,
+    TO_NATIVE = 1
+  };
+
+  // Account name suffixes, fixed width so the names sort like their index
+  const char ACCOUNT_CHARS[] = "12345abcdefghijklmnopqrstuvwxyz";
+  const size_t ACCOUNT_SUFFIX = 4;
+
+  struct options {
+    std::string mode;
+    http_endpoint chain = {"127.0.0.1", "8888"};
+    http_endpoint wallet = {"127.0.0.1", "8900"};
+    http_endpoint ship = {"127.0.0.1", "8080"};
+    std::string key;
+    std::string prefix = "load";
+    uint64_t accounts = 100;
+    std::string direction = "both";
+    double to_evm_share = 0.5;
+    double rate = 20;
+    double duration = 30;
+    double drain = 30;
+    unsigned threads = 8;
+    unsigned sign_threads = 8;
+    unsigned relay_threads = 4;
+    std::string evm_receiver = "0x0000000000000000000000000000000000000001";
+    uint64_t token = string_to_name("token.boid");
+    std::string symbol = "4,BOID";
+    uint64_t fee_token = 0;
+    std::string fee_symbol;
+    int64_t fee = 0;
+    int64_t amount = 10000;
+    uint64_t bridge = string_to_name("evm.boid");
+    uint64_t fees = string_to_name("xsend.boid");
+    uint64_t evm = string_to_name("eosio.evm");
+    uint64_t relayer = 0;
+    uint64_t seed = 1;
+    double ramp = 0;
+    double max_rate = 0;
+    double max_p99_ms = 0;
+    double min_completion = 0.95;
+  };
+
+  [[noreturn]] void usage() {
+    std::fprintf(stderr,
+      "usage: loadgen accounts [--prefix <p>] [--count <n>]\n"
+      "       loadgen run --key <public key> [--fee-symbol <p,SYM> --fee <units>] [options]\n"
+      "options: --chain <host:port> --wallet <host:port> --ship <host:port>\n"
+      "         --prefix <p> --accounts <n> --direction <both|to-evm|to-native> --to-evm-share <0..1>\n"
+      "         --rate <trx/s> --duration <s> --drain <s> --threads <n> --sign-threads <n> --relay-threads <n>\n"
+      "         --evm-receiver <0x address> --token <account> --symbol <p,SYM> --fee-token <account> --amount <units>\n"
+      "         --bridge <account> --fees <account> --evm <account> --relayer <account> --seed <n>\n"
+      "         --ramp <factor> --max-rate <trx/s> --max-p99-ms <ms> --min-completion <0..1>\n");
+    std::exit(1);
+  }
+
+  options parse_options(int argc, char** argv) {
+    if (argc < 2) usage();
+    options opts;
+    opts.mode = argv[1];
+    for (int i = 2; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) usage();
+        return argv[++i];
+      };
+      if (arg == "--chain") opts.chain = http_endpoint::parse(value());
+      else if (arg == "--wallet") opts.wallet = http_endpoint::parse(value());
+      else if (arg == "--ship") opts.ship = http_endpoint::parse(value());
+      else if (arg == "--key") opts.key = value();
+      else if (arg == "--prefix") opts.prefix = value();
+      else if (arg == "--accounts" || arg == "--count") opts.accounts = std::stoull(value());
+      else if (arg == "--direction") opts.direction = value();
+      else if (arg == "--to-evm-share") opts.to_evm_share = std::stod(value());
+      else if (arg == "--rate") opts.rate = std::stod(value());
+      else if (arg == "--duration") opts.duration = std::stod(value());
+      else if (arg == "--drain") opts.drain = std::stod(value());
+      else if (arg == "--threads") opts.threads = std::stoul(value());
+      else if (arg == "--sign-threads") opts.sign_threads = std::stoul(value());
+      else if (arg == "--relay-threads") opts.relay_threads = std::stoul(value());
+      else if (arg == "--evm-receiver") opts.evm_receiver = value();
+      else if (arg == "--token") opts.token = string_to_name(value());
+      else if (arg == "--symbol") opts.symbol = value();
+      else if (arg == "--fee-token") opts.fee_token = string_to_name(value());
+      else if (arg == "--fee-symbol") opts.fee_symbol = value();
+      else if (arg == "--fee") opts.fee = std::stoll(value());
+      else if (arg == "--amount") opts.amount = std::stoll(value());
+      else if (arg == "--bridge") opts.bridge = string_to_name(value());
+      else if (arg == "--fees") opts.fees = string_to_name(value());
+      else if (arg == "--evm") opts.evm = string_to_name(value());
+      else if (arg == "--relayer") opts.relayer = string_to_name(value());
+      else if (arg == "--seed") opts.seed = std::stoull(value());
+      else if (arg == "--ramp") opts.ramp = std::stod(value());
+      else if (arg == "--max-rate") opts.max_rate = std::stod(value());
+      else if (arg == "--max-p99-ms") opts.max_p99_ms = std::stod(value());
+      else if (arg == "--min-completion") opts.min_completion = std::stod(value());
+      else usage();
+    }
+
+    if (opts.mode == "accounts") return opts;
+    if (opts.mode != "run" || opts.key.empty() || opts.rate <= 0 || opts.duration <= 0 || opts.accounts == 0) usage();
+    if (opts.direction == "to-evm") opts.to_evm_share = 1;
+    else if (opts.direction == "to-native") opts.to_evm_share = 0;
+    else if (opts.direction != "both") usage();
+    if (opts.to_evm_share > 0 && (opts.fee_symbol.empty() || opts.fee <= 0)) usage();
+    if (opts.ramp != 0 && (opts.ramp <= 1 || opts.max_rate < opts.rate)) usage();
+    if (opts.threads == 0 || opts.sign_threads == 0 || opts.relay_threads == 0) usage();
+    if (!opts.fee_token) opts.fee_token = opts.token;
+    if (!opts.relayer) opts.relayer = opts.bridge;
+    return opts;
+  }
+
+  std::string account_name(const std::string& prefix, uint64_t index) {
+    std::string suffix(ACCOUNT_SUFFIX, ACCOUNT_CHARS[0]);
+    for (size_t i = ACCOUNT_SUFFIX; i-- > 0; index /= sizeof(ACCOUNT_CHARS) - 1) {
+      suffix[i] = ACCOUNT_CHARS[index % (sizeof(ACCOUNT_CHARS) - 1)];
+    }
+    return prefix + suffix;
+  }
+
+  // "4,BOID" -> the symbol as packed in an asset
+  uint64_t parse_symbol(const std::string& text) {
+    size_t comma = text.find(',');
+    if (comma == std::string::npos || comma == 0 || text.size() - comma - 1 > 7) throw abi_error("bad symbol " + text);
+    uint64_t value = std::stoul(text.substr(0, comma));
+    for (size_t i = comma + 1; i < text.size(); ++i) {
+      if (text[i] < 'A' || text[i] > 'Z') throw abi_error("bad symbol " + text);
+      value |= uint64_t(uint8_t(text[i])) << (8 * (i - comma));
+    }
+    return value;
+  }
+
+  std::vector<uint8_t> transfer_data(uint64_t from, uint64_t to, int64_t amount, uint64_t symbol, const std::string& memo) {
+    abi_writer w;
+    w.write_raw<uint64_t>(from);
+    w.write_raw<uint64_t>(to);
+    w.write_raw<int64_t>(amount);
+    w.write_raw<uint64_t>(symbol);
+    w.write_string(memo);
+    return w.buffer();
+  }
+
+  using clock_type = std::chrono::steady_clock;
+
+  //======================== Load ========================
+  // One bridge transfer and the time (us since the round started, 0 = not reached) of every stage
+  struct transfer_record {
+    uint8_t dir = TO_EVM;
+    uint64_t user = 0;
+    int64_t amount = 0;        // unique in the run, finds the to-EVM transfer in logsettle
+    int64_t due_us = 0;        // when the schedule wants it submitted
+    signed_transaction trx;
+
+    std::atomic<int64_t> submitted{0};
+    std::atomic<int64_t> accepted{0};   // push_transaction returned
+    std::atomic<int64_t> included{0};   // its block arrived over SHiP
+    std::atomic<int64_t> queued{0};     // to EVM: logsettle QUEUED (queued mode of evm.boid)
+    std::atomic<int64_t> relayed{0};    // to native: reqnotify pushed by the relayer
+    std::atomic<int64_t> notified{0};   // to native: logsettle NOTIFIED
+    std::atomic<int64_t> settled{0};    // logsettle BRIDGED / RELEASED
+    std::atomic<bool> failed{false};
+  };
+
+  struct relay_job {
+    size_t record;
+    uint64_t request_id;
+  };
+
+  class load_round {
+    public:
+      load_round(const options& opts, double rate, uint64_t first_amount)
+        : _opts(opts), _rate(rate), _first_amount(first_amount) {}
+
+      // Builds the schedule and signs every transaction, returns the next free amount
+      uint64_t prepare(uint32_t round) {
+        chain_api api(_opts.chain, _opts.wallet);
+        _info = api.get_info();
+
+        std::mt19937_64 rng(_opts.seed + round);
+        std::exponential_distribution<double> gap(_rate);
+        std::uniform_int_distribution<uint64_t> user(0, _opts.accounts - 1);
+        std::bernoulli_distribution to_evm(_opts.to_evm_share);
+        std::vector<std::pair<uint8_t, uint64_t>> picks;
+        std::vector<int64_t> due;
+        for (double t = gap(rng); t < _opts.duration; t += gap(rng)) {
+          due.push_back(static_cast<int64_t>(t * 1e6));
+          uint8_t dir = to_evm(rng) ? TO_EVM : TO_NATIVE;
+          picks.push_back({dir, string_to_name(account_name(_opts.prefix, user(rng)))});
+        }
+
+        _records = std::vector<transfer_record>(due.size());
+        const uint32_t expiration = static_cast<uint32_t>(std::time(nullptr) +
+          std::min<double>(3500, _opts.duration + _opts.drain + 60));
+        const uint64_t symbol = parse_symbol(_opts.symbol);
+        const uint64_t fee_symbol = _opts.to_evm_share > 0 ? parse_symbol(_opts.fee_symbol) : 0;
+        for (size_t i = 0; i < _records.size(); ++i) {
+          _records[i].dir = picks[i].first;
+          _records[i].user = picks[i].second;
+          _records[i].amount = static_cast<int64_t>(_first_amount + i);
+          _records[i].due_us = due[i];
+        }
+
+        std::fprintf(stderr, "round %u: signing %zu transactions at %.1f/s\n", round, _records.size(), _rate);
+        work_pool pool(_opts.sign_threads);
+        std::vector<std::unique_ptr<chain_api>> apis(pool.threads());
+        pool.run(_records.size(), 64, [&](size_t begin, size_t end, unsigned worker) {
+          if (!apis[worker]) apis[worker] = std::make_unique<chain_api>(_opts.chain, _opts.wallet);
+          for (size_t i = begin; i < end; ++i) {
+            transfer_record& rec = _records[i];
+            chain_transaction trx = base_transaction(expiration);
+            if (rec.dir == TO_EVM) {
+              trx.actions.push_back({_opts.fee_token, string_to_name("transfer"), rec.user,
+                transfer_data(rec.user, _opts.fees, _opts.fee, fee_symbol, "")});
+              trx.actions.push_back({_opts.token, string_to_name("transfer"), rec.user,
+                transfer_data(rec.user, _opts.fees, rec.amount, symbol, _opts.evm_receiver)});
+            } else {
+              abi_writer w;
+              w.write_raw<uint64_t>(rec.user);
+              w.write_raw<uint64_t>(rec.user); // paid back to the same account
+              w.write_raw<uint64_t>(static_cast<uint64_t>(rec.amount));
+              w.write_string("");
+              trx.actions.push_back({_opts.evm, string_to_name("request"), rec.user, w.buffer()});
+            }
+            rec.trx = apis[worker]->sign(trx, _opts.key, _info.chain_id);
+          }
+        });
+
+        for (size_t i = 0; i < _records.size(); ++i) {
+          _by_trx[evm_bridge::toHex(_records[i].trx.id)] = i;
+          if (_records[i].dir == TO_EVM) _by_amount[static_cast<uint64_t>(_records[i].amount)] = i;
+        }
+        return _first_amount + _records.size();
+      }
+
+      void run() {
+        chain_api api(_opts.chain, _opts.wallet);
+        const uint32_t start_block = api.get_info().head_block_num + 1;
+        _start = clock_type::now();
+
+        std::thread observer([&] { observe(start_block); });
+        std::vector<std::thread> relayers;
+        for (unsigned i = 0; i < _opts.relay_threads; ++i) relayers.emplace_back([&] { relay(); });
+
+        std::vector<latency_histogram> lags(_opts.threads);
+        std::vector<std::thread> submitters;
+        for (unsigned t = 0; t < _opts.threads; ++t) {
+          submitters.emplace_back([&, t] { submit(t, lags[t]); });
+        }
+        for (auto& thread : submitters) thread.join();
+        for (const auto& lag : lags) _lag.merge(lag);
+
+        // Drain: wait for the pipeline to finish what was submitted
+        const auto deadline = clock_type::now() + std::chrono::microseconds(static_cast<int64_t>(_opts.drain * 1e6));
+        while (_completed.load() + _failed.load() < _records.size() && clock_type::now() < deadline && !_observer_done.load()) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        {
+          std::lock_guard<std::mutex> lock(_relay_mutex);
+          _stop = true;
+        }
+        _relay_ready.notify_all();
+        for (auto& thread : relayers) thread.join();
+        observer.join();
+      }
+
+      //======================== Report ========================
+      struct summary {
+        double completed_rate = 0;
+        double completion = 0;
+        uint64_t end_to_end_p99_us = 0;
+      };
+
+      summary report() const {
+        latency_histogram accept[2], include[2], queue, relay, notify, settle[2];
+        size_t count[2] = {}, completed = 0, failed = 0;
+        int64_t first_submit = 0, last_settle = 0;
+        for (const auto& rec : _records) {
+          const int64_t submitted = rec.submitted.load();
+          if (!submitted) continue;
+          ++count[rec.dir];
+          first_submit = first_submit ? std::min(first_submit, submitted) : submitted;
+          if (rec.failed.load()) ++failed;
+          auto since = [&](const std::atomic<int64_t>& stage, int64_t from, latency_histogram& h) {
+            const int64_t at = stage.load();
+            if (at && from && at >= from) h.record(static_cast<uint64_t>(at - from));
+          };
+          since(rec.accepted, submitted, accept[rec.dir]);
+          since(rec.included, submitted, include[rec.dir]);
+          if (rec.dir == TO_EVM) {
+            since(rec.queued, submitted, queue);
+          } else {
+            since(rec.relayed, rec.included.load(), relay);
+            since(rec.notified, rec.relayed.load(), notify);
+          }
+          since(rec.settled, submitted, settle[rec.dir]);
+          if (rec.settled.load()) {
+            ++completed;
+            last_settle = std::max(last_settle, rec.settled.load());
+          }
+        }
+
+        const size_t submitted = count[TO_EVM] + count[TO_NATIVE];
+        const double window = last_settle > first_submit ? double(last_settle - first_submit) / 1e6 : 0;
+        summary out;
+        out.completion = submitted ? double(completed) / double(submitted) : 0;
+        out.completed_rate = window > 0 ? double(completed) / window : 0;
+
+        std::printf("offered %.1f/s: submitted %zu in %.1fs, completed %zu (%.1f%%) at %.1f/s, failed %zu, submit lag p99 %.1fms\n",
+          _rate, submitted, _opts.duration, completed, 100 * out.completion, out.completed_rate, failed, ms(_lag.percentile(0.99)));
+        if (!_first_error.empty()) std::printf("first error: %s\n", _first_error.c_str());
+        std::printf("%-24s %8s %10s %10s %10s %10s\n", "stage (ms)", "count", "p50", "p99", "p999", "max");
+        auto line = [](const char* name, const latency_histogram& h) {
+          if (!h.count()) return;
+          std::printf("%-24s %8llu %10.1f %10.1f %10.1f %10.1f\n", name, (unsigned long long)h.count(),
+            ms(h.percentile(0.5)), ms(h.percentile(0.99)), ms(h.percentile(0.999)), ms(h.max()));
+        };
+        if (count[TO_EVM]) {
+          line("to-evm accepted", accept[TO_EVM]);
+          line("to-evm included", include[TO_EVM]);
+          line("to-evm queued", queue);
+          line("to-evm bridged (e2e)", settle[TO_EVM]);
+        }
+        if (count[TO_NATIVE]) {
+          line("to-native accepted", accept[TO_NATIVE]);
+          line("to-native included", include[TO_NATIVE]);
+          line("to-native relay wait", relay);
+          line("to-native notify", notify);
+          line("to-native released (e2e)", settle[TO_NATIVE]);
+        }
+
+        latency_histogram both = settle[TO_EVM];
+        both.merge(settle[TO_NATIVE]);
+        out.end_to_end_p99_us = both.percentile(0.99);
+        return out;
+      }
+
+    private:
+      static double ms(uint64_t us) { return double(us) / 1000; }
+
+      int64_t now_us() const {
+        return std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - _start).count());
+      }
+
+      chain_transaction base_transaction(uint32_t expiration) const {
+        chain_transaction trx;
+        trx.expiration = expiration;
+        trx.ref_block_num = _info.ref_block_num;
+        trx.ref_block_prefix = _info.ref_block_prefix;
+        return trx;
+      }
+
+      void fail(transfer_record& rec, const std::string& error) {
+        if (rec.failed.exchange(true)) return;
+        ++_failed;
+        std::lock_guard<std::mutex> lock(_error_mutex);
+        if (_first_error.empty()) _first_error = error;
+      }
+
+      // Thread t pushes records t, t + threads, ... at their due time (the schedule is sorted)
+      void submit(unsigned t, latency_histogram& lag) {
+        chain_api api(_opts.chain, _opts.wallet);
+        for (size_t i = t; i < _records.size(); i += _opts.threads) {
+          transfer_record& rec = _records[i];
+          std::this_thread::sleep_until(_start + std::chrono::microseconds(rec.due_us));
+          const int64_t at = now_us();
+          rec.submitted = at;
+          lag.record(static_cast<uint64_t>(std::max<int64_t>(0, at - rec.due_us)));
+          try {
+            // A different id means the packing differs from what nodeos parsed, SHiP would never match it
+            if (api.push(rec.trx) != evm_bridge::toHex(rec.trx.id)) fail(rec, "transaction id mismatch");
+            rec.accepted = now_us();
+          } catch (const chain_error& e) {
+            fail(rec, e.what());
+          }
+        }
+      }
+
+      // The relayer: reqnotify for every request id the observer found
+      void relay() {
+        chain_api api(_opts.chain, _opts.wallet);
+        for (;;) {
+          relay_job job;
+          {
+            std::unique_lock<std::mutex> lock(_relay_mutex);
+            _relay_ready.wait(lock, [&] { return _stop || !_relay_queue.empty(); });
+            if (_relay_queue.empty()) return;
+            job = _relay_queue.front();
+            _relay_queue.pop_front();
+          }
+          transfer_record& rec = _records[job.record];
+          chain_transaction trx = base_transaction(static_cast<uint32_t>(std::time(nullptr) + 300));
+          abi_writer w;
+          w.write_raw<uint64_t>(job.request_id);
+          trx.actions.push_back({_opts.bridge, string_to_name("reqnotify"), _opts.relayer, w.buffer()});
+          try {
+            api.push(api.sign(trx, _opts.key, _info.chain_id));
+            rec.relayed = now_us();
+          } catch (const chain_error& e) {
+            fail(rec, e.what());
+          }
+        }
+      }
+
+      void observe(uint32_t start_block) {
+        const uint64_t logsettle = string_to_name("logsettle");
+        const uint64_t request = string_to_name("request");
+        trace_parser parser({_opts.bridge, _opts.fees, _opts.evm});
+        std::unordered_map<uint64_t, size_t> by_request;
+
+        auto settle = [&](transfer_record& rec, int64_t at) {
+          int64_t expected = 0;
+          if (rec.settled.compare_exchange_strong(expected, at)) ++_completed;
+        };
+
+        ship_request req;
+        req.start_block = start_block;
+        req.irreversible_only = false;
+        req.fetch_traces = true;
+        try {
+          ship_client(_opts.ship.host, _opts.ship.port).run(req, [&](uint32_t, byte_view, byte_view traces) {
+            const int64_t at = now_us();
+            std::vector<captured_transaction> transactions;
+            if (traces.size) transactions = parser.parse(traces);
+            for (const auto& trx : transactions) {
+              auto own = _by_trx.find(evm_bridge::toHex(trx.id));
+              if (own != _by_trx.end()) {
+                transfer_record& rec = _records[own->second];
+                rec.included = at;
+                if (!trx.executed()) fail(rec, "transaction " + own->first + " failed with status " + std::to_string(trx.status));
+              }
+
+              for (const auto& act : trx.actions) {
+                if (act.receiver != act.account) continue;
+                if (act.account == _opts.evm && act.name == request && own != _by_trx.end() && act.return_value.size() == 8) {
+                  uint64_t id = abi_reader(act.return_value.data(), 8).read_raw<uint64_t>();
+                  by_request[id] = own->second;
+                  {
+                    std::lock_guard<std::mutex> lock(_relay_mutex);
+                    _relay_queue.push_back({own->second, id});
+                  }
+                  _relay_ready.notify_one();
+                }
+                if (act.account != _opts.bridge || act.name != logsettle) continue;
+
+                // settlement: request_id, amount, receiver, evm_address, evm_nonce, outcome
+                abi_reader ds(act.data.data(), act.data.size());
+                const uint64_t request_id = ds.read_raw<uint64_t>();
+                const uint64_t amount = ds.read_raw<uint64_t>();
+                ds.skip(8 + 20 + 8);
+                const uint8_t outcome = ds.read_raw<uint8_t>();
+                if (outcome == SETTLE_BRIDGED || outcome == SETTLE_QUEUED) {
+                  auto it = _by_amount.find(amount);
+                  if (it == _by_amount.end()) continue;
+                  if (outcome == SETTLE_QUEUED) _records[it->second].queued = at;
+                  else settle(_records[it->second], at);
+                } else {
+                  auto it = by_request.find(request_id);
+                  if (it == by_request.end()) continue;
+                  if (outcome == SETTLE_NOTIFIED) _records[it->second].notified = at;
+                  else settle(_records[it->second], at);
+                }
+              }
+            }
+            std::lock_guard<std::mutex> lock(_relay_mutex);
+            return !_stop;
+          });
+        } catch (const std::exception& e) {
+          std::lock_guard<std::mutex> lock(_error_mutex);
+          _first_error = std::string("state history: ") + e.what();
+        }
+        _observer_done = true;
+      }
+
+      const options& _opts;
+      double _rate;
+      uint64_t _first_amount;
+      chain_info _info;
+      std::vector<transfer_record> _records;
+      std::unordered_map<std::string, size_t> _by_trx;
+      std::unordered_map<uint64_t, size_t> _by_amount;
+      clock_type::time_point _start;
+      latency_histogram _lag;
+
+      std::mutex _relay_mutex;
+      std::condition_variable _relay_ready;
+      std::deque<relay_job> _relay_queue;
+      bool _stop = false;
+
+      std::atomic<size_t> _completed{0};
+      std::atomic<size_t> _failed{0};
+      std::atomic<bool> _observer_done{false};
+      std::mutex _error_mutex;
+      std::string _first_error;
+  };
+
+  //======================== Modes ========================
+  int accounts(const options& opts) {
+    if (opts.prefix.size() + ACCOUNT_SUFFIX > 12) throw abi_error("--prefix is longer than 8 characters");
+    for (uint64_t i = 0; i < opts.accounts; ++i) {
+      std::string name = account_name(opts.prefix, i);
+      string_to_name(name); // rejects prefixes that are not a valid name
+      std::printf("%s\n", name.c_str());
+    }
+    return 0;
+  }
+
+  int run(const options& opts) {
+    evm_bridge::evm_address_bytes receiver;
+    evm_bridge::address_status status = evm_bridge::parseChecksummedAddress(opts.evm_receiver, receiver);
+    if (status != evm_bridge::ADDRESS_OK) {
+      std::fprintf(stderr, "loadgen: --evm-receiver %s: %s\n", opts.evm_receiver.c_str(), evm_bridge::addressStatusMessage(status));
+      return 1;
+    }
+
+    // Amounts start above --amount and never repeat, every transaction of the run is unique
+    uint64_t next_amount = static_cast<uint64_t>(opts.amount);
+    double rate = opts.rate, saturation = 0;
+    for (uint32_t round = 1;; ++round) {
+      load_round load(opts, rate, next_amount);
+      next_amount = load.prepare(round);
+      load.run();
+      load_round::summary result = load.report();
+
+      const bool saturated = result.completion < opts.min_completion ||
+        (opts.max_p99_ms > 0 && double(result.end_to_end_p99_us) / 1000 > opts.max_p99_ms);
+      if (opts.ramp == 0) return 0;
+      if (saturated) break;
+      saturation = result.completed_rate;
+      rate *= opts.ramp;
+      if (rate > opts.max_rate) break;
+      std::printf("\n");
+    }
+    if (saturation > 0) std::printf("\nsaturation throughput: %.1f transfers/s\n", saturation);
+    else std::printf("\nsaturated at the first rate, lower --rate\n");
+    return 0;
+  }
+}
+
+int main(int argc, char** argv) {
+  options opts = parse_options(argc, argv);
+  try {
+    if (opts.mode == "accounts") return accounts(opts);
+    return run(opts);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "loadgen: %s\n", e.what());
+    return 1;
+  }
+}
@@ -0,0 +1,105 @@
+// Licensed under the MIT License..
+//
+// preflight - dry-runs the relayer's evm.boid actions against a state snapshot
+//
+//   preflight --snapshot state.snap [--token <account>] [--decimals <n>] < pending.txt
+//
+// Reads `<action> <request id>` lines (reqnotify / verifytrx, the backlog format of cpupack) and
+// runs the checks evm.boid runs (include_common/request_preflight.hpp) against the snapshot
+// (`shipmirror live --snapshot`). The actions that go through are printed in the same format,
+// ready for `cpupack pack`, the rejected ones go to stderr with the reason.
+// --token is the native token contract v1 Requests are checked against (the snapshot's token
+// contract by default), --decimals the native token precision (4 by default).
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <keccak256/k.c>
+#include <bridge_storage.hpp>
+#include <request_preflight.hpp>
+
+#include "abi_stream.hpp"
+#include "relay_preflight.hpp"
+#include "state_snapshot.hpp"
+
+using namespace bridge_tools;
+
+namespace
+{
+  struct options {
+    std::string snapshot;
+    std::string token;
+    uint8_t decimals = 4;
+  };
+
+  [[noreturn]] void usage() {
+    std::fprintf(stderr, "usage: preflight --snapshot <file> [--token <account>] [--decimals <n>] < pending\n");
+    std::exit(1);
+  }
+
+  options parse_options(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) usage();
+        return argv[++i];
+      };
+      if (arg == "--snapshot") opts.snapshot = value();
+      else if (arg == "--token") opts.token = value();
+      else if (arg == "--decimals") opts.decimals = static_cast<uint8_t>(std::stoul(value()));
+      else usage();
+    }
+    if (opts.snapshot.empty()) usage();
+    return opts;
+  }
+
+  int run(const options& opts) {
+    snapshot_view view(opts.snapshot);
+    evm_bridge::request_preflight_config config;
+    config.layout = view.config().layout;
+    config.token_contract = opts.token.empty() ? name_to_string(view.config().token_contract) : opts.token;
+    config.native_precision = opts.decimals;
+    if (config.layout != evm_bridge::REQUEST_LAYOUT_V2 && view.config().token_contract == 0 && opts.token.empty()) {
+      throw abi_error("v1 Requests carry the token contract, pass --token (the snapshot has none)");
+    }
+
+    size_t passed = 0, rejected = 0;
+    std::chrono::nanoseconds checking{0};
+    std::string action;
+    uint64_t request_id;
+    while (std::cin >> action >> request_id) {
+      evm_bridge::preflight_request req;
+      auto start = std::chrono::steady_clock::now();
+      evm_bridge::preflight_status status = dry_run(view, string_to_name(action), request_id, config, req);
+      checking += std::chrono::steady_clock::now() - start;
+
+      if (status == evm_bridge::PREFLIGHT_OK) {
+        std::printf("%s %llu\n", action.c_str(), (unsigned long long)request_id);
+        ++passed;
+      } else {
+        std::fprintf(stderr, "%s %llu: %s\n", action.c_str(), (unsigned long long)request_id, evm_bridge::preflightMessage(status));
+        ++rejected;
+      }
+    }
+
+    const size_t total = passed + rejected;
+    std::fprintf(stderr, "%zu actions: %zu pass, %zu rejected (block %u), %.2fus per check\n", total, passed, rejected,
+      view.block_num(), total ? std::chrono::duration<double, std::micro>(checking).count() / total : 0.0);
+    return 0;
+  }
+}
+
+int main(int argc, char** argv) {
+  options opts = parse_options(argc, argv);
+  try {
+    return run(opts);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "preflight: %s\n", e.what());
+    return 1;
+  }
+}
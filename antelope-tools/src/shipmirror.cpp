@@ -0,0 +1,215 @@
+// Licensed under the MIT License..
+//
+// shipmirror - keeps an in-memory mirror of the bridge state from state history deltas
+//
+//   shipmirror live   --host 127.0.0.1 --port 8080 --start <block> --scope <n> [--capture file] [--query id]...
+//   shipmirror replay --scope <n> [--query id]... capture.bin [capture2.bin ...]
+//   shipmirror snapshot --scope <n> --out state.snap capture.bin [capture2.bin ...]
+//   shipmirror compact state.snap
+//
+// Common options: --evm <eosio.evm account> --contract <bridge contract> --dump
+//                 --bridge <0x TokenBridge.sol address> (resolves the scope when --scope is not given)
+//
+// `live --snapshot state.snap` starts from a state snapshot (see state_snapshot.hpp) instead of an
+// empty mirror, continues after its last block when --start is not given and appends every block
+// received to it, so readers mapping the file follow the chain. --compact-every <n> folds the
+// appended blocks into a new base every n blocks.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <keccak256/k.c>
+#include <bridge_storage.hpp>
+#include <eip55.hpp>
+
+#include "abi_stream.hpp"
+#include "bridge_mirror.hpp"
+#include "delta_capture.hpp"
+#include "ship_client.hpp"
+#include "state_snapshot.hpp"
+
+using namespace bridge_tools;
+
+namespace
+{
+  struct options {
+    std::string mode;
+    std::string host = "127.0.0.1";
+    std::string port = "8080";
+    uint32_t start_block = 0;
+    uint32_t end_block = 0xffffffff;
+    std::string capture;
+    std::string snapshot;
+    std::string out;
+    uint32_t compact_every = 0;
+    std::vector<std::string> inputs;
+    std::vector<uint64_t> queries;
+    bool dump = false;
+    mirror_config mirror;
+  };
+
+  [[noreturn]] void usage() {
+    std::fprintf(stderr,
+      "usage: shipmirror live --host <host> --port <port> --start <block> [--end <block>] [--capture <file>] [options]\n"
+      "       shipmirror live --snapshot <file> [--compact-every <blocks>] [...]\n"
+      "       shipmirror replay [options] <capture file>...\n"
+      "       shipmirror snapshot --out <file> [options] <capture file>...\n"
+      "       shipmirror compact <snapshot file>\n"
+      "options: --scope <evm account index> --bridge <0x address> --layout <1|2> --evm <account> --contract <account>\n"
+      "         --token <token contract> --fees <fee contract>\n"
+      "         --query <request id> --dump\n");
+    std::exit(1);
+  }
+
+  options parse_options(int argc, char** argv) {
+    if (argc < 2) usage();
+    options opts;
+    opts.mode = argv[1];
+    for (int i = 2; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) usage();
+        return argv[++i];
+      };
+      if (arg == "--host") opts.host = value();
+      else if (arg == "--port") opts.port = value();
+      else if (arg == "--start") opts.start_block = std::stoul(value());
+      else if (arg == "--end") opts.end_block = std::stoul(value());
+      else if (arg == "--capture") opts.capture = value();
+      else if (arg == "--snapshot") opts.snapshot = value();
+      else if (arg == "--out") opts.out = value();
+      else if (arg == "--compact-every") opts.compact_every = std::stoul(value());
+      else if (arg == "--scope") opts.mirror.bridge_scope = std::stoull(value());
+      else if (arg == "--bridge") {
+        std::string address = value();
+        evm_bridge::address_status status = evm_bridge::parseChecksummedAddress(address, opts.mirror.bridge_address);
+        if (status != evm_bridge::ADDRESS_OK) {
+          std::fprintf(stderr, "shipmirror: --bridge %s: %s\n", address.c_str(), evm_bridge::addressStatusMessage(status));
+          std::exit(1);
+        }
+      }
+      else if (arg == "--layout") {
+        unsigned long layout = std::stoul(value());
+        if (layout != evm_bridge::REQUEST_LAYOUT_V1 && layout != evm_bridge::REQUEST_LAYOUT_V2) usage();
+        opts.mirror.layout = static_cast<evm_bridge::request_layout>(layout);
+      }
+      else if (arg == "--evm") opts.mirror.evm_contract = string_to_name(value());
+      else if (arg == "--contract") opts.mirror.bridge_contract = string_to_name(value());
+      else if (arg == "--token") opts.mirror.token_contract = string_to_name(value());
+      else if (arg == "--fees") opts.mirror.fees_contract = string_to_name(value());
+      else if (arg == "--query") opts.queries.push_back(std::stoull(value()));
+      else if (arg == "--dump") opts.dump = true;
+      else if (arg.rfind("--", 0) == 0) usage();
+      else opts.inputs.push_back(arg);
+    }
+    if (opts.mode == "replay" || opts.mode == "snapshot") {
+      if (opts.inputs.empty()) usage();
+      if (opts.mode == "snapshot" && opts.out.empty()) usage();
+    } else if (opts.mode == "compact") {
+      if (opts.inputs.size() != 1) usage();
+    } else if (opts.mode != "live" || !opts.inputs.empty()) {
+      usage();
+    }
+    return opts;
+  }
+
+  void report(const bridge_mirror& mirror, const options& opts) {
+    std::printf("bridge scope: %llu, storage slots: %zu, evm accounts: %zu, native requests: %zu, rows applied: %llu\n",
+      (unsigned long long)mirror.bridge_scope(), mirror.storage_size(), mirror.account_count(),
+      mirror.requests().size(), (unsigned long long)mirror.rows_applied());
+
+    for (uint64_t id : opts.queries) {
+      std::printf("request %llu: %s\n", (unsigned long long)id, to_string(mirror.state_of(id)));
+    }
+    if (opts.dump) {
+      for (const auto& [id, row] : mirror.requests()) {
+        std::printf("request %llu: %s amount=%llu receiver=%s sender=%s\n", (unsigned long long)id,
+          to_string(mirror.state_of(id)), (unsigned long long)row.amount,
+          name_to_string(row.receiver).c_str(), row.sender.c_str());
+      }
+    }
+  }
+
+  // Replays capture files, returns the last block seen
+  uint32_t replay(bridge_mirror& mirror, const std::vector<std::string>& inputs) {
+    uint32_t last_block = 0;
+    for (const auto& path : inputs) {
+      delta_capture_reader reader(path);
+      uint32_t block_num;
+      byte_view deltas;
+      while (reader.next(block_num, deltas)) {
+        mirror.apply_deltas(deltas.data, deltas.size);
+        last_block = std::max(last_block, block_num);
+      }
+    }
+    return last_block;
+  }
+}
+
+int main(int argc, char** argv) {
+  options opts = parse_options(argc, argv);
+  bridge_mirror mirror(opts.mirror);
+
+  try {
+    if (opts.mode == "compact") {
+      compact_snapshot(opts.inputs[0]);
+      snapshot_view view(opts.inputs[0]);
+      std::printf("snapshot %s: block %u, %llu bytes\n", opts.inputs[0].c_str(), view.block_num(),
+        (unsigned long long)view.base_size());
+      return 0;
+    }
+    if (opts.mode == "replay") {
+      replay(mirror, opts.inputs);
+    } else if (opts.mode == "snapshot") {
+      uint32_t last_block = replay(mirror, opts.inputs);
+      write_snapshot(opts.out, mirror, last_block);
+      std::printf("snapshot %s written at block %u\n", opts.out.c_str(), last_block);
+    } else {
+      std::unique_ptr<delta_capture_writer> capture;
+      if (!opts.capture.empty()) capture = std::make_unique<delta_capture_writer>(opts.capture);
+
+      ship_request request;
+      request.start_block = opts.start_block;
+      request.end_block = opts.end_block;
+
+      std::unique_ptr<snapshot_appender> appender;
+      uint32_t compacted_at = 0;
+      if (!opts.snapshot.empty()) {
+        snapshot_view view(opts.snapshot);
+        mirror = view.to_mirror();
+        if (request.start_block == 0) request.start_block = view.block_num() + 1;
+        compacted_at = view.block_num();
+        appender = std::make_unique<snapshot_appender>(opts.snapshot, mirror.config());
+      }
+
+      ship_client client(opts.host, opts.port);
+      client.run(request, [&](uint32_t block_num, byte_view deltas, byte_view) {
+        if (capture) capture->write(block_num, deltas);
+        if (deltas.size) mirror.apply_deltas(deltas.data, deltas.size);
+        if (appender) {
+          appender->append(block_num, deltas);
+          if (opts.compact_every && block_num - compacted_at >= opts.compact_every) {
+            // The mirror already holds base + log, written as the new base
+            appender.reset();
+            write_snapshot(opts.snapshot, mirror, block_num);
+            appender = std::make_unique<snapshot_appender>(opts.snapshot, mirror.config());
+            compacted_at = block_num;
+          }
+        }
+        if (block_num % 1000 == 0) report(mirror, opts);
+        return true;
+      });
+    }
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "shipmirror: %s\n", e.what());
+    return 1;
+  }
+
+  report(mirror, opts);
+  return 0;
+}
@@ -0,0 +1,291 @@
+// Licensed under the MIT License..
+//
+// tracereplay - records production traffic of the bridge contracts and checks a candidate build against it
+//
+//   tracereplay capture --host 127.0.0.1 --port 8080 --start <block> [--end <block>] [--watch <account>]... capture.bin
+//   tracereplay plan [--watch <account>]... capture.bin > plan.tsv
+//   tracereplay compare [--limit n] [--max-regression pct] plan.tsv [base.tsv] candidate.tsv
+//
+// capture keeps every transaction with an action received by a watched account (evm.boid and
+// xsend.boid by default) and the watched contracts' rows it changed. plan turns it into the list of
+// transactions to push again, in order, with what production recorded for them. The transactions
+// are replayed on a local chain by antelope-compile/replayTraces.sh, compare then prints the cost
+// per action against production (or against the results of another build) and the transactions
+// whose outcome changed. Exits with 2 on a divergence and 3 on a cost regression above --max-regression.
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <hex_codec.hpp>
+
+#include "abi_stream.hpp"
+#include "ship_client.hpp"
+#include "trace_capture.hpp"
+
+using namespace bridge_tools;
+
+namespace
+{
+  struct options {
+    std::string mode;
+    std::string host = "127.0.0.1";
+    std::string port = "8080";
+    uint32_t start_block = 0;
+    uint32_t end_block = 0xffffffff;
+    std::unordered_set<uint64_t> watched;
+    std::vector<std::string> inputs;
+    size_t limit = 50;
+    double max_regression = -1; // percent, < 0 = not checked
+  };
+
+  [[noreturn]] void usage() {
+    std::fprintf(stderr,
+      "usage: tracereplay capture --host <host> --port <port> --start <block> [--end <block>] [--watch <account>]... <capture file>\n"
+      "       tracereplay plan [--watch <account>]... <capture file>\n"
+      "       tracereplay compare [--limit <n>] [--max-regression <percent>] <plan> [<base results>] <candidate results>\n");
+    std::exit(1);
+  }
+
+  options parse_options(int argc, char** argv) {
+    if (argc < 2) usage();
+    options opts;
+    opts.mode = argv[1];
+    for (int i = 2; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) usage();
+        return argv[++i];
+      };
+      if (arg == "--host") opts.host = value();
+      else if (arg == "--port") opts.port = value();
+      else if (arg == "--start") opts.start_block = std::stoul(value());
+      else if (arg == "--end") opts.end_block = std::stoul(value());
+      else if (arg == "--watch") opts.watched.insert(string_to_name(value()));
+      else if (arg == "--limit") opts.limit = std::stoull(value());
+      else if (arg == "--max-regression") opts.max_regression = std::stod(value());
+      else if (arg.rfind("--", 0) == 0) usage();
+      else opts.inputs.push_back(arg);
+    }
+    if (opts.watched.empty()) opts.watched = {string_to_name("evm.boid"), string_to_name("xsend.boid")};
+
+    if (opts.mode == "capture" || opts.mode == "plan") {
+      if (opts.inputs.size() != 1) usage();
+    } else if (opts.mode == "compare") {
+      if (opts.inputs.size() != 2 && opts.inputs.size() != 3) usage();
+    } else {
+      usage();
+    }
+    return opts;
+  }
+
+  //======================== capture ========================
+  int capture(const options& opts) {
+    trace_parser parser(opts.watched);
+    std::unordered_set<uint64_t> codes = opts.watched;
+    codes.insert(string_to_name("eosio.evm"));
+
+    trace_capture_writer out(opts.inputs[0]);
+    ship_request request;
+    request.start_block = opts.start_block;
+    request.end_block = opts.end_block;
+    request.fetch_traces = true;
+
+    uint64_t transactions = 0;
+    ship_client client(opts.host, opts.port);
+    client.run(request, [&](uint32_t block_num, byte_view deltas, byte_view traces) {
+      if (traces.size) {
+        for (const auto& trx : parser.parse(traces)) {
+          out.write(block_num, trx);
+          ++transactions;
+        }
+      }
+      if (deltas.size) out.write_deltas(block_num, filter_contract_rows(deltas, codes));
+      if (block_num % 1000 == 0) std::printf("block %u, transactions captured: %llu\n", block_num, (unsigned long long)transactions);
+      return true;
+    });
+    std::printf("transactions captured: %llu\n", (unsigned long long)transactions);
+    return 0;
+  }
+
+  //======================== plan ========================
+  // What a replayed transaction is compared on: the watched action traces in ordinal order
+  // with their return value, a failed action is marked with `!`
+  std::string fingerprint(const captured_transaction& trx, const trace_parser& parser) {
+    std::string out;
+    for (const auto& act : trx.actions) {
+      if (!parser.watched(act.receiver)) continue;
+      if (!out.empty()) out += ";";
+      out += name_to_string(act.receiver) + "/" + name_to_string(act.account) + "/" + name_to_string(act.name) + "/" +
+             evm_bridge::toHex(act.return_value.data(), act.return_value.size());
+      if (act.failed) out += "!";
+    }
+    return out.empty() ? "-" : out;
+  }
+
+  // Root action and, for a notification, the watched contract that got it (eosio.token::transfer>evm.boid)
+  std::string group_of(const captured_transaction& trx, const trace_parser& parser) {
+    const captured_action* root = nullptr;
+    for (const auto& act : trx.actions) {
+      if (act.creator_action_ordinal == 0 && !root) root = &act;
+      if (root && parser.watched(act.receiver)) {
+        std::string group = name_to_string(root->account) + "::" + name_to_string(root->name);
+        return act.receiver == root->account ? group : group + ">" + name_to_string(act.receiver);
+      }
+    }
+    return root ? name_to_string(root->account) + "::" + name_to_string(root->name) : "-";
+  }
+
+  // The root actions as the `actions` array of a transaction for cleos push transaction
+  std::string actions_json(const captured_transaction& trx) {
+    std::string out = "[";
+    for (const auto& act : trx.actions) {
+      if (act.creator_action_ordinal != 0 || act.receiver != act.account) continue;
+      if (out.size() > 1) out += ",";
+      out += "{\"account\":\"" + name_to_string(act.account) + "\",\"name\":\"" + name_to_string(act.name) + "\",\"authorization\":[";
+      for (size_t i = 0; i < act.authorization.size(); ++i) {
+        if (i) out += ",";
+        out += "{\"actor\":\"" + name_to_string(act.authorization[i].first) + "\",\"permission\":\"" +
+               name_to_string(act.authorization[i].second) + "\"}";
+      }
+      out += "],\"data\":\"" + evm_bridge::toHex(act.data.data(), act.data.size()) + "\"}";
+    }
+    return out + "]";
+  }
+
+  // plan.tsv: seq  block  trx_id  group  actions  status  cpu_us  elapsed_us  fingerprint
+  int plan(const options& opts) {
+    trace_parser parser(opts.watched);
+    trace_capture_reader reader(opts.inputs[0]);
+    uint32_t block_num;
+    uint8_t kind;
+    byte_view payload;
+    uint64_t seq = 0;
+    while (reader.next(block_num, kind, payload)) {
+      if (kind != TRACE_RECORD_TRANSACTION) continue;
+      captured_transaction trx = trace_capture_reader::read_transaction(payload);
+      std::printf("%llu\t%u\t%s\t%s\t%s\t%s\t%u\t%lld\t%s\n", (unsigned long long)seq++, block_num,
+        evm_bridge::toHex(trx.id).c_str(), group_of(trx, parser).c_str(), actions_json(trx).c_str(),
+        trx.executed() ? "executed" : "failed", trx.cpu_usage_us, (long long)trx.elapsed_us,
+        fingerprint(trx, parser).c_str());
+    }
+    return 0;
+  }
+
+  //======================== compare ========================
+  struct result {
+    std::string status;
+    uint64_t cpu_us = 0;
+    int64_t elapsed_us = 0;
+    std::string fingerprint;
+  };
+
+  std::vector<std::string> split_tabs(const std::string& line) {
+    std::vector<std::string> fields;
+    std::stringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, '\t')) fields.push_back(field);
+    return fields;
+  }
+
+  // Plan lines (9 columns) keep production's result, replay results are: seq  status  cpu_us  elapsed_us  fingerprint
+  void load_results(const std::string& path, std::unordered_map<uint64_t, result>& results,
+                    std::unordered_map<uint64_t, std::string>* groups) {
+    std::ifstream in(path);
+    if (!in) throw abi_error("cannot open " + path);
+    std::string line;
+    while (std::getline(in, line)) {
+      auto f = split_tabs(line);
+      if (f.size() == 9) {
+        uint64_t seq = std::stoull(f[0]);
+        if (groups) (*groups)[seq] = f[3];
+        results[seq] = {f[5], std::stoull(f[6]), std::stoll(f[7]), f[8]};
+      } else if (f.size() == 5) {
+        results[std::stoull(f[0])] = {f[1], std::stoull(f[2]), std::stoll(f[3]), f[4]};
+      } else if (!line.empty()) {
+        throw abi_error(path + ": malformed line: " + line);
+      }
+    }
+  }
+
+  int compare(const options& opts) {
+    std::unordered_map<uint64_t, std::string> groups;
+    std::unordered_map<uint64_t, result> base, candidate;
+    load_results(opts.inputs[0], base, &groups);
+    if (opts.inputs.size() == 3) {
+      base.clear();
+      load_results(opts.inputs[1], base, nullptr);
+    }
+    load_results(opts.inputs.back(), candidate, nullptr);
+
+    struct cost {
+      uint64_t count = 0;
+      uint64_t base_cpu = 0, cand_cpu = 0;
+      int64_t base_elapsed = 0, cand_elapsed = 0;
+    };
+    std::map<std::string, cost> costs;
+    std::map<uint64_t, std::string> divergences;
+    uint64_t missing = 0;
+
+    for (const auto& [seq, group] : groups) {
+      auto b = base.find(seq);
+      auto c = candidate.find(seq);
+      if (b == base.end() || c == candidate.end()) {
+        ++missing;
+        continue;
+      }
+      if (b->second.status != c->second.status) {
+        divergences[seq] = group + " status " + b->second.status + " -> " + c->second.status;
+      } else if (b->second.fingerprint != c->second.fingerprint) {
+        divergences[seq] = group + " result " + b->second.fingerprint + " -> " + c->second.fingerprint;
+      }
+      // Costs of transactions that failed on either side are not comparable
+      if (b->second.status != "executed" || c->second.status != "executed") continue;
+      cost& k = costs[group];
+      k.count++;
+      k.base_cpu += b->second.cpu_us;
+      k.cand_cpu += c->second.cpu_us;
+      k.base_elapsed += b->second.elapsed_us;
+      k.cand_elapsed += c->second.elapsed_us;
+    }
+
+    bool regression = false;
+    std::printf("%-40s %8s %12s %12s %9s %12s %12s\n", "action", "count", "base cpu", "cand cpu", "delta", "base us", "cand us");
+    for (const auto& [group, k] : costs) {
+      double base_cpu = double(k.base_cpu) / k.count;
+      double cand_cpu = double(k.cand_cpu) / k.count;
+      double delta = base_cpu > 0 ? (cand_cpu - base_cpu) * 100.0 / base_cpu : 0;
+      if (opts.max_regression >= 0 && delta > opts.max_regression) regression = true;
+      std::printf("%-40s %8llu %12.1f %12.1f %+8.1f%% %12.1f %12.1f\n", group.c_str(), (unsigned long long)k.count,
+        base_cpu, cand_cpu, delta, double(k.base_elapsed) / k.count, double(k.cand_elapsed) / k.count);
+    }
+
+    size_t printed = 0;
+    for (const auto& [seq, what] : divergences) {
+      if (opts.limit && printed++ >= opts.limit) break;
+      std::printf("diverged %llu: %s\n", (unsigned long long)seq, what.c_str());
+    }
+    std::printf("transactions: %zu, diverged: %zu, missing results: %llu\n", groups.size(), divergences.size(),
+      (unsigned long long)missing);
+    if (!divergences.empty()) return 2;
+    return regression ? 3 : 0;
+  }
+}
+
+int main(int argc, char** argv) {
+  options opts = parse_options(argc, argv);
+  try {
+    if (opts.mode == "capture") return capture(opts);
+    if (opts.mode == "plan") return plan(opts);
+    return compare(opts);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "tracereplay: %s\n", e.what());
+    return 1;
+  }
+}
@@ -0,0 +1,92 @@
+// Licensed under the MIT License..
+//
+// u256bench - the uint256 kernels of include_common/u256_kernels.hpp against intx on this machine
+//
+//   u256bench [--iterations n] [--repeat n] [case...]
+//
+// Checks every kernel against the intx operators on edge values first (exits with 2 on a
+// mismatch), then times the generic and the kernel loop of each case (all by default) and
+// prints ns per operation and the speedup. The wasm numbers come from
+// antelope-compile/benchU256.sh, which runs the same cases in a contract.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <u256_bench.hpp>
+
+using namespace evm_bridge;
+
+namespace
+{
+  struct options {
+    uint32_t iterations = 10000000;
+    uint32_t repeat = 5;
+    std::vector<std::string> cases;
+  };
+
+  [[noreturn]] void usage() {
+    std::fprintf(stderr, "usage: u256bench [--iterations <n>] [--repeat <n>] [case...]\ncases:");
+    for (const auto& c : U256_BENCH_CASES) std::fprintf(stderr, " %s", c.name);
+    std::fprintf(stderr, "\n");
+    std::exit(1);
+  }
+
+  options parse_options(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) usage();
+        return argv[++i];
+      };
+      if (arg == "--iterations") opts.iterations = std::stoul(value());
+      else if (arg == "--repeat") opts.repeat = std::stoul(value());
+      else if (arg.rfind("--", 0) == 0 || !findU256BenchCase(arg)) usage();
+      else opts.cases.push_back(arg);
+    }
+    if (opts.iterations == 0 || opts.repeat == 0) usage();
+    if (opts.cases.empty()) {
+      for (const auto& c : U256_BENCH_CASES) opts.cases.push_back(c.name);
+    }
+    return opts;
+  }
+
+  // Best of `repeat` runs in ns per operation, the checksum of the last run
+  double time_loop(u256_bench_loop loop, const options& opts, const u256_bench_inputs& inputs, uint64_t& checksum) {
+    double best = 0;
+    for (uint32_t r = 0; r < opts.repeat; ++r) {
+      auto start = std::chrono::steady_clock::now();
+      checksum = loop(opts.iterations, inputs);
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / opts.iterations;
+      if (r == 0 || ns < best) best = ns;
+    }
+    return best;
+  }
+}
+
+int main(int argc, char** argv) {
+  options opts = parse_options(argc, argv);
+
+  uint32_t failures = verifyU256Kernels([](const char* kernel, const uint256_t& x, uint64_t operand) {
+    std::fprintf(stderr, "mismatch: %s(0x%s, %llu)\n", kernel, intx::hex(x).c_str(), (unsigned long long)operand);
+  });
+  if (failures) {
+    std::fprintf(stderr, "%u kernel results differ from intx\n", failures);
+    return 2;
+  }
+
+  const u256_bench_inputs inputs;
+  std::printf("%-12s %12s %12s %9s\n", "case", "intx ns/op", "kernel ns/op", "speedup");
+  for (const auto& name : opts.cases) {
+    const u256_bench_case* c = findU256BenchCase(name);
+    uint64_t generic_sum = 0, fast_sum = 0;
+    double generic = time_loop(c->generic, opts, inputs, generic_sum);
+    double fast = time_loop(c->fast, opts, inputs, fast_sum);
+    std::printf("%-12s %12.2f %12.2f %8.1fx%s\n", c->name, generic, fast, fast > 0 ? generic / fast : 0,
+      generic_sum == fast_sum ? "" : "  checksum differs");
+  }
+  return 0;
+}
@@ -0,0 +1,224 @@
+// Licensed under the MIT License..
+//
+// wasmsize - size report for contract wasm files
+//
+//   wasmsize [--top N] contract.wasm               sections, instantiation inputs and functions by size
+//   wasmsize --compare before.wasm after.wasm      section by section delta between two builds
+//
+// Function names come from the `name` custom section when present, otherwise from the exports.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "abi_stream.hpp"
+
+using namespace bridge_tools;
+
+namespace
+{
+  struct function_size {
+    uint32_t index;
+    uint32_t bytes;
+  };
+
+  struct wasm_report {
+    std::string path;
+    size_t file_bytes = 0;
+    std::vector<std::pair<std::string, uint32_t>> sections;
+    uint32_t imported_functions = 0;
+    uint32_t memory_pages = 0;
+    uint32_t data_segments = 0;
+    uint64_t data_bytes = 0;
+    uint64_t code_bytes = 0;
+    std::vector<function_size> functions;
+    std::map<uint32_t, std::string> names;
+  };
+
+  const char* section_name(uint8_t id) {
+    static const char* names[] = {"custom", "type", "import", "function", "table", "memory", "global",
+                                  "export", "start", "element", "code", "data", "datacount"};
+    return id < sizeof(names) / sizeof(names[0]) ? names[id] : "unknown";
+  }
+
+  std::string read_name(abi_reader& ds) { return ds.read_string(); }
+
+  void skip_limits(abi_reader& ds, uint32_t* initial = nullptr) {
+    uint8_t flags = ds.read_raw<uint8_t>();
+    uint32_t min = ds.read_varuint32();
+    if (initial) *initial = min;
+    if (flags & 1) ds.read_varuint32();
+  }
+
+  void parse_imports(abi_reader ds, wasm_report& r) {
+    uint32_t count = ds.read_varuint32();
+    for (uint32_t i = 0; i < count; ++i) {
+      read_name(ds);
+      std::string field = read_name(ds);
+      uint8_t kind = ds.read_raw<uint8_t>();
+      switch (kind) {
+        case 0: ds.read_varuint32(); r.names[r.imported_functions++] = "import:" + field; break;
+        case 1: ds.skip(1); skip_limits(ds); break;
+        case 2: skip_limits(ds, &r.memory_pages); break;
+        case 3: ds.skip(2); break;
+        default: throw abi_error("unknown import kind");
+      }
+    }
+  }
+
+  void parse_exports(abi_reader ds, wasm_report& r) {
+    uint32_t count = ds.read_varuint32();
+    for (uint32_t i = 0; i < count; ++i) {
+      std::string field = read_name(ds);
+      uint8_t kind = ds.read_raw<uint8_t>();
+      uint32_t index = ds.read_varuint32();
+      if (kind == 0 && !r.names.count(index)) r.names[index] = field;
+    }
+  }
+
+  void parse_code(abi_reader ds, wasm_report& r) {
+    uint32_t count = ds.read_varuint32();
+    for (uint32_t i = 0; i < count; ++i) {
+      uint32_t size = ds.read_varuint32();
+      ds.skip(size);
+      r.functions.push_back({r.imported_functions + i, size});
+      r.code_bytes += size;
+    }
+  }
+
+  void parse_data(abi_reader ds, wasm_report& r) {
+    r.data_segments = ds.read_varuint32();
+    for (uint32_t i = 0; i < r.data_segments; ++i) {
+      uint32_t flags = ds.read_varuint32();
+      if (flags == 2) ds.read_varuint32();
+      if (flags != 1) {
+        // constant init expression, ends with `end` (0x0b)
+        while (ds.read_raw<uint8_t>() != 0x0b) {}
+      }
+      r.data_bytes += ds.read_bytes().size;
+    }
+  }
+
+  void parse_names(abi_reader ds, wasm_report& r) {
+    while (ds.remaining()) {
+      uint8_t id = ds.read_raw<uint8_t>();
+      abi_reader sub(ds.read_bytes());
+      if (id != 1) continue;
+      uint32_t count = sub.read_varuint32();
+      for (uint32_t i = 0; i < count; ++i) {
+        uint32_t index = sub.read_varuint32();
+        r.names[index] = read_name(sub);
+      }
+    }
+  }
+
+  wasm_report analyze(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw abi_error("cannot open " + path);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    wasm_report r;
+    r.path = path;
+    r.file_bytes = bytes.size();
+    abi_reader ds(bytes.data(), bytes.size());
+    if (ds.read_raw<uint32_t>() != 0x6d736100) throw abi_error(path + " is not a wasm file");
+    ds.skip(4); // version
+
+    while (ds.remaining()) {
+      uint8_t id = ds.read_raw<uint8_t>();
+      byte_view payload = ds.read_bytes();
+      abi_reader section(payload);
+      std::string name = section_name(id);
+      if (id == 0) {
+        std::string custom = read_name(section);
+        if (custom == "name") parse_names(section, r);
+        name += ":" + custom;
+      }
+      else if (id == 2) parse_imports(section, r);
+      else if (id == 5) { section.read_varuint32(); skip_limits(section, &r.memory_pages); }
+      else if (id == 7) parse_exports(section, r);
+      else if (id == 10) parse_code(section, r);
+      else if (id == 11) parse_data(section, r);
+      r.sections.emplace_back(name, static_cast<uint32_t>(payload.size));
+    }
+    std::sort(r.functions.begin(), r.functions.end(),
+              [](const function_size& a, const function_size& b) { return a.bytes > b.bytes; });
+    return r;
+  }
+
+  void print_report(const wasm_report& r, size_t top) {
+    std::printf("%s: %zu bytes\n\nsections:\n", r.path.c_str(), r.file_bytes);
+    for (const auto& [name, bytes] : r.sections) std::printf("  %-20s %8u\n", name.c_str(), bytes);
+
+    // What the VM has to validate / compile / copy when the contract is instantiated
+    std::printf("\ninstantiation inputs:\n");
+    std::printf("  functions            %8zu defined, %u imported\n", r.functions.size(), r.imported_functions);
+    std::printf("  code bytes           %8llu\n", (unsigned long long)r.code_bytes);
+    std::printf("  data bytes           %8llu in %u segments\n", (unsigned long long)r.data_bytes, r.data_segments);
+    std::printf("  initial memory       %8u pages (%u KiB)\n", r.memory_pages, r.memory_pages * 64);
+
+    std::printf("\nfunctions by size:\n  %8s %6s %6s  %s\n", "bytes", "%code", "index", "name");
+    for (size_t i = 0; i < r.functions.size() && i < top; ++i) {
+      const auto& f = r.functions[i];
+      auto name = r.names.find(f.index);
+      std::printf("  %8u %5.1f%% %6u  %s\n", f.bytes, r.code_bytes ? 100.0 * f.bytes / r.code_bytes : 0.0,
+                  f.index, name == r.names.end() ? "" : name->second.c_str());
+    }
+  }
+
+  void print_compare(const wasm_report& a, const wasm_report& b) {
+    auto bytes_of = [](const wasm_report& r, const std::string& name) -> long long {
+      for (const auto& s : r.sections) if (s.first == name) return s.second;
+      return 0;
+    };
+    std::vector<std::string> names;
+    for (const auto& r : {a, b}) {
+      for (const auto& s : r.sections) {
+        if (std::find(names.begin(), names.end(), s.first) == names.end()) names.push_back(s.first);
+      }
+    }
+    std::printf("%-20s %10s %10s %10s\n", "", "before", "after", "delta");
+    auto row = [](const char* label, long long x, long long y) {
+      std::printf("%-20s %10lld %10lld %+10lld\n", label, x, y, y - x);
+    };
+    row("file", a.file_bytes, b.file_bytes);
+    for (const auto& name : names) row(name.c_str(), bytes_of(a, name), bytes_of(b, name));
+    row("functions", a.functions.size(), b.functions.size());
+    row("code bytes", a.code_bytes, b.code_bytes);
+    row("data bytes", a.data_bytes, b.data_bytes);
+    row("memory pages", a.memory_pages, b.memory_pages);
+  }
+}
+
+int main(int argc, char** argv) {
+  size_t top = 40;
+  std::vector<std::string> files;
+  bool compare = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--top" && i + 1 < argc) top = std::stoul(argv[++i]);
+    else if (arg == "--compare") compare = true;
+    else files.push_back(arg);
+  }
+  if (files.empty() || (compare && files.size() != 2)) {
+    std::fprintf(stderr, "usage: wasmsize [--top N] file.wasm...\n       wasmsize --compare before.wasm after.wasm\n");
+    return 1;
+  }
+
+  try {
+    if (compare) {
+      print_compare(analyze(files[0]), analyze(files[1]));
+    } else {
+      for (const auto& file : files) print_report(analyze(file), top);
+    }
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "wasmsize: %s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
@@ -77,12 +77,16 @@ export async function reqnotify(chain: "mainnet" | "testnet", req_id: number) {
 // reqnotify("testnet", 7);
 // reqnotify("testnet", 5);
 
-// function to refund stuck requests
-export async function refundStuckReq(chain: "mainnet" | "testnet") {
+// start value of refstuckreq / clrfailedreq that continues from the cursor TokenBridge.sol keeps (RECOVERY_CURSOR)
+export const RECOVERY_CURSOR = UInt64.from("18446744073709551615");
+
+// function to refund stuck requests, looks at count (at most 50) active requests from start
+export async function refundStuckReq(chain: "mainnet" | "testnet", start: UInt64 | number = RECOVERY_CURSOR, count: number = 50) {
     try {
         const acc = "evm.boid";
         const dataObject: EvmBridgeActionParams.refstuckreq = {
-            // req_index: req_index
+            start: start,
+            count: count
         };
         createAndSendAction(
             chain,
@@ -99,4 +103,29 @@ export async function refundStuckReq(chain: "mainnet" | "testnet") {
     }
 }
 
-// refundStuckReq("testnet");
\ No newline at end of file
+// refundStuckReq("testnet");
+
+// function to clear failed requests, looks at count (at most 50) active requests from start
+export async function clearFailedRequests(chain: "mainnet" | "testnet", start: UInt64 | number = RECOVERY_CURSOR, count: number = 50) {
+    try {
+        const acc = "evm.boid";
+        const dataObject: EvmBridgeActionParams.clrfailedreq = {
+            start: start,
+            count: count
+        };
+        createAndSendAction(
+            chain,
+            acc,
+            "clrfailedreq",
+            acc,
+            "active",
+            dataObject,
+            key
+        )
+    } catch (error) {
+        const err = error as Error;
+        console.error("Error during permission update flow:", toObject(err), err.stack);
+    }
+}
+
+// clearFailedRequests("testnet");
\ No newline at end of file
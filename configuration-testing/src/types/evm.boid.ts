@@ -1,4 +1,4 @@
-import type {Action, Checksum160Type, NameType, UInt64Type, UInt8Type} from '@wharfkit/antelope'
+import type {Action, Checksum160Type, NameType, UInt32Type, UInt64Type, UInt8Type} from '@wharfkit/antelope'
 import {
     ABI,
     Asset,
@@ -7,13 +7,14 @@ import {
     Name,
     Struct,
     TimePoint,
+    UInt32,
     UInt64,
     UInt8,
 } from '@wharfkit/antelope'
 import type {ActionOptions, ContractArgs, PartialBy, Table} from '@wharfkit/contract'
 import {Contract as BaseContract} from '@wharfkit/contract'
 export const abiBlob = Blob.from(
-    'DmVvc2lvOjphYmkvMS4yAAkMYnJpZGdlY29uZmlnAAgSZXZtX2JyaWRnZV9hZGRyZXNzC2NoZWNrc3VtMTYwEGV2bV9icmlkZ2Vfc2NvcGUGdWludDY0EWV2bV90b2tlbl9hZGRyZXNzC2NoZWNrc3VtMTYwDGV2bV9jaGFpbl9pZAV1aW50OBNuYXRpdmVfdG9rZW5fc3ltYm9sBnN5bWJvbBVuYXRpdmVfdG9rZW5fY29udHJhY3QEbmFtZQ1mZWVzX2NvbnRyYWN0BG5hbWUJaXNfbG9ja2VkBGJvb2wMY2xyZmFpbGVkcmVxAAAEaW5pdAAHEmV2bV9icmlkZ2VfYWRkcmVzcwtjaGVja3N1bTE2MBFldm1fdG9rZW5fYWRkcmVzcwtjaGVja3N1bTE2MAxldm1fY2hhaW5faWQFdWludDgTbmF0aXZlX3Rva2VuX3N5bWJvbAZzeW1ib2wVbmF0aXZlX3Rva2VuX2NvbnRyYWN0BG5hbWUNZmVlc19jb250cmFjdARuYW1lCWlzX2xvY2tlZARib29sC3JlZnN0dWNrcmVxAAAJcmVxbm90aWZ5AAEGcmVxX2lkBnVpbnQ2NAhyZXF1ZXN0cwAHCnJlcXVlc3RfaWQGdWludDY0CXRpbWVzdGFtcAp0aW1lX3BvaW50CXByb2Nlc3NlZARib29sBmFtb3VudAZ1aW50NjQIcmVjZWl2ZXIEbmFtZQZzZW5kZXIGc3RyaW5nBG1lbW8Gc3RyaW5nBXJtcmVxAAEGcmVxX2lkBnVpbnQ2NApybXJlcW9uZXZtAAEGcmVxX2lkBnVpbnQ2NAl2ZXJpZnl0cngAAQZyZXFfaWQGdWludDY0B2DVTSo6s25EDGNscmZhaWxlZHJlcQAAAAAAAJDddARpbml0AACsuhDpjJe6C3JlZnN0dWNrcmVxAAAA8MtlOq26CXJlcW5vdGlmeQAAAAAAAKuuvAVybXJlcQAAgNxqUquuvApybXJlcW9uZXZtAAAA6Df75a7aCXZlcmlmeXRyeAACwNyaFCmW3D0DaTY0AAAMYnJpZGdlY29uZmlnAAAAOGOlrboDaTY0AAAIcmVxdWVzdHMAAAAAAA=='
+    'DmVvc2lvOjphYmkvMS4yAAkMYnJpZGdlY29uZmlnAAgSZXZtX2JyaWRnZV9hZGRyZXNzC2NoZWNrc3VtMTYwEGV2bV9icmlkZ2Vfc2NvcGUGdWludDY0EWV2bV90b2tlbl9hZGRyZXNzC2NoZWNrc3VtMTYwDGV2bV9jaGFpbl9pZAV1aW50OBNuYXRpdmVfdG9rZW5fc3ltYm9sBnN5bWJvbBVuYXRpdmVfdG9rZW5fY29udHJhY3QEbmFtZQ1mZWVzX2NvbnRyYWN0BG5hbWUJaXNfbG9ja2VkBGJvb2wMY2xyZmFpbGVkcmVxAAIFc3RhcnQGdWludDY0BWNvdW50BnVpbnQzMgRpbml0AAcSZXZtX2JyaWRnZV9hZGRyZXNzC2NoZWNrc3VtMTYwEWV2bV90b2tlbl9hZGRyZXNzC2NoZWNrc3VtMTYwDGV2bV9jaGFpbl9pZAV1aW50OBNuYXRpdmVfdG9rZW5fc3ltYm9sBnN5bWJvbBVuYXRpdmVfdG9rZW5fY29udHJhY3QEbmFtZQ1mZWVzX2NvbnRyYWN0BG5hbWUJaXNfbG9ja2VkBGJvb2wLcmVmc3R1Y2tyZXEAAgVzdGFydAZ1aW50NjQFY291bnQGdWludDMyCXJlcW5vdGlmeQABBnJlcV9pZAZ1aW50NjQIcmVxdWVzdHMABwpyZXF1ZXN0X2lkBnVpbnQ2NAl0aW1lc3RhbXAKdGltZV9wb2ludAlwcm9jZXNzZWQEYm9vbAZhbW91bnQGdWludDY0CHJlY2VpdmVyBG5hbWUGc2VuZGVyBnN0cmluZwRtZW1vBnN0cmluZwVybXJlcQABBnJlcV9pZAZ1aW50NjQKcm1yZXFvbmV2bQABBnJlcV9pZAZ1aW50NjQJdmVyaWZ5dHJ4AAEGcmVxX2lkBnVpbnQ2NAdg1U0qOrNuRAxjbHJmYWlsZWRyZXEAAAAAAACQ3XQEaW5pdAAArLoQ6YyXugtyZWZzdHVja3JlcQAAAPDLZTqtuglyZXFub3RpZnkAAAAAAACrrrwFcm1yZXEAAIDcalKrrrwKcm1yZXFvbmV2bQAAAOg3++Wu2gl2ZXJpZnl0cngAAsDcmhQpltw9A2k2NAAADGJyaWRnZWNvbmZpZwAAADhjpa26A2k2NAAACHJlcXVlc3RzAAAAAAA='
 )
 export const abi = ABI.from(abiBlob)
 export namespace Types {
@@ -37,7 +38,12 @@ export namespace Types {
         declare is_locked: boolean
     }
     @Struct.type('clrfailedreq')
-    export class clrfailedreq extends Struct {}
+    export class clrfailedreq extends Struct {
+        @Struct.field(UInt64)
+        declare start: UInt64
+        @Struct.field(UInt32)
+        declare count: UInt32
+    }
     @Struct.type('init')
     export class init extends Struct {
         @Struct.field(Checksum160)
@@ -56,7 +62,12 @@ export namespace Types {
         declare is_locked: boolean
     }
     @Struct.type('refstuckreq')
-    export class refstuckreq extends Struct {}
+    export class refstuckreq extends Struct {
+        @Struct.field(UInt64)
+        declare start: UInt64
+        @Struct.field(UInt32)
+        declare count: UInt32
+    }
     @Struct.type('reqnotify')
     export class reqnotify extends Struct {
         @Struct.field(UInt64)
@@ -107,7 +118,10 @@ export type RowType<T> = T extends keyof TableTypes ? TableTypes[T] : any
 export type TableNames = keyof TableTypes
 export namespace ActionParams {
     export namespace Type {}
-    export interface clrfailedreq {}
+    export interface clrfailedreq {
+        start: UInt64Type
+        count: UInt32Type
+    }
     export interface init {
         evm_bridge_address: Checksum160Type
         evm_token_address: Checksum160Type
@@ -117,7 +131,10 @@ export namespace ActionParams {
         fees_contract: NameType
         is_locked: boolean
     }
-    export interface refstuckreq {}
+    export interface refstuckreq {
+        start: UInt64Type
+        count: UInt32Type
+    }
     export interface reqnotify {
         req_id: UInt64Type
     }
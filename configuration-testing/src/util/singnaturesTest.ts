@@ -3,8 +3,10 @@ import { ethers } from "ethers";
 const signatures = {
     "EVM_SUCCESS_CALLBACK_SIGNATURE": "requestSuccessful(uint256)",
     "EVM_BRIDGE_SIGNATURE": "bridgeTo(address,address,uint256,bytes32)",
-    "EVM_REF_STUCK_REQ_SIGNATURE": "refundStuckReq()",
-    "EVM_CLEAR_FAILED_REQUESTS_SIGNATURE": "clearFailedRequests()",
+    "EVM_BRIDGE_V2_SIGNATURE": "bridgeToV2(address,address,uint64,uint64)",
+    "EVM_BRIDGE_BATCH_SIGNATURE": "bridgeToBatch(address[],uint256[],bytes32[])",
+    "EVM_REF_STUCK_REQ_SIGNATURE": "refundStuckReq(uint256,uint256)",
+    "EVM_CLEAR_FAILED_REQUESTS_SIGNATURE": "clearFailedRequests(uint256,uint256)",
     "EVM_REMOVE_REQUEST_SIGNATURE": "removeRequest(uint256)",
 };
 
@@ -32,6 +32,24 @@ contract TokenBridge is Ownable, ReentrancyGuard {
         }
         return string(bytesArray);
     }
+    // Antelope name (uint64) to its string form, same as eosio::name::to_string without the trailing dots
+    function nameToString(uint64 value) public pure returns (string memory) {
+        bytes memory charmap = ".12345abcdefghijklmnopqrstuvwxyz";
+        bytes memory out = new bytes(13);
+        uint64 tmp = value;
+        for (uint256 i = 0; i < 13; i++) {
+            out[12 - i] = charmap[i == 0 ? tmp & 0x0f : tmp & 0x1f];
+            tmp >>= (i == 0 ? 4 : 5);
+        }
+        uint256 length = 13;
+        while (length > 0 && out[length - 1] == ".") {
+            length--;
+        }
+        assembly {
+            mstore(out, length)
+        }
+        return string(out);
+    }
 
     // ------------------------------------------------------------------
     //  Events
@@ -97,6 +115,13 @@ contract TokenBridge is Ownable, ReentrancyGuard {
         address indexed sender,
         uint256 timestamp
     );
+    event RecoveryPage(
+        string job,
+        uint start,
+        uint next,
+        uint removed,
+        uint remaining
+    );
 
     // ------------------------------------------------------------------
     //  State
@@ -111,17 +136,22 @@ contract TokenBridge is Ownable, ReentrancyGuard {
     bytes32 public antelope_token_name;
     bytes32 public antelope_symbol;  
     uint8 public constant evm_decimals = 18;  // OFT tokens always use 18 decimals
-
+    uint public constant antelope_amount_factor = 10**14;  // 18 - 4 = 14, EVM units per Antelope unit
+
+    // v2 layout, 4 storage slots per request. evm.boid reads them through eosio.evm
+    // (REQUEST_LAYOUT_V2 in antelope-compile/include_common/bridge_storage.hpp), keep the order:
+    //  slot 0: sender | id | requested_at
+    //  slot 1: amount (Antelope units) | status
+    //  slot 2: receiver
+    //  slot 3: memo
+    // The Antelope token contract and symbol are the contract-level fields above.
     struct Request {
-        uint id;
         address sender;
-        uint amount;
-        uint requested_at;
-        bytes32 antelope_token_contract;
-        bytes32 antelope_symbol;
-        bytes32 receiver;
-        uint8 evm_decimals;
+        uint64 id;
+        uint32 requested_at;
+        uint64 amount;
         RequestStatus status;
+        bytes32 receiver;
         bytes32 memo;
     }
     // Mapping from request id to Request
@@ -137,6 +167,11 @@ contract TokenBridge is Ownable, ReentrancyGuard {
     mapping(address => uint) public request_counts;
     uint public min_amount;
 
+    // Paged recovery: passing RECOVERY_CURSOR as `start` continues where the previous page stopped
+    uint64 public constant RECOVERY_CURSOR = type(uint64).max;
+    uint public refund_cursor;
+    uint public clear_cursor;
+
     constructor(
         address initialOwner,
         address _antelope_bridge_evm_address,
@@ -202,6 +237,11 @@ contract TokenBridge is Ownable, ReentrancyGuard {
     // ----------------------------------------------------------
     //  Internal Helper Functions
     // ----------------------------------------------------------
+    /// @notice Amount of a request in EVM token units.
+    function _evmAmount(Request storage req) internal view returns (uint) {
+        return uint(req.amount) * antelope_amount_factor;
+    }
+
     /// @notice Removes a request by its id from storage.
     /// @dev Returns the sender so that request_counts can be adjusted.
     function _removeRequest(uint id) internal returns (address sender) {
@@ -229,9 +269,9 @@ contract TokenBridge is Ownable, ReentrancyGuard {
         emit RequestStatusCallback(
             id,
             req.sender,
-            bytes32ToString(req.antelope_token_contract),
-            bytes32ToString(req.antelope_symbol),
-            req.amount,
+            bytes32ToString(antelope_token_contract),
+            bytes32ToString(antelope_symbol),
+            _evmAmount(req),
             bytes32ToString(req.receiver),
             RequestStatus.Completed,
             block.timestamp,
@@ -256,22 +296,30 @@ contract TokenBridge is Ownable, ReentrancyGuard {
 
     /// @notice Allows manual cleanup of requests marked as Failed.
     /// Both the owner and the Antelope bridge can trigger this.
-    function clearFailedRequests() external nonReentrant {
+    /// Looks at `count` entries of activeRequestIds from `start` (or from clear_cursor with RECOVERY_CURSOR),
+    /// so the gas of a call does not depend on the number of active requests.
+    function clearFailedRequests(uint start, uint count) external nonReentrant returns (uint next) {
         require(msg.sender == antelope_bridge_evm_address || msg.sender == owner(), "Caller is not owner or Antelope bridge");
-        uint i = 0;
-        while (i < activeRequestIds.length) {
+        uint i = start == RECOVERY_CURSOR ? clear_cursor : start;
+        uint first = i;
+        uint removed = 0;
+        for (uint seen = 0; seen < count && i < activeRequestIds.length; seen++) {
             uint id = activeRequestIds[i];
             Request storage req = requests[id];
             if (req.status == RequestStatus.Failed) {
                 emit FailedRequestCleared(req.id, req.sender, block.timestamp);
                 address reqSender = _removeRequest(id);
                 request_counts[reqSender]--;
-                emit RequestRemovalSuccess(req.id, reqSender, block.timestamp, "Request successfully removed after failed request");
+                removed++;
+                emit RequestRemovalSuccess(id, reqSender, block.timestamp, "Request successfully removed after failed request");
                 // Do not increment i because the last element was swapped in.
             } else {
                 i++;
             }
         }
+        next = i < activeRequestIds.length ? i : 0;
+        clear_cursor = next;
+        emit RecoveryPage("clear", first, next, removed, activeRequestIds.length);
     }
 
     /// @notice Called by the Antelope bridge to mint tokens on the EVM side after a cross-chain transfer.
@@ -282,23 +330,56 @@ contract TokenBridge is Ownable, ReentrancyGuard {
         uint amount, 
         bytes32 sender
     ) external onlyAntelopeBridge nonReentrant{
+        _bridgeTo(token, receiver, amount, bytes32ToString(sender));
+    }
+
+    /// @notice Protocol v2 of bridgeTo: the amount in Antelope units and the sender as its uint64 name,
+    /// all arguments fixed width (132 bytes of calldata, no dynamic decoding).
+    function bridgeToV2(
+        address token,
+        address receiver,
+        uint64 amount,
+        uint64 sender
+    ) external onlyAntelopeBridge nonReentrant{
+        _bridgeTo(token, receiver, uint(amount) * antelope_amount_factor, nameToString(sender));
+    }
+
+    function _bridgeTo(address token, address receiver, uint amount, string memory sender) internal {
         if (evm_approvedToken == address(0)) {
             emit ValidationStatus(
-                "Approved token is not set", token, receiver, amount, bytes32ToString(sender),
+                "Approved token is not set", token, receiver, amount, sender,
                 bytes32ToString(antelope_token_contract), bytes32ToString(antelope_symbol), block.timestamp);
             revert("Approved token is not set");
         }
         if (evm_approvedToken != token) {
             emit ValidationStatus(
-                "Token is not the approved token", token, receiver, amount, bytes32ToString(sender),
+                "Token is not the approved token", token, receiver, amount, sender,
                 bytes32ToString(antelope_token_contract), bytes32ToString(antelope_symbol), block.timestamp);
             revert("Token is not the approved token");
         }
 
         emit ValidationStatus(
-            "Validation successful", token, receiver, amount, bytes32ToString(sender),
+            "Validation successful", token, receiver, amount, sender,
             bytes32ToString(antelope_token_contract), bytes32ToString(antelope_symbol), block.timestamp);
 
+        _mintBridged(receiver, amount, sender);
+    }
+
+    /// @notice Queued mode of the Antelope bridge: the transfers queued on Antelope minted in one transaction.
+    /// Senders are Antelope names left aligned in bytes32. A failed mint only fails its own transfer.
+    function bridgeToBatch(
+        address[] calldata receivers,
+        uint[] calldata amounts,
+        bytes32[] calldata senders
+    ) external onlyAntelopeBridge nonReentrant{
+        require(receivers.length == amounts.length && receivers.length == senders.length, "Array lengths do not match");
+        require(evm_approvedToken != address(0), "Approved token is not set");
+        for (uint i = 0; i < receivers.length; i++) {
+            _mintBridged(receivers[i], amounts[i], bytes32ToString(senders[i]));
+        }
+    }
+
+    function _mintBridged(address receiver, uint amount, string memory sender) internal {
         try IERC20Bridgeable(evm_approvedToken).mint(receiver, amount) {
             emit BridgeTransaction(
                 request_id,
@@ -307,7 +388,7 @@ contract TokenBridge is Ownable, ReentrancyGuard {
                 amount, 
                 RequestStatus.Completed,
                 block.timestamp, 
-                bytes32ToString(sender),
+                sender,
                 bytes32ToString(antelope_token_contract),
                 bytes32ToString(antelope_symbol),
                 "Bridging confirmed"
@@ -320,7 +401,7 @@ contract TokenBridge is Ownable, ReentrancyGuard {
                 amount, 
                 RequestStatus.Failed, 
                 block.timestamp, 
-                bytes32ToString(sender),
+                sender,
                 bytes32ToString(antelope_token_contract),
                 bytes32ToString(antelope_symbol),
                 "Minting failed"
@@ -346,9 +427,8 @@ contract TokenBridge is Ownable, ReentrancyGuard {
         require(address(token) == evm_approvedToken, "Wrong token!");
 
         // Convert from 18 decimals (EVM) to 4 decimals (Antelope)
-        uint exponent = 10**14;  // 18 - 4 = 14
-        uint sanitized_amount = amount / exponent;
-        require(sanitized_amount * exponent == amount, "Amount must not have more decimal places than the Antelope token");
+        uint sanitized_amount = amount / antelope_amount_factor;
+        require(sanitized_amount * antelope_amount_factor == amount, "Amount must not have more decimal places than the Antelope token");
 
         // Enforce sanitized amount under C++ uint64_t max (for Antelope transfer)
         require(sanitized_amount <= 10**12, "Amount is too high to bridge");
@@ -368,15 +448,12 @@ contract TokenBridge is Ownable, ReentrancyGuard {
         try token.burnFrom(msg.sender, amount) {
             // Create and store the new request.
             Request memory newReq = Request({
-                id: request_id,
                 sender: msg.sender,
-                amount: amount,
-                requested_at: block.timestamp,
-                antelope_token_contract: antelope_token_contract,
-                antelope_symbol: antelope_symbol,
-                receiver: receiver_32,
-                evm_decimals: evm_decimals,
+                id: uint64(request_id),
+                requested_at: uint32(block.timestamp),
+                amount: uint64(sanitized_amount),
                 status: RequestStatus.Pending,
+                receiver: receiver_32,
                 memo: memo_32
             });
             requests[request_id] = newReq;
@@ -427,17 +504,18 @@ contract TokenBridge is Ownable, ReentrancyGuard {
         require(req.status == RequestStatus.Pending, "Request is not pending");
         require(block.timestamp >= req.requested_at + REQUEST_TIMEOUT, "Request not timed out yet");
 
-        try IERC20Bridgeable(evm_approvedToken).mint(req.sender, req.amount) {
+        uint evm_amount = _evmAmount(req);
+        try IERC20Bridgeable(evm_approvedToken).mint(req.sender, evm_amount) {
             emit BridgeTransaction(
                 id,
                 req.sender,
                 evm_approvedToken,
-                req.amount,
+                evm_amount,
                 RequestStatus.Refunded,
                 block.timestamp,
                 "",
-                bytes32ToString(req.antelope_token_contract),
-                bytes32ToString(req.antelope_symbol),
+                bytes32ToString(antelope_token_contract),
+                bytes32ToString(antelope_symbol),
                 "User initiated refund"
             );
             address reqSender = _removeRequest(id);
@@ -450,40 +528,48 @@ contract TokenBridge is Ownable, ReentrancyGuard {
 
     /// @notice Called by the Antelope bridge to auto-refund timed-out requests.
     /// If minting fails, the request is marked as Failed.
-    function refundStuckReq() external nonReentrant {
+    /// Looks at `count` entries of activeRequestIds from `start` (or from refund_cursor with RECOVERY_CURSOR),
+    /// so the gas of a call does not depend on the number of active requests.
+    function refundStuckReq(uint start, uint count) external nonReentrant returns (uint next) {
         require(msg.sender == antelope_bridge_evm_address || msg.sender == owner(), "Caller is not owner or Antelope bridge");
-        uint i = 0;
-        while (i < activeRequestIds.length) {
+        uint i = start == RECOVERY_CURSOR ? refund_cursor : start;
+        uint first = i;
+        uint removed = 0;
+        for (uint seen = 0; seen < count && i < activeRequestIds.length; seen++) {
             uint id = activeRequestIds[i];
             Request storage req = requests[id];
             if (req.status == RequestStatus.Pending && block.timestamp >= req.requested_at + REQUEST_TIMEOUT) {
-                try IERC20Bridgeable(evm_approvedToken).mint(req.sender, req.amount) {
+                uint evm_amount = _evmAmount(req);
+                try IERC20Bridgeable(evm_approvedToken).mint(req.sender, evm_amount) {
                     emit BridgeTransaction(
-                        req.id,
+                        id,
                         req.sender,
                         evm_approvedToken,
-                        req.amount,
+                        evm_amount,
                         RequestStatus.Refunded,
                         block.timestamp,
                         "",
-                        bytes32ToString(req.antelope_token_contract),
-                        bytes32ToString(req.antelope_symbol),
+                        bytes32ToString(antelope_token_contract),
+                        bytes32ToString(antelope_symbol),
                         "Refund triggered by the TokenBridge"
                     );
                     address reqSender = _removeRequest(id);
                     request_counts[reqSender]--;
-                    emit RequestRemovalSuccess(req.id, reqSender, block.timestamp, "Request successfully removed after auto-refund");
-                    // Do not increment i because we swapped in the last element.
+                    emit RequestRemovalSuccess(id, reqSender, block.timestamp, "Request successfully removed after auto-refund");
                 } catch {
                     req.status = RequestStatus.Failed;
                     address reqSender = _removeRequest(id);
                     request_counts[reqSender]--;
-                    emit RequestRemovalSuccess(req.id, reqSender, block.timestamp, "Request removed after failed auto-refund");
-                    // Do not increment i because we swapped in the last element.
+                    emit RequestRemovalSuccess(id, reqSender, block.timestamp, "Request removed after failed auto-refund");
                 }
+                removed++;
+                // Do not increment i because we swapped in the last element.
             } else {
                 i++;
             }
         }
+        next = i < activeRequestIds.length ? i : 0;
+        refund_cursor = next;
+        emit RecoveryPage("refund", first, next, removed, activeRequestIds.length);
     }
 }